@@ -0,0 +1,220 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "animationsampler.h"
+
+#include <QQuaternion>
+#include <QVector3D>
+#include <cmath>
+
+#include "irisgl/src/scenegraph/scene.h"
+#include "irisgl/src/scenegraph/scenenode.h"
+#include "irisgl/src/animation/animation.h"
+#include "irisgl/src/animation/propertyanim.h"
+#include "irisgl/src/core/logger.h"
+
+namespace
+{
+    // The only properties the sampler writes back itself
+    const char *positionProperty = "position";
+    const char *rotationProperty = "rotation";
+    const char *scaleProperty = "scale";
+
+    bool isTransformOnly(const iris::AnimationPtr &animation)
+    {
+        if (!!animation->skeletalAnimation) return false;
+
+        for (auto name : animation->properties.keys()) {
+            if (name != positionProperty && name != rotationProperty && name != scaleProperty) return false;
+
+            // what an empty channel evaluates to is up to the animation itself
+            for (auto animInfo : animation->properties[name]->getKeyFrames()) {
+                if (animInfo.keyFrame->keys.size() == 0) return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+const int AnimationSampler::sampleRate = 60;
+
+void AnimationSampler::compile(const iris::ScenePtr &scene)
+{
+    clear();
+    if (!scene) return;
+
+    for (auto node : scene->nodes) {
+        if (!node->hasActiveAnimation()) continue;
+
+        auto animation = node->getAnimation();
+        if (!isTransformOnly(animation)) {
+            fallbackNodes.append(node);
+            continue;
+        }
+
+        const int track = tracks.size();
+        trackLength.append(qMax(0.0f, float(animation->getLength())));
+        trackLooping.append(animation->getLooping());
+        trackTime.append(0.0f);
+
+        Track entry;
+        entry.node = node;
+        entry.position = bakeVector3(track, animation, positionProperty);
+        entry.rotation = bakeVector3(track, animation, rotationProperty);
+        entry.scale = bakeVector3(track, animation, scaleProperty);
+        tracks.append(entry);
+    }
+
+    channelValue.resize(channelTrack.size());
+    compiled = true;
+
+    if (!tracks.isEmpty()) {
+        irisLog(QString("Compiled %1 animation tracks: %2 channels, %3 KB of samples, max deviation %4")
+                .arg(tracks.size())
+                .arg(channelTrack.size())
+                .arg(QString::number(getMemoryUsage() / 1024.0, 'f', 1))
+                .arg(maxDeviation));
+    }
+}
+
+void AnimationSampler::clear()
+{
+    tracks.clear();
+    trackLength.clear();
+    trackLooping.clear();
+    trackTime.clear();
+
+    channelTrack.clear();
+    channelOffset.clear();
+    channelLastSegment.clear();
+    channelLastStep.clear();
+    channelValue.clear();
+
+    samples.clear();
+    fallbackNodes.clear();
+    maxDeviation = 0.0f;
+    compiled = false;
+}
+
+qint64 AnimationSampler::getMemoryUsage() const
+{
+    const qint64 perTrack = sizeof(Track) + sizeof(float) * 2 + sizeof(char);
+    const qint64 perChannel = sizeof(int) * 3 + sizeof(float) * 2;
+
+    return samples.size() * qint64(sizeof(float)) + tracks.size() * perTrack + channelTrack.size() * perChannel;
+}
+
+void AnimationSampler::update(float time)
+{
+    const int trackCount = trackTime.size();
+    const float *length = trackLength.constData();
+    const char *looping = trackLooping.constData();
+    float *localTime = trackTime.data();
+
+    for (int i = 0; i < trackCount; i++) {
+        float t = qMax(0.0f, time);
+        if (looping[i] && length[i] > 0.0f) t = std::fmod(t, length[i]);
+        localTime[i] = qMin(t, length[i]);
+    }
+
+    sampleChannels();
+    applyTracks();
+
+    for (auto node : fallbackNodes) node->updateAnimation(time);
+}
+
+int AnimationSampler::bakeVector3(int track, const iris::AnimationPtr &animation, const QString &name)
+{
+    if (!animation->hasPropertyAnim(name)) return -1;
+
+    auto propAnim = animation->getVector3PropertyAnim(name);
+
+    // Always at least two samples so every channel has a segment to interpolate over
+    const int segments = qMax(1, int(std::ceil(trackLength[track] * sampleRate)));
+    const int first = channelTrack.size();
+
+    QVector<QVector3D> values;
+    values.reserve(segments + 1);
+    for (int i = 0; i <= segments; i++) {
+        values.append(propAnim->getValue(qMin(float(i) / sampleRate, trackLength[track])));
+    }
+
+    // The last sample is taken at the track's length, usually less than a full step after the one before it
+    const float lastSampleTime = qMin(float(segments) / sampleRate, trackLength[track]);
+
+    // Compare each segment's midpoint against the curve, this is what the lerp gets wrong
+    for (int i = 0; i < segments; i++) {
+        const float start = float(i) / sampleRate;
+        const float end = qMin(float(i + 1) / sampleRate, lastSampleTime);
+        const auto error = propAnim->getValue((start + end) * 0.5f) - (values[i] + values[i + 1]) * 0.5f;
+
+        for (int axis = 0; axis < 3; axis++) maxDeviation = qMax(maxDeviation, qAbs(error[axis]));
+    }
+    const float lastStep = (lastSampleTime - float(segments - 1) / sampleRate) * sampleRate;
+
+    for (int axis = 0; axis < 3; axis++) {
+        channelTrack.append(track);
+        channelOffset.append(samples.size());
+        channelLastSegment.append(segments - 1);
+        channelLastStep.append(lastStep > 0.0f ? lastStep : 1.0f);
+
+        for (const auto &value : values) samples.append(value[axis]);
+    }
+
+    return first;
+}
+
+void AnimationSampler::sampleChannels()
+{
+    const int channelCount = channelTrack.size();
+    const int *track = channelTrack.constData();
+    const int *offset = channelOffset.constData();
+    const int *lastSegment = channelLastSegment.constData();
+    const float *lastStep = channelLastStep.constData();
+    const float *time = trackTime.constData();
+    const float *data = samples.constData();
+    float *value = channelValue.data();
+
+    // No searching and no branches on the curve shape, just an index and a lerp per channel
+    // Only the last segment of a channel can be shorter than a step
+    for (int c = 0; c < channelCount; c++) {
+        const float x = time[track[c]] * sampleRate;
+        const int segment = qMin(int(x), lastSegment[c]);
+        const float step = segment == lastSegment[c] ? lastStep[c] : 1.0f;
+        const float frac = qMin((x - segment) / step, 1.0f);
+
+        const float *s = data + offset[c] + segment;
+        value[c] = s[0] + (s[1] - s[0]) * frac;
+    }
+}
+
+void AnimationSampler::applyTracks()
+{
+    const float *value = channelValue.constData();
+
+    for (const auto &track : tracks) {
+        if (track.position != -1) {
+            const float *v = value + track.position;
+            track.node->setLocalPos(QVector3D(v[0], v[1], v[2]));
+        }
+
+        if (track.rotation != -1) {
+            const float *v = value + track.rotation;
+            track.node->setLocalRot(QQuaternion::fromEulerAngles(v[0], v[1], v[2]));
+        }
+
+        if (track.scale != -1) {
+            const float *v = value + track.scale;
+            track.node->setLocalScale(QVector3D(v[0], v[1], v[2]));
+        }
+    }
+}
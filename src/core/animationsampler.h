@@ -0,0 +1,86 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef ANIMATIONSAMPLER_H
+#define ANIMATIONSAMPLER_H
+
+#include <QList>
+#include <QVector>
+
+#include "irisgl/src/irisglfwd.h"
+
+/**
+ * Compiled animation tracks for a whole scene
+ * Transform animations (position, rotation and scale) of every animated node are baked into flat arrays of
+ * samples at a fixed rate when playback starts. Each frame is then one pass over all channels that only does
+ * an index computation and a lerp, followed by a pass that writes the transforms back to the nodes
+ * Nodes with skeletal animations or animated properties other than the transform keep being updated by
+ * their own animation every frame
+ *
+ * This is an approximation of the curves, not a copy of them: the samples are exact, but between two samples
+ * the value is a straight line rather than the curve's own interpolation, and a key falling between samples
+ * is rounded off. compile() measures the worst deviation at the middle of every segment along with the memory
+ * the samples take (length x sampleRate x 9 floats per fully animated node) and logs both
+ * Tracks must be compiled again after the animations are edited
+ */
+class AnimationSampler
+{
+public:
+    // Baked samples per second, playback interpolates linearly between them
+    static const int sampleRate;
+
+    void compile(const iris::ScenePtr &scene);
+    void clear();
+
+    bool isCompiled() const { return compiled; }
+    int getTrackCount() const { return tracks.size(); }
+    int getChannelCount() const { return channelTrack.size(); }
+    qint64 getMemoryUsage() const;
+    // Largest difference between a baked segment's midpoint and the curve at the same time
+    float getMaxDeviation() const { return maxDeviation; }
+
+    // Replaces Scene::updateSceneAnimation for a compiled scene
+    void update(float time);
+
+private:
+    struct Track
+    {
+        iris::SceneNodePtr node;
+        int position;   // first of three channels, -1 when the property isn't animated
+        int rotation;
+        int scale;
+    };
+
+    int bakeVector3(int track, const iris::AnimationPtr &animation, const QString &name);
+    void sampleChannels();
+    void applyTracks();
+
+    QList<Track> tracks;
+    QVector<float> trackLength;
+    QVector<char> trackLooping;
+    QVector<float> trackTime;
+
+    // one entry per channel
+    QVector<int> channelTrack;
+    QVector<int> channelOffset;
+    QVector<int> channelLastSegment;
+    QVector<float> channelLastStep;     // width of the last segment in samples, it ends at the track's length
+    QVector<float> channelValue;
+
+    // every channel's samples, back to back
+    QVector<float> samples;
+
+    QList<iris::SceneNodePtr> fallbackNodes;
+    float maxDeviation = 0.0f;
+    bool compiled = false;
+};
+
+#endif // ANIMATIONSAMPLER_H
@@ -46,25 +46,17 @@ void AssetHelper::updateNodeMaterial(iris::SceneNodePtr &node, QJsonObject defin
             nodeMaterial->generate(shaderFile.absoluteFilePath());
         }
         else {
-            for (auto asset : AssetManager::getAssets()) {
-                if (asset->type == ModelTypes::Shader) {
-                    if (asset->assetGuid == materialDefinition["guid"].toString()) {
-                        auto def = asset->getValue().toJsonObject();
-                        auto vertexShader = def["vertex_shader"].toString();
-                        auto fragmentShader = def["fragment_shader"].toString();
-                        for (auto asset : AssetManager::getAssets()) {
-                            if (asset->type == ModelTypes::File) {
-                                if (vertexShader == asset->assetGuid) vertexShader = asset->path;
-                                if (fragmentShader == asset->assetGuid) fragmentShader = asset->path;
-                            }
-                        }
-                        def["vertex_shader"] = vertexShader;
-                        def["fragment_shader"] = fragmentShader;
-
-						nodeMaterial->setMaterialDefinition(def);
-                        nodeMaterial->generate(def);
-                    }
-                }
+            if (auto asset = AssetManager::getAssetByGuid(materialDefinition["guid"].toString(), ModelTypes::Shader)) {
+                auto def = asset->getValue().toJsonObject();
+                auto vertexShader = def["vertex_shader"].toString();
+                auto fragmentShader = def["fragment_shader"].toString();
+                if (auto vertexAsset = AssetManager::getAssetByGuid(vertexShader, ModelTypes::File)) vertexShader = vertexAsset->path;
+                if (auto fragmentAsset = AssetManager::getAssetByGuid(fragmentShader, ModelTypes::File)) fragmentShader = fragmentAsset->path;
+                def["vertex_shader"] = vertexShader;
+                def["fragment_shader"] = fragmentShader;
+
+                nodeMaterial->setMaterialDefinition(def);
+                nodeMaterial->generate(def);
             }
         }
 
@@ -108,24 +100,7 @@ QByteArray AssetHelper::makeBlobFromPixmap(const QPixmap &thumbnail)
 
 QStringList AssetHelper::fetchAssetAndAllDependencies(const QString &guid, Database *db)
 {
-    QStringList topLevelAssets;
-    QStringList assetAndDependencies;
-
-    for (const auto &asset : db->fetchAssetGUIDAndDependencies(guid)) {
-        topLevelAssets.append(asset);
-        assetAndDependencies.append(asset);
-    }
-
-    // Dependency level is always max 2
-    for (const auto &asset : topLevelAssets) {
-        for (const auto &guid : db->fetchAssetGUIDAndDependencies(asset)) {
-            assetAndDependencies.append(guid);
-        }
-    }
-
-    assetAndDependencies.removeDuplicates();
-
-    return assetAndDependencies;
+    return db->fetchAssetAndAllDependencies(guid);
 }
 
 // Allows us to get all the child guids from the node being exported as dependencies
@@ -174,13 +149,9 @@ ModelTypes AssetHelper::getAssetTypeFromExtension(const QString &fileSuffix)
     return ModelTypes::Undefined;
 }
 
-iris::SceneNodePtr AssetHelper::extractTexturesAndMaterialFromMesh(
-    const QString &filePath,
-    QStringList &textureList)
+namespace
 {
-    auto ssource = new iris::SceneSource();
-    // load mesh as scene
-    auto node = iris::MeshNode::loadAsSceneFragment(filePath, [&](iris::MeshPtr mesh, iris::MeshMaterialData& data)
+    iris::CustomMaterialPtr createImportedMaterial(const iris::MeshMaterialData &data)
     {
         auto mat = iris::CustomMaterial::create();
 
@@ -203,41 +174,58 @@ iris::SceneNodePtr AssetHelper::extractTexturesAndMaterialFromMesh(
             mat->setValue("normalTexture", data.normalTexture);
 
         return mat;
-    }, ssource);
+    }
 
-    const aiScene *scene = ssource->importer.GetScene();
+    QStringList getReferencedTextures(const aiScene *scene)
+    {
+        QStringList texturesToCopy;
 
-    QStringList texturesToCopy;
+        for (int i = 0; i < scene->mNumMeshes; i++) {
+            auto mesh = scene->mMeshes[i];
+            auto material = scene->mMaterials[mesh->mMaterialIndex];
 
-    for (int i = 0; i < scene->mNumMeshes; i++) {
-        auto mesh = scene->mMeshes[i];
-        auto material = scene->mMaterials[mesh->mMaterialIndex];
+            aiString textureName;
 
-        aiString textureName;
+            if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
+                material->GetTexture(aiTextureType_DIFFUSE, 0, &textureName);
+                texturesToCopy.append(textureName.C_Str());
+            }
 
-        if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
-            material->GetTexture(aiTextureType_DIFFUSE, 0, &textureName);
-            texturesToCopy.append(textureName.C_Str());
-        }
+            if (material->GetTextureCount(aiTextureType_SPECULAR) > 0) {
+                material->GetTexture(aiTextureType_SPECULAR, 0, &textureName);
+                texturesToCopy.append(textureName.C_Str());
+            }
 
-        if (material->GetTextureCount(aiTextureType_SPECULAR) > 0) {
-            material->GetTexture(aiTextureType_SPECULAR, 0, &textureName);
-            texturesToCopy.append(textureName.C_Str());
-        }
+            if (material->GetTextureCount(aiTextureType_NORMALS) > 0) {
+                material->GetTexture(aiTextureType_NORMALS, 0, &textureName);
+                texturesToCopy.append(textureName.C_Str());
+            }
 
-        if (material->GetTextureCount(aiTextureType_NORMALS) > 0) {
-            material->GetTexture(aiTextureType_NORMALS, 0, &textureName);
-            texturesToCopy.append(textureName.C_Str());
+            if (material->GetTextureCount(aiTextureType_HEIGHT) > 0) {
+                material->GetTexture(aiTextureType_HEIGHT, 0, &textureName);
+                texturesToCopy.append(textureName.C_Str());
+            }
         }
 
-        if (material->GetTextureCount(aiTextureType_HEIGHT) > 0) {
-            material->GetTexture(aiTextureType_HEIGHT, 0, &textureName);
-            texturesToCopy.append(textureName.C_Str());
-        }
+        return texturesToCopy;
     }
+}
+
+iris::SceneNodePtr AssetHelper::extractTexturesAndMaterialFromMesh(
+    const QString &filePath,
+    const QSharedPointer<iris::SceneSource> &sceneSource,
+    QStringList &textureList)
+{
+    const aiScene *scene = sceneSource->importer.GetScene();
+    if (!scene) return iris::SceneNodePtr();
+
+    // the scene was parsed on a worker, only the meshes and materials are created here
+    auto node = iris::MeshNode::loadAsSceneFragment(filePath, scene, [&](iris::MeshPtr mesh, iris::MeshMaterialData& data)
+    {
+        return createImportedMaterial(data);
+    });
 
-    textureList = texturesToCopy;
-    // SceneWriter::writeSceneNode(QJsonObject(), node, false);
+    textureList = getReferencedTextures(scene);
 
     return node;
 }
@@ -14,8 +14,10 @@ For more information see the LICENSE file
 
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSharedPointer>
 
 #include "irisglfwd.h"
+#include "irisgl/src/scenegraph/meshnode.h"
 #include "constants.h"
 #include "core/project.h"
 #include "core/database/database.h"
@@ -28,7 +30,10 @@ public:
     static QStringList fetchAssetAndAllDependencies(const QString &guid, Database *db);
     static QStringList getChildGuids(const iris::SceneNodePtr &node);
     static ModelTypes getAssetTypeFromExtension(const QString &fileSuffix);
+    // Creates the meshes and materials of a scene that was already parsed (and cached) on a worker
+    // textureList receives the textures it references, needs a current GL context
     static iris::SceneNodePtr extractTexturesAndMaterialFromMesh(const QString &filePath,
+                                                                 const QSharedPointer<iris::SceneSource> &sceneSource,
                                                                  QStringList &textureList);
 };
 
@@ -10,6 +10,8 @@ For more information see the LICENSE file
 *************************************************************************/
 
 #include "database.h"
+#include "foldersubtree.h"
+#include "schemaindexes.h"
 #include "constants.h"
 #include <irisgl/IrisGL.h>
 #include "globals.h"
@@ -17,15 +19,50 @@ For more information see the LICENSE file
 #include "io/assetmanager.h"
 #include "core/assethelper.h"
 #include "io/scenewriter.h"
+#include "io/sceneformat.h"
+#include "core/shadercache.h"
 
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QSqlRecord>
 #include <QDateTime>
+#include <QThread>
 #include <QMessageBox>
+#include <QRegularExpression>
 
-Database::Database()
+namespace
+{
+    // Searchable names of ModelTypes, in enum order
+    const QStringList searchTypeNames = {
+        "Undefined", "Material", "Texture", "Video", "Sky", "Object", "Mesh",
+        "Sound Effect", "Music", "Shader", "Variant", "File", "Particle System"
+    };
+
+    const QStringList searchColumns = { "name", "tags", "author", "license", "type" };
+
+    QString searchTypeExpression(const QString &row)
+    {
+        QString expression = QString("CASE %1.type").arg(row);
+        for (int i = 0; i < searchTypeNames.size(); ++i) {
+            expression += QString(" WHEN %1 THEN '%2'").arg(i).arg(searchTypeNames[i]);
+        }
+
+        return expression + " END";
+    }
+
+    QString searchTagsText(const QByteArray &tags)
+    {
+        QStringList words;
+        for (const auto &tag : QJsonDocument::fromBinaryData(tags).object()["tags"].toArray()) {
+            words.append(tag.toString());
+        }
+
+        return words.join(' ');
+    }
+}
+
+Database::Database() : searchIndexAvailable(false)
 {
     projectsTableSchema =
         "CREATE TABLE IF NOT EXISTS projects ("
@@ -80,6 +117,19 @@ Database::Database()
 		"    view_filter       INTEGER"
         ")";
 
+    // The large per asset payloads live outside of the assets table so that listing and filtering
+    // assets never has to page in thumbnails or serialized assets, the thumbnail and asset columns
+    // in assets are only populated in exported bundles (.jaf) and are kept NULL in the library
+    assetPayloadsTableSchema =
+        "CREATE TABLE IF NOT EXISTS asset_payloads ("
+        "    guid              VARCHAR(32) PRIMARY KEY,"
+        "    thumbnail         BLOB,"
+        "    asset             BLOB"
+        ")";
+
+    assetPayloadInsertQuery =
+        "INSERT OR REPLACE INTO asset_payloads (guid, thumbnail, asset) VALUES (:guid, :thumbnail, :asset)";
+
     dependenciesTableSchema =
         "CREATE TABLE IF NOT EXISTS dependencies ("
         "	 depender_type  INTEGER,"
@@ -131,9 +181,43 @@ Database::Database()
         "    thumbnail		   BLOB"
         ")";
 
+    // Full text index used by the asset search boxes, rows share their rowid with assets
+    // The triggers keep it in step with any write to assets, tags are binary json that SQL
+    // can't read so those are written separately through updateSearchTags()
+    assetsSearchTableSchema =
+        "CREATE VIRTUAL TABLE IF NOT EXISTS assets_search USING fts5("
+        "    name, tags, author, license, type,"
+        "    prefix = '2 3'"
+        ")";
+
+    assetsSearchTriggers = QStringList {
+        "CREATE TRIGGER IF NOT EXISTS assets_search_insert AFTER INSERT ON assets BEGIN"
+        "    INSERT INTO assets_search (rowid, name, author, license, type)"
+        "    VALUES (new.rowid, new.name, new.author, new.license, " + searchTypeExpression("new") + ");"
+        " END",
+        "CREATE TRIGGER IF NOT EXISTS assets_search_update AFTER UPDATE OF name, author, license, type ON assets BEGIN"
+        "    UPDATE assets_search SET name = new.name, author = new.author, license = new.license,"
+        "    type = " + searchTypeExpression("new") + " WHERE rowid = old.rowid;"
+        " END",
+        "CREATE TRIGGER IF NOT EXISTS assets_search_delete AFTER DELETE ON assets BEGIN"
+        "    DELETE FROM assets_search WHERE rowid = old.rowid;"
+        " END"
+    };
+
+    assetsSearchPopulateQuery =
+        "INSERT INTO assets_search (rowid, name, author, license, type) "
+        "SELECT rowid, name, author, license, " + searchTypeExpression("assets") + " FROM assets";
+
 	// Schema updates
 	version080SchemaUpdate = "ALTER TABLE assets ADD COLUMN view_filter INTEGER;";
 	version080SchemaDowngrade = "ALTER TABLE assets DROP COLUMN view_filter;";
+
+	// Move the payloads of existing assets into asset_payloads, running this again is harmless
+	version081PayloadsUpdate = QStringList {
+		"INSERT OR IGNORE INTO asset_payloads (guid, thumbnail, asset) "
+		"SELECT guid, thumbnail, asset FROM assets WHERE thumbnail IS NOT NULL OR asset IS NOT NULL",
+		"UPDATE assets SET thumbnail = NULL, asset = NULL WHERE thumbnail IS NOT NULL OR asset IS NOT NULL"
+	};
 }
 
 Database::~Database()
@@ -150,6 +234,29 @@ bool Database::executeAndCheckQuery(QSqlQuery &query, const QString& name)
     return true;
 }
 
+bool Database::beginTransaction(const QString &name)
+{
+    if (db.transaction()) return true;
+
+    irisLog(QString("%1 couldn't start a transaction, writing each statement on its own! %2")
+            .arg(name, db.lastError().text()));
+    return false;
+}
+
+bool Database::endTransaction(bool inTransaction, bool succeeded, const QString &name)
+{
+    if (!inTransaction) {
+        if (!succeeded) irisLog(QString("%1 failed, statements already written can't be rolled back!").arg(name));
+        return succeeded;
+    }
+
+    if (succeeded && db.commit()) return true;
+
+    irisLog(QString("%1 failed, rolling back! %2").arg(name, db.lastError().text()));
+    db.rollback();
+    return false;
+}
+
 // Note that this is the default connection, any queries called without
 // an explicit connection will use this database
 bool Database::initializeDatabase(const QString &pathToBlob)
@@ -173,16 +280,40 @@ bool Database::initializeDatabase(const QString &pathToBlob)
     return false;
 }
 
+// Every query of this instance goes through its own connection, workers can open one each and
+// leave the default connection to the GUI thread
+bool Database::openReadOnlyConnection(const QString &pathToBlob, const QString &connectionName)
+{
+    if (!QSqlDatabase::isDriverAvailable(Constants::DB_DRIVER)) {
+        irisLog("DB driver not present!");
+        return false;
+    }
+
+    db = QSqlDatabase::addDatabase(Constants::DB_DRIVER, connectionName);
+    db.setDatabaseName(pathToBlob);
+    // The GUI thread keeps writing through the default connection, wait for its locks instead of failing
+    db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+
+    if (!db.open()) irisLog(QString("Couldn't open a database connection! %1").arg(db.lastError().text()));
+    return db.isOpen();
+}
+
+QString Database::getDatabasePath() const
+{
+    return db.databaseName();
+}
+
 void Database::closeDatabase()
 {
+    const QString connectionName = db.connectionName();
     if (db.isOpen()) db.close();
     db = QSqlDatabase(); // important that we make an invalid object
-    QSqlDatabase::removeDatabase(db.connectionName());
+    QSqlDatabase::removeDatabase(connectionName);
 }
 
 int Database::getTableCount()
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table'");
 	if (query.exec()) {
 		if (query.first()) return query.value(0).toInt();
@@ -196,7 +327,7 @@ int Database::getTableCount()
 
 bool Database::checkIfTableExists(const QString &tableName)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = ?");
     query.addBindValue(tableName);
 
@@ -212,6 +343,57 @@ bool Database::checkIfTableExists(const QString &tableName)
     return false;
 }
 
+bool Database::checkIfIndexExists(const QString &indexName)
+{
+    QSqlQuery query(db);
+    query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name = ?");
+    query.addBindValue(indexName);
+
+    if (query.exec()) {
+        if (query.first()) return query.value(0).toBool();
+    }
+    else {
+        irisLog(
+            QString("There was an error checking if index %1 exists %2").arg(indexName, query.lastError().text())
+        );
+    }
+
+    return false;
+}
+
+bool Database::checkIfColumnExists(const QString &tableName, const QString &columnName)
+{
+    // PRAGMA can't bind the table name, callers only pass the names of our own tables
+    QSqlQuery query(db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(tableName))) {
+        irisLog(
+            QString("There was an error checking if column %1.%2 exists %3")
+                .arg(tableName, columnName, query.lastError().text())
+        );
+        return false;
+    }
+
+    // one row per column, the name is the second field
+    while (query.next()) {
+        if (query.value(1).toString() == columnName) return true;
+    }
+
+    return false;
+}
+
+bool Database::schemaNeedsUpdating()
+{
+    // The schema is current once the payloads table and every secondary index exist
+    // The search index isn't checked, SQLite builds without FTS5 never get one and would update on every start
+    if (!checkIfTableExists("asset_payloads")) return true;
+
+    for (const QString &indexSchema : SchemaIndexes::statements) {
+        if (!checkIfIndexExists(SchemaIndexes::nameOf(indexSchema))) return true;
+    }
+
+    return false;
+}
+
 QString Database::getVersion()
 {
     //QSqlQuery pquery;
@@ -247,7 +429,7 @@ QString Database::getVersion()
 
 void Database::updateGlobalDependencyDepender(const int &ertype, const QString & depender, const QString & dependee)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     auto guid = GUIDManager::generateGUID();
     query.prepare("UPDATE dependencies SET depender = ? WHERE depender_type = ? AND dependee = ?");
 
@@ -260,7 +442,7 @@ void Database::updateGlobalDependencyDepender(const int &ertype, const QString &
 
 void Database::updateGlobalDependencyDependee(const int & ertype, const QString & depender, const QString & dependee)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     auto guid = GUIDManager::generateGUID();
     query.prepare("UPDATE dependencies SET dependee = ? WHERE depender_type = ? AND depender = ?");
 
@@ -273,7 +455,7 @@ void Database::updateGlobalDependencyDependee(const int & ertype, const QString
 
 QString Database::getDependencyByType(const int &ertype, const QString &depender)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT dependee FROM dependencies WHERE depender_type = ? AND depender = ?");
 	query.addBindValue(ertype);
 	query.addBindValue(depender);
@@ -291,13 +473,13 @@ QString Database::getDependencyByType(const int &ertype, const QString &depender
 }
 
 bool Database::createProjectsTable() {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(projectsTableSchema);
     return executeAndCheckQuery(query, "CreateProjectsTable");
 }
 
 bool Database::createThumbnailsTable() {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(thumbnailsTableSchema);
     return executeAndCheckQuery(query, "CreateThumbnailsTable");
 }
@@ -305,11 +487,11 @@ bool Database::createThumbnailsTable() {
 bool Database::createCollectionsTable()
 {
     if (!checkIfTableExists("collections")) {
-        QSqlQuery query;
+        QSqlQuery query(db);
         query.prepare(collectionsTableSchema);
         
         if (executeAndCheckQuery(query, "CreateCollectionsTable")) {
-            QSqlQuery defaultCollQuery;
+            QSqlQuery defaultCollQuery(db);
             defaultCollQuery.prepare(
                 "INSERT INTO collections (name, date_created, collection_id) "
                 "VALUES (:name, datetime(), 0)"
@@ -329,28 +511,35 @@ bool Database::createCollectionsTable()
  *	3. polygon count
  */
 bool Database::createAssetsTable() {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(assetsTableSchema);
     return executeAndCheckQuery(query, "CreateAssetsTable");
 }
 
+bool Database::createAssetPayloadsTable()
+{
+    QSqlQuery query(db);
+    query.prepare(assetPayloadsTableSchema);
+    return executeAndCheckQuery(query, "CreateAssetPayloadsTable");
+}
+
 bool Database::createDependenciesTable()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(dependenciesTableSchema);
     return executeAndCheckQuery(query, "CreateDependenciesTable");
 }
 
 bool Database::createAuthorTable()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(authorTableSchema);
     return executeAndCheckQuery(query, "CreateAuthorTable");
 }
 
 bool Database::createFoldersTable()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(foldersTableSchema);
     return executeAndCheckQuery(query, "CreateFoldersTable");
 }
@@ -358,10 +547,10 @@ bool Database::createFoldersTable()
 bool Database::createMetadataTable()
 {
 	if (!checkIfTableExists("metadata")) {
-		QSqlQuery query;
+		QSqlQuery query(db);
 		query.prepare(metadataTableSchema);
 		if (executeAndCheckQuery(query, "CreateMetadataTable")) {
-			QSqlQuery defaultCollQuery;
+			QSqlQuery defaultCollQuery(db);
 			defaultCollQuery.prepare("INSERT INTO metadata (version) VALUES (?)");
 			defaultCollQuery.addBindValue(Constants::CONTENT_VERSION);
 			return executeAndCheckQuery(defaultCollQuery, "InsertDefaultMetadata");
@@ -373,11 +562,23 @@ bool Database::createMetadataTable()
 
 bool Database::createFavoritesTable()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(favoritesTableSchema);
     return executeAndCheckQuery(query, "CreateFavoritesTable");
 }
 
+bool Database::createIndexes()
+{
+    bool created = true;
+    for (const QString &indexSchema : SchemaIndexes::statements) {
+        QSqlQuery query(db);
+        query.prepare(indexSchema);
+        created &= executeAndCheckQuery(query, "CreateIndex");
+    }
+
+    return created;
+}
+
 void Database::createAllTables()
 {
     // TODO - transactions here
@@ -385,11 +586,75 @@ void Database::createAllTables()
     if (!checkIfTableExists("thumbnails"))      createThumbnailsTable();
     if (!checkIfTableExists("collections"))     createCollectionsTable();
     if (!checkIfTableExists("assets"))          createAssetsTable();
+    if (!checkIfTableExists("asset_payloads"))  createAssetPayloadsTable();
     if (!checkIfTableExists("dependencies"))    createDependenciesTable();
     if (!checkIfTableExists("author"))          createAuthorTable();
     if (!checkIfTableExists("folders"))         createFoldersTable();
     if (!checkIfTableExists("metadata"))        createMetadataTable();
     if (!checkIfTableExists("favorites"))       createFavoritesTable();
+
+    createIndexes();
+
+    if (!checkIfTableExists("assets_search"))   createSearchIndex();
+    searchIndexAvailable = checkIfTableExists("assets_search");
+}
+
+bool Database::createSearchIndex()
+{
+    QSqlQuery query(db);
+    query.prepare(assetsSearchTableSchema);
+    if (!executeAndCheckQuery(query, "CreateSearchIndex")) {
+        // SQLite was built without FTS5, searches fall back to matching names
+        return false;
+    }
+
+    bool created = true;
+    for (const QString &trigger : assetsSearchTriggers) {
+        QSqlQuery triggerQuery(db);
+        triggerQuery.prepare(trigger);
+        created &= executeAndCheckQuery(triggerQuery, "CreateSearchTrigger");
+    }
+
+    return created && rebuildSearchIndex();
+}
+
+bool Database::rebuildSearchIndex()
+{
+    db.transaction();
+
+    QSqlQuery clearQuery(db);
+    clearQuery.prepare("DELETE FROM assets_search");
+    bool rebuilt = executeAndCheckQuery(clearQuery, "ClearSearchIndex");
+
+    QSqlQuery populateQuery(db);
+    populateQuery.prepare(assetsSearchPopulateQuery);
+    rebuilt &= executeAndCheckQuery(populateQuery, "PopulateSearchIndex");
+
+    QSqlQuery tagsQuery(db);
+    tagsQuery.prepare("SELECT rowid, tags FROM assets WHERE tags IS NOT NULL AND length(tags) > 0");
+    rebuilt &= executeAndCheckQuery(tagsQuery, "FetchSearchTags");
+
+    QSqlQuery updateQuery(db);
+    updateQuery.prepare("UPDATE assets_search SET tags = ? WHERE rowid = ?");
+    while (rebuilt && tagsQuery.next()) {
+        updateQuery.addBindValue(searchTagsText(tagsQuery.value(1).toByteArray()));
+        updateQuery.addBindValue(tagsQuery.value(0));
+        rebuilt &= executeAndCheckQuery(updateQuery, "UpdateSearchTags");
+    }
+
+    rebuilt ? db.commit() : db.rollback();
+    return rebuilt;
+}
+
+bool Database::updateSearchTags(const QString &guid, const QByteArray &tags)
+{
+    if (!searchIndexAvailable) return true;
+
+    QSqlQuery query(db);
+    query.prepare("UPDATE assets_search SET tags = ? WHERE rowid = (SELECT rowid FROM assets WHERE guid = ?)");
+    query.addBindValue(searchTagsText(tags));
+    query.addBindValue(guid);
+    return executeAndCheckQuery(query, "UpdateSearchTags");
 }
 
 bool Database::createProject(
@@ -399,7 +664,7 @@ bool Database::createProject(
     const QByteArray &thumbnail
 )
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(
         "INSERT INTO projects (name, scene, thumbnail, version, date_created, last_accessed, last_written, guid) "
         "VALUES (:name, :scene, :thumbnail, :version, datetime(), datetime(), datetime(), :guid)"
@@ -415,7 +680,7 @@ bool Database::createProject(
 
 bool Database::createFolder(const QString &folderName, const QString &parentFolder, const QString &guid, bool visible)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(
         "INSERT INTO folders (name, parent, version, date_created, last_updated, project_guid, guid, visible) "
         "VALUES (:name, :parent, :version, datetime(), datetime(), :project_guid, :guid, :visible)"
@@ -442,17 +707,16 @@ QString Database::createAssetEntry(
 	const QByteArray &asset,
 	const AssetViewFilter view_filter)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(
 		"INSERT INTO assets"
-		" (name, thumbnail, parent, type, project_guid, collection, version, date_created,"
-		" last_updated, guid, properties, author, asset, license, tags, view_filter)"
-		" VALUES (:name, :thumbnail, :parent, :type, :project_guid, 0, :version, datetime(),"
-		" datetime(), :guid, :properties, :author, :asset, :license, :tags, :view_filter)"
+		" (name, parent, type, project_guid, collection, version, date_created,"
+		" last_updated, guid, properties, author, license, tags, view_filter)"
+		" VALUES (:name, :parent, :type, :project_guid, 0, :version, datetime(),"
+		" datetime(), :guid, :properties, :author, :license, :tags, :view_filter)"
 	);
 
 	query.bindValue(":name", assetName);
-	query.bindValue(":thumbnail", thumbnail);
 	query.bindValue(":parent", parentFolder);
 	query.bindValue(":type", type);
 	query.bindValue(":project_guid", Globals::project->getProjectGuid());
@@ -460,12 +724,12 @@ QString Database::createAssetEntry(
 	query.bindValue(":guid", guid);
 	query.bindValue(":properties", properties);
 	query.bindValue(":author", author.isEmpty() ? getAuthorName() : author);
-	query.bindValue(":asset", asset);
 	query.bindValue(":license", license);
 	query.bindValue(":tags", tags);
 	query.bindValue(":view_filter", view_filter);
 
-	if (executeAndCheckQuery(query, "CreateAssetEntry")) {
+	if (executeAndCheckQuery(query, "CreateAssetEntry") && createAssetPayload(guid, thumbnail, asset)) {
+		if (!tags.isEmpty()) updateSearchTags(guid, tags);
 		return guid;
 	}
 
@@ -481,17 +745,16 @@ QString Database::createAssetEntry(
 	const QByteArray &properties,
 	const AssetViewFilter view_filter)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(
 		"INSERT INTO assets"
-		" (name, thumbnail, parent, type, project_guid, collection, version, date_created,"
-		" last_updated, guid, properties, author, asset, license, tags, view_filter)"
-		" VALUES (:name, :thumbnail, :parent, :type, :project_guid, 0, :version, datetime(),"
-		" datetime(), :guid, :properties, :author, :asset, :license, :tags, :view_filter)"
+		" (name, parent, type, project_guid, collection, version, date_created,"
+		" last_updated, guid, properties, author, license, tags, view_filter)"
+		" VALUES (:name, :parent, :type, :project_guid, 0, :version, datetime(),"
+		" datetime(), :guid, :properties, :author, :license, :tags, :view_filter)"
 	);
 
 	query.bindValue(":name", assetName);
-	query.bindValue(":thumbnail", QByteArray());
 	query.bindValue(":parent", QString());
 	query.bindValue(":type", type);
 	query.bindValue(":project_guid", projectGuid);
@@ -499,21 +762,30 @@ QString Database::createAssetEntry(
 	query.bindValue(":guid", guid);
 	query.bindValue(":properties", properties);
 	query.bindValue(":author", QString());
-	query.bindValue(":asset", asset);
 	query.bindValue(":license", QString());
 	query.bindValue(":tags", QByteArray());
 	query.bindValue(":view_filter", view_filter);
 
-	if (executeAndCheckQuery(query, "CreateAssetEntry")) {
+	if (executeAndCheckQuery(query, "CreateAssetEntry") && createAssetPayload(guid, QByteArray(), asset)) {
 		return guid;
 	}
 
 	return QString();
 }
 
+bool Database::createAssetPayload(const QString &guid, const QByteArray &thumbnail, const QByteArray &asset)
+{
+	QSqlQuery query(db);
+	query.prepare(assetPayloadInsertQuery);
+	query.bindValue(":guid", guid);
+	query.bindValue(":thumbnail", thumbnail);
+	query.bindValue(":asset", asset);
+	return executeAndCheckQuery(query, "CreateAssetPayload");
+}
+
 bool Database::updateAssetViewFilter(const QString& guid, const int& filter)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("UPDATE assets SET view_filter = ? WHERE guid = ?");
 	query.addBindValue(filter);
 	query.addBindValue(guid);
@@ -522,15 +794,34 @@ bool Database::updateAssetViewFilter(const QString& guid, const int& filter)
 
 void Database::updateSchema()
 {
-	// apply schema updates in order, those already applied will do nothing
-	QSqlQuery query;
-	query.prepare(version080SchemaUpdate);
-	executeAndCheckQuery(query, "080SchemaUpdate");
+	// apply schema updates in order, each one checks whether it was already applied
+	// ALTER TABLE ADD COLUMN fails on a column that exists so it only runs when the column is missing
+	if (!checkIfColumnExists("assets", "view_filter")) {
+		QSqlQuery query(db);
+		query.prepare(version080SchemaUpdate);
+		executeAndCheckQuery(query, "080SchemaUpdate");
+	}
+
+	if (!checkIfTableExists("asset_payloads")) createAssetPayloadsTable();
+
+	db.transaction();
+	bool payloadsMoved = true;
+	for (const QString &statement : version081PayloadsUpdate) {
+		QSqlQuery payloadQuery(db);
+		payloadQuery.prepare(statement);
+		payloadsMoved &= executeAndCheckQuery(payloadQuery, "081PayloadsUpdate");
+	}
+	payloadsMoved ? db.commit() : db.rollback();
+
+	// indexes use IF NOT EXISTS so this is safe to run against any schema
+	createIndexes();
+
+	if (!checkIfTableExists("assets_search")) createSearchIndex();
 }
 
 bool Database::updateMetadataVersion(const QString& version)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(
 		"UPDATE metadata SET version = ?"
 	);
@@ -546,7 +837,7 @@ bool Database::createDependency(
     const QString &dependee,
     const QString &projectGuid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     auto guid = GUIDManager::generateGUID();
     query.prepare(
 		"INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
@@ -566,7 +857,7 @@ bool Database::addFavorite(const QString &guid)
 {
     const auto asset = fetchAsset(guid);
 
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(
         "INSERT INTO favorites (asset_guid, name, date_created, version, thumbnail) "
         "VALUES (:asset_guid, :name, datetime(), :version, :thumbnail)"
@@ -581,7 +872,7 @@ bool Database::addFavorite(const QString &guid)
 
 bool Database::removeFavorite(const QString &guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM favorites WHERE asset_guid = ?");
     query.addBindValue(guid);
 
@@ -593,7 +884,7 @@ QVector<FolderRecord> Database::fetchCrumbTrail(const QString &guid)
 	std::function<void(QVector<FolderRecord>&, const QString&)> fetchFolders
 		= [&](QVector<FolderRecord> &folders, const QString &guid) -> void
 	{
-		QSqlQuery query;
+		QSqlQuery query(db);
 		query.prepare("SELECT guid, parent, name FROM folders WHERE guid = ? AND project_guid = ?");
 		query.addBindValue(guid);
 		query.addBindValue(Globals::project->getProjectGuid());
@@ -631,7 +922,7 @@ QVector<FolderRecord> Database::fetchCrumbTrail(const QString &guid)
 
 QVector<FolderRecord> Database::fetchChildFolders(const QString &parent)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT guid, parent, name, count, visible FROM folders WHERE parent = ? AND project_guid = ?");
 	query.addBindValue(parent);
 	query.addBindValue(Globals::project->getProjectGuid());
@@ -662,8 +953,11 @@ QVector<AssetRecord> Database::fetchAssetThumbnails(const QStringList &guids)
 	for (const QString &guid : guids) guidInString += "'" + guid + "',";
 	guidInString.chop(1);
 
-	QSqlQuery query;
-	query.prepare("SELECT guid, thumbnail, name FROM assets WHERE guid IN (" + guidInString + ")");
+	QSqlQuery query(db);
+	query.prepare(
+		"SELECT A.guid, P.thumbnail, A.name FROM assets A "
+		"LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.guid IN (" + guidInString + ")"
+	);
 	executeAndCheckQuery(query, "fetchAssetThumbnails");
 
 	QVector<AssetRecord> assetData;
@@ -684,11 +978,11 @@ QVector<AssetRecord> Database::fetchAssetThumbnails(const QStringList &guids)
 
 void Database::updateAuthorInfo(const QString &author_name)
 {
-	QSqlQuery query1;
+	QSqlQuery query1(db);
 	query1.prepare("DELETE FROM author");
 	executeAndCheckQuery(query1, "wipeTable");
 
-	QSqlQuery query2;
+	QSqlQuery query2(db);
 	query2.prepare("INSERT INTO author (name, date_created, default_license) VALUES (:name, datetime(), :default_license)");
 	query2.bindValue(":name", author_name);
 	query2.bindValue(":default_license", "CCBY");
@@ -697,7 +991,7 @@ void Database::updateAuthorInfo(const QString &author_name)
 
 bool Database::isAuthorInfoPresent()
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT COUNT(*) FROM author");
 	executeAndCheckQuery(query, "authorCount");
 
@@ -715,7 +1009,7 @@ bool Database::isAuthorInfoPresent()
 
 QString Database::getAuthorName()
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT name FROM author LIMIT 1");
 	executeAndCheckQuery(query, "getAuthorName");
 
@@ -733,12 +1027,12 @@ QString Database::getAuthorName()
 
 bool Database::deleteProject()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM projects WHERE guid = ?");
     query.addBindValue(Globals::project->getProjectGuid());
     bool q = executeAndCheckQuery(query, "DeleteProject");
 
-    QSqlQuery dquery;
+    QSqlQuery dquery(db);
     dquery.prepare("DELETE FROM dependencies WHERE project_guid = ?");
     dquery.addBindValue(Globals::project->getProjectGuid());
     bool d = executeAndCheckQuery(dquery, "DeleteDependencies");
@@ -748,7 +1042,7 @@ bool Database::deleteProject()
 
 bool Database::destroyTable(const QString &table)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(QString("DROP TABLE IF EXISTS %1").arg(table));
 	return executeAndCheckQuery(query, QString("DropAssetTable[%1]").arg(table));
 }
@@ -759,28 +1053,36 @@ void Database::wipeDatabase()
 	destroyTable("thumbnails");
 	destroyTable("collections");
 	destroyTable("assets");
+	destroyTable("asset_payloads");
 	destroyTable("dependencies");
 	destroyTable("author");
 	destroyTable("folders");
 	destroyTable("metadata");
+	destroyTable("assets_search");
 }
 
 bool Database::deleteAsset(const QString &guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM assets WHERE guid = ?");
     query.addBindValue(guid);
 
-    for (int i = 0; i < AssetManager::getAssets().count(); i++) {
-        if (AssetManager::getAssets()[i]->assetGuid == guid) AssetManager::getAssets().remove(i);
-    }
+    AssetManager::removeAsset(guid);
+
+    QSqlQuery payloadQuery(db);
+    payloadQuery.prepare("DELETE FROM asset_payloads WHERE guid = ?");
+    payloadQuery.addBindValue(guid);
+    executeAndCheckQuery(payloadQuery, "DeleteAssetPayload");
 
-	return executeAndCheckQuery(query, "DeleteAsset");
+	const bool deleted = executeAndCheckQuery(query, "DeleteAsset");
+	ShaderCache::invalidate(guid);
+
+	return deleted;
 }
 
 bool Database::deleteCollection(const int &collectionId)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM collections WHERE collection_id = ?");
     query.addBindValue(collectionId);
     return executeAndCheckQuery(query, "DeleteCollection");
@@ -788,7 +1090,7 @@ bool Database::deleteCollection(const int &collectionId)
 
 bool Database::deleteFolder(const QString &guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM folders WHERE guid = ?");
     query.addBindValue(guid);
     return executeAndCheckQuery(query, "DeleteFolder");
@@ -796,7 +1098,7 @@ bool Database::deleteFolder(const QString &guid)
 
 bool Database::deleteDependency(const QString &dependee)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM dependencies WHERE dependee = ?");
     query.addBindValue(dependee);
     return executeAndCheckQuery(query, "deleteDependency");
@@ -804,7 +1106,7 @@ bool Database::deleteDependency(const QString &dependee)
 
 bool Database::deleteDependency(const QString &depender, const QString &dependee)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM dependencies WHERE depender = ? AND dependee = ?");
     query.addBindValue(depender);
     query.addBindValue(dependee);
@@ -813,7 +1115,7 @@ bool Database::deleteDependency(const QString &depender, const QString &dependee
 
 bool Database::removeDependenciesByType(const QString &depender, const ModelTypes &type)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM dependencies WHERE depender = ? AND dependee_type = ?");
     query.addBindValue(depender);
     query.addBindValue(static_cast<int>(type));
@@ -823,7 +1125,7 @@ bool Database::removeDependenciesByType(const QString &depender, const ModelType
 
 bool Database::deleteRecord(const QString &table, const QString &row, const QVariant &value)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("DELETE FROM " + table + " WHERE " + row + " = ?");
     query.addBindValue(value);
     return executeAndCheckQuery(query, "DeleteRecord[" + table + ", " + row + "]");
@@ -831,7 +1133,7 @@ bool Database::deleteRecord(const QString &table, const QString &row, const QVar
 
 bool Database::renameProject(const QString &guid, const QString &newName)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE projects SET name = ? WHERE guid = ?");
     query.addBindValue(newName);
     query.addBindValue(guid);
@@ -840,7 +1142,7 @@ bool Database::renameProject(const QString &guid, const QString &newName)
 
 bool Database::renameFolder(const QString &guid, const QString &newName)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE folders SET name = ? WHERE guid = ?");
     query.addBindValue(newName);
     query.addBindValue(guid);
@@ -849,7 +1151,7 @@ bool Database::renameFolder(const QString &guid, const QString &newName)
 
 bool Database::renameCollection(const int &collectionId, const QString &newName)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE collections SET name = ? WHERE collection_id = ?");
     query.addBindValue(newName);
     query.addBindValue(collectionId);
@@ -858,16 +1160,21 @@ bool Database::renameCollection(const int &collectionId, const QString &newName)
 
 bool Database::renameAsset(const QString &guid, const QString &newName)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE assets SET name = ? WHERE guid = ?");
     query.addBindValue(newName);
     query.addBindValue(guid);
-    return executeAndCheckQuery(query, "RenameAsset");
+    const bool renamed = executeAndCheckQuery(query, "RenameAsset");
+
+    // Shader definitions resolve their source files by asset name
+    ShaderCache::clear();
+
+    return renamed;
 }
 
 bool Database::updateProject(const QByteArray &sceneBlob, const QByteArray &thumbnail)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE projects SET scene = ?, last_written = datetime(), thumbnail = ? WHERE guid = ?");
     query.addBindValue(sceneBlob);
     query.addBindValue(thumbnail);
@@ -877,8 +1184,13 @@ bool Database::updateProject(const QByteArray &sceneBlob, const QByteArray &thum
 
 bool Database::updateAssetThumbnail(const QString &guid, const QByteArray &thumbnail)
 {
-	QSqlQuery query;
-	query.prepare("UPDATE assets SET thumbnail = ? WHERE guid = ?");
+	QSqlQuery insertQuery(db);
+	insertQuery.prepare("INSERT OR IGNORE INTO asset_payloads (guid) VALUES (?)");
+	insertQuery.addBindValue(guid);
+	executeAndCheckQuery(insertQuery, "InsertAssetPayload");
+
+	QSqlQuery query(db);
+	query.prepare("UPDATE asset_payloads SET thumbnail = ? WHERE guid = ?");
 	query.addBindValue(thumbnail);
 	query.addBindValue(guid);
 	return executeAndCheckQuery(query, "UpdateAssetThumbnail");
@@ -886,35 +1198,56 @@ bool Database::updateAssetThumbnail(const QString &guid, const QByteArray &thumb
 
 bool Database::updateAssetAsset(const QString &guid, const QByteArray &asset)
 {
-	QSqlQuery query;
-	query.prepare("UPDATE assets SET asset = ? WHERE guid = ?");
+	QSqlQuery insertQuery(db);
+	insertQuery.prepare("INSERT OR IGNORE INTO asset_payloads (guid) VALUES (?)");
+	insertQuery.addBindValue(guid);
+	executeAndCheckQuery(insertQuery, "InsertAssetPayload");
+
+	QSqlQuery query(db);
+	query.prepare("UPDATE asset_payloads SET asset = ? WHERE guid = ?");
 	query.addBindValue(asset);
 	query.addBindValue(guid);
-	return executeAndCheckQuery(query, "UpdateAssetAsset");
+	const bool updated = executeAndCheckQuery(query, "UpdateAssetAsset");
+
+	// Invalidated after the write so a reader on another thread can't cache the old definition again
+	ShaderCache::invalidate(guid);
+
+	return updated;
 }
 
 bool Database::updateSceneThumbnail(const QString & guid, const QByteArray &thumbnail)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE projects SET thumbnail = ? WHERE guid = ?");
     query.addBindValue(thumbnail);
     query.addBindValue(Globals::project->getProjectGuid());
     return executeAndCheckQuery(query, "updateSceneThumbnail");
 }
 
+bool Database::updateAssetHash(const QString &guid, const QString &hash)
+{
+    QSqlQuery query(db);
+    query.prepare("UPDATE assets SET hash = ? WHERE guid = ?");
+    query.addBindValue(hash);
+    query.addBindValue(guid);
+    return executeAndCheckQuery(query, "UpdateAssetHash");
+}
+
 bool Database::updateAssetMetadata(const QString &guid, const QString &name, const QByteArray &tags)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE assets SET name = ?, tags = ?, last_updated = datetime() WHERE guid = ?");
     query.addBindValue(name);
     query.addBindValue(tags);
     query.addBindValue(guid);
-    return executeAndCheckQuery(query, "updateAssetMetadata");
+
+    if (!executeAndCheckQuery(query, "updateAssetMetadata")) return false;
+    return updateSearchTags(guid, tags);
 }
 
 bool Database::updateAssetProperties(const QString &guid, const QByteArray &asset)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE assets SET properties = ? WHERE guid = ?");
     query.addBindValue(asset);
     query.addBindValue(guid);
@@ -923,8 +1256,11 @@ bool Database::updateAssetProperties(const QString &guid, const QByteArray &asse
 
 AssetRecord Database::fetchAsset(const QString &guid)
 {
-    QSqlQuery query;
-    query.prepare("SELECT name, thumbnail, guid, parent, type, properties, view_filter FROM assets WHERE guid = ? ");
+    QSqlQuery query(db);
+    query.prepare(
+        "SELECT A.name, P.thumbnail, A.guid, A.parent, A.type, A.properties, A.view_filter FROM assets A "
+        "LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.guid = ?"
+    );
     query.addBindValue(guid);
     executeAndCheckQuery(query, "fetchAsset");
 
@@ -950,14 +1286,15 @@ AssetRecord Database::fetchAsset(const QString &guid)
 
 QVector<AssetRecord> Database::fetchAssetsForAssetView()
 {
-    QSqlQuery query;
+    // Thumbnails are not selected here, views fetch them afterwards with fetchAssetThumbnails()
+    QSqlQuery query(db);
     query.prepare(
-        "SELECT A.name, A.thumbnail, A.guid, C.collection_id, A.type, A.collection, A.properties, "
-        "A.author, A.license, A.tags, A.project_guid, A.asset, A.view_filter "
+        "SELECT A.name, A.guid, A.type, A.collection, A.properties, "
+        "A.author, A.license, A.tags, A.view_filter "
         "FROM assets A "
         "INNER JOIN collections C ON A.collection = C.collection_id "
         "WHERE A.view_filter = :view_filter "
-        "AND A.guid NOT IN (SELECT dependee from dependencies) "
+        "AND NOT EXISTS (SELECT 1 FROM dependencies D WHERE D.dependee = A.guid) "
         "ORDER BY A.name DESC"
     );
     query.bindValue(":view_filter", AssetViewFilter::AssetsView);
@@ -969,17 +1306,14 @@ QVector<AssetRecord> Database::fetchAssetsForAssetView()
         QSqlRecord record = query.record();
         for (int i = 0; i < record.count(); i++) {
             data.name = record.value(0).toString();
-            data.thumbnail = record.value(1).toByteArray();
-            data.guid = record.value(2).toString();
+            data.guid = record.value(1).toString();
+            data.type = record.value(2).toInt();
             data.collection = record.value(3).toInt();
-            data.type = record.value(4).toInt();
-            data.collection = record.value(5).toInt();
-            data.properties = record.value(6).toByteArray();
-            data.author = record.value(7).toString();
-            data.license = record.value(8).toString();
-            data.tags = record.value(9).toByteArray();
-			data.asset = record.value(11).toByteArray();
-			data.view_filter = record.value(12).toInt();
+            data.properties = record.value(4).toByteArray();
+            data.author = record.value(5).toString();
+            data.license = record.value(6).toString();
+            data.tags = record.value(7).toByteArray();
+			data.view_filter = record.value(8).toInt();
         }
 
         Globals::assetNames.insert(data.guid, data.name);
@@ -992,14 +1326,15 @@ QVector<AssetRecord> Database::fetchAssetsForAssetView()
 
 QVector<AssetRecord> Database::fetchChildAssets(const QString &parent, int filter, bool showDependencies)
 {
+    // Thumbnails are not selected here, views fetch them afterwards with fetchAssetThumbnails()
     QString dependentQuery =
-        "SELECT name, thumbnail, guid, parent, type, properties "
+        "SELECT name, guid, parent, type, properties "
         "FROM assets A WHERE parent = ? AND project_guid = ? ";
 
     QString nonDependentQuery =
-        "SELECT name, thumbnail, guid, parent, type, properties "
+        "SELECT name, guid, parent, type, properties "
         "FROM assets A WHERE parent = ? AND project_guid = ? "
-        "AND A.guid NOT IN (SELECT dependee FROM dependencies) ";
+        "AND NOT EXISTS (SELECT 1 FROM dependencies D WHERE D.dependee = A.guid) ";
 
     QString orderQuery = "ORDER BY A.name DESC";
 
@@ -1015,7 +1350,7 @@ QVector<AssetRecord> Database::fetchChildAssets(const QString &parent, int filte
 
     assetsQuery.append(orderQuery);
 
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(assetsQuery);
     query.addBindValue(parent);
     query.addBindValue(Globals::project->getProjectGuid());
@@ -1028,11 +1363,10 @@ QVector<AssetRecord> Database::fetchChildAssets(const QString &parent, int filte
         QSqlRecord record = query.record();
         for (int i = 0; i < record.count(); i++) {
             data.name = record.value(0).toString();
-            data.thumbnail = record.value(1).toByteArray();
-            data.guid = record.value(2).toString();
-            data.parent = record.value(3).toString();
-            data.type = record.value(4).toInt();
-            data.properties = record.value(5).toByteArray();
+            data.guid = record.value(1).toString();
+            data.parent = record.value(2).toString();
+            data.type = record.value(3).toInt();
+            data.properties = record.value(4).toByteArray();
         }
 
         tileData.push_back(data);
@@ -1053,7 +1387,7 @@ QVector<AssetRecord> Database::fetchAssetsFromParent(const QString & guid)
 
 DatabaseMetadataRecord Database::getDbMetadata()
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT date_created, hash, version, data FROM metadata");
 
 	if (query.exec()) {
@@ -1087,7 +1421,7 @@ DatabaseMetadataRecord Database::getDbMetadata()
 
 QVector<AssetRecord> Database::fetchAssetsByCollection(const int &collection_id)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(
         "SELECT assets.name,"
         "assets.thumbnail, assets.guid, collections.id,"
@@ -1121,8 +1455,8 @@ QVector<AssetRecord> Database::fetchAssetsByCollection(const int &collection_id)
 
 QVector<AssetRecord> Database::fetchAssetsByType(const int &type)
 {
-    QSqlQuery query;
-    query.prepare("SELECT guid, type, name, thumbnail, asset FROM assets WHERE type = ? AND project_guid = ?");
+    QSqlQuery query(db);
+    query.prepare("SELECT guid, type, name FROM assets WHERE type = ? AND project_guid = ?");
     query.addBindValue(type);
     query.addBindValue(Globals::project->getProjectGuid());
     executeAndCheckQuery(query, "fetchAssetsByType");
@@ -1135,8 +1469,6 @@ QVector<AssetRecord> Database::fetchAssetsByType(const int &type)
             data.guid = record.value(0).toString();
             data.type = record.value(1).toInt();
             data.name = record.value(2).toString();
-			data.thumbnail = query.value(3).toByteArray();
-            data.asset = record.value(4).toByteArray();
         }
 
         tileData.push_back(data);
@@ -1145,10 +1477,26 @@ QVector<AssetRecord> Database::fetchAssetsByType(const int &type)
     return tileData;
 }
 
+QHash<QString, QString> Database::fetchAssetHashes(const QString &projectGuid)
+{
+    QSqlQuery query(db);
+    query.prepare("SELECT hash, guid FROM assets WHERE project_guid = ? AND hash IS NOT NULL");
+    query.addBindValue(projectGuid);
+    executeAndCheckQuery(query, "FetchAssetHashes");
+
+    QHash<QString, QString> hashes;
+    while (query.next()) {
+        hashes.insert(query.value(0).toString(), query.value(1).toString());
+    }
+
+    return hashes;
+}
+
 QVector<AssetRecord> Database::fetchAssetsByViewFilter(const AssetViewFilter& filter)
 {
-	QSqlQuery query;
-	query.prepare("SELECT guid, type, name, thumbnail, asset FROM assets WHERE view_filter = ?");
+	// Listing columns only, thumbnails and payloads are fetched for the assets that need them
+	QSqlQuery query(db);
+	query.prepare("SELECT A.guid, A.type, A.name FROM assets A WHERE A.view_filter = ?");
 	query.addBindValue(filter);
 	executeAndCheckQuery(query, "fetchAssetsByViewFilter");
 
@@ -1160,8 +1508,6 @@ QVector<AssetRecord> Database::fetchAssetsByViewFilter(const AssetViewFilter& fi
 			data.guid = record.value(0).toString();
 			data.type = record.value(1).toInt();
 			data.name = record.value(2).toString();
-			data.thumbnail = query.value(3).toByteArray();
-			data.asset = record.value(4).toByteArray();
 		}
 
 		tileData.push_back(data);
@@ -1170,6 +1516,105 @@ QVector<AssetRecord> Database::fetchAssetsByViewFilter(const AssetViewFilter& fi
 	return tileData;
 }
 
+QVector<AssetRecord> Database::searchProjectAssets(const QString &text, const QString &projectGuid, int offset, int limit)
+{
+	return searchAssets(text, "A.project_guid = ?", projectGuid, offset, limit);
+}
+
+QVector<AssetRecord> Database::searchLibraryAssets(const QString &text, int offset, int limit)
+{
+	return searchAssets(text, "A.view_filter = ?", AssetViewFilter::AssetsView, offset, limit);
+}
+
+QVector<AssetRecord> Database::searchAssets(const QString &text,
+											const QString &filter,
+											const QVariant &filterValue,
+											int offset,
+											int limit)
+{
+	QVector<AssetRecord> tileData;
+
+	QString searchQuery =
+		"SELECT A.name, A.guid, A.parent, A.type, A.properties, A.author, A.license, A.collection ";
+	QVariantList matchValues;
+
+	if (searchIndexAvailable) {
+		const QString expression = buildSearchExpression(text);
+		if (expression.isEmpty()) return tileData;
+
+		// Words found in the name weigh the most, then tags and type
+		searchQuery +=
+			"FROM assets_search INNER JOIN assets A ON A.rowid = assets_search.rowid "
+			"WHERE assets_search MATCH ? AND " + filter + " "
+			"ORDER BY bm25(assets_search, 10.0, 5.0, 1.0, 1.0, 2.0) ";
+		matchValues.append(expression);
+	}
+	else {
+		QStringList conditions;
+		for (const QString &word : text.split(QRegularExpression("\\s+"), QString::SkipEmptyParts)) {
+			conditions.append("A.name LIKE ?");
+			matchValues.append("%" + word + "%");
+		}
+
+		if (conditions.isEmpty()) return tileData;
+
+		searchQuery +=
+			"FROM assets A WHERE " + conditions.join(" AND ") + " AND " + filter + " "
+			"ORDER BY A.name ";
+	}
+
+	searchQuery += "LIMIT ? OFFSET ?";
+
+	QSqlQuery query(db);
+	query.prepare(searchQuery);
+	for (const QVariant &value : matchValues) query.addBindValue(value);
+	query.addBindValue(filterValue);
+	query.addBindValue(limit);
+	query.addBindValue(qMax(0, offset));
+	executeAndCheckQuery(query, "searchAssets");
+
+	while (query.next()) {
+		AssetRecord data;
+		data.name = query.value(0).toString();
+		data.guid = query.value(1).toString();
+		data.parent = query.value(2).toString();
+		data.type = query.value(3).toInt();
+		data.properties = query.value(4).toByteArray();
+		data.author = query.value(5).toString();
+		data.license = query.value(6).toString();
+		data.collection = query.value(7).toInt();
+
+		tileData.push_back(data);
+	}
+
+	return tileData;
+}
+
+QString Database::buildSearchExpression(const QString &text)
+{
+	QStringList terms;
+	for (const QString &word : text.split(QRegularExpression("\\s+"), QString::SkipEmptyParts)) {
+		QString column;
+		QString value = word;
+
+		const int separator = word.indexOf(':');
+		if (separator > 0 && searchColumns.contains(word.left(separator).toLower())) {
+			column = word.left(separator).toLower();
+			value = word.mid(separator + 1);
+		}
+
+		// Words are quoted so FTS5 syntax in names is taken literally, words
+		// without a letter or a digit would become an empty phrase so they're dropped
+		value.remove('"');
+		if (!value.contains(QRegularExpression("[\\p{L}\\p{N}]"))) continue;
+
+		const QString phrase = QString("\"%1\"*").arg(value);
+		terms.append(column.isEmpty() ? phrase : QString("%1 : %2").arg(column, phrase));
+	}
+
+	return terms.join(' ');
+}
+
 void Database::createExportBundle(const QStringList & objectGuids, const QString & outTempFilePath)
 {
     QSqlDatabase exportConnection = QSqlDatabase();
@@ -1202,10 +1647,11 @@ void Database::createExportBundle(const QStringList & objectGuids, const QString
     }
 
     for (const auto &asset : fullAssetList) {
-        QSqlQuery selectAssetQuery;
+        QSqlQuery selectAssetQuery(db);
         selectAssetQuery.prepare(
-            "SELECT guid, type, name, collection, times_used, project_guid, date_created, last_updated, "
-            "author, license, hash, version, parent, tags, properties, asset, thumbnail, view_filter FROM assets WHERE guid = ?"
+            "SELECT A.guid, A.type, A.name, A.collection, A.times_used, A.project_guid, A.date_created, A.last_updated, "
+            "A.author, A.license, A.hash, A.version, A.parent, A.tags, A.properties, P.asset, P.thumbnail, A.view_filter "
+            "FROM assets A LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.guid = ?"
         );
         selectAssetQuery.addBindValue(asset);
 
@@ -1283,7 +1729,7 @@ void Database::createExportBundle(const QStringList & objectGuids, const QString
     QVector<DependencyRecord> dependenciesToExport;
 
     for (const auto &asset : assetList) {
-        QSqlQuery selectDep;
+        QSqlQuery selectDep(db);
         selectDep.prepare(
             "SELECT depender_type, dependee_type, project_guid, depender, dependee, id FROM dependencies WHERE "
             "dependee = ? AND dependee_type = ?"// AND depender_type = ?"
@@ -1343,7 +1789,7 @@ void Database::createExportBundle(const QStringList & objectGuids, const QString
 
 void Database::insertCollectionGlobal(const QString &collectionName)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     auto guid = GUIDManager::generateGUID();
     query.prepare("INSERT INTO " + Constants::DB_COLLECT_TABLE +
         " (name, date_created)" +
@@ -1355,7 +1801,7 @@ void Database::insertCollectionGlobal(const QString &collectionName)
 
 bool Database::switchAssetCollection(const int id, const QString &guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("UPDATE " + Constants::DB_ASSETS_TABLE + " SET collection = ?, last_updated = datetime() WHERE guid = ?");
     query.addBindValue(id);
     query.addBindValue(guid);
@@ -1368,7 +1814,7 @@ void Database::insertThumbnailGlobal(const QString &world_guid,
                                      const QByteArray &thumbnail,
 								     const QString &thumbnail_guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("INSERT INTO " + Constants::DB_THUMBS_TABLE + " (world_guid, name, thumbnail, guid)"
                   " VALUES (:world_guid, :name, :thumbnail, :guid)");
     query.bindValue(":world_guid",  world_guid);
@@ -1381,8 +1827,8 @@ void Database::insertThumbnailGlobal(const QString &world_guid,
 
 QByteArray Database::fetchAssetData(const QString &guid) const
 {
-	QSqlQuery query;
-	query.prepare("SELECT asset FROM assets WHERE guid = ?");
+	QSqlQuery query(db);
+	query.prepare("SELECT asset FROM asset_payloads WHERE guid = ?");
 	query.addBindValue(guid);
 
 	if (query.exec()) {
@@ -1395,9 +1841,96 @@ QByteArray Database::fetchAssetData(const QString &guid) const
 	return QByteArray();
 }
 
+QVector<AssetRecord> Database::fetchProjectAssetsConcurrent(const QString &projectGuid,
+                                                            const QVector<int> &types,
+                                                            const QVector<int> &payloadTypes)
+{
+    QVector<AssetRecord> records;
+    if (types.isEmpty()) return records;
+
+    auto toList = [](const QVector<int> &values) {
+        QStringList list;
+        for (int value : values) list.append(QString::number(value));
+        return list.join(", ");
+    };
+
+    // Connections can't be shared between threads, each worker opens its own
+    const QString connectionName = QString("ProjectAssetsConnection_%1")
+        .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+
+    {
+        QSqlDatabase connection = QSqlDatabase::addDatabase(Constants::DB_DRIVER, connectionName);
+        connection.setDatabaseName(db.databaseName());
+        connection.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+        if (!connection.open()) {
+            irisLog(QString("Couldn't open a database connection! %1").arg(connection.lastError().text()));
+        }
+        else {
+            QSqlQuery query(connection);
+            query.prepare(QString(
+                "SELECT assets.guid, assets.type, assets.name, "
+                "CASE WHEN assets.type IN (%1) THEN asset_payloads.asset END "
+                "FROM assets LEFT JOIN asset_payloads ON asset_payloads.guid = assets.guid "
+                "WHERE assets.project_guid = ? AND assets.type IN (%2)"
+            ).arg(payloadTypes.isEmpty() ? QString("NULL") : toList(payloadTypes), toList(types)));
+            query.addBindValue(projectGuid);
+
+            if (executeAndCheckQuery(query, "fetchProjectAssetsConcurrent")) {
+                while (query.next()) {
+                    AssetRecord data;
+                    data.guid = query.value(0).toString();
+                    data.type = query.value(1).toInt();
+                    data.name = query.value(2).toString();
+                    data.asset = query.value(3).toByteArray();
+                    records.append(data);
+                }
+            }
+
+            connection.close();
+        }
+    }
+
+    QSqlDatabase::removeDatabase(connectionName);
+    return records;
+}
+
+bool Database::updateProjectConcurrent(const QString &projectGuid,
+                                       const QByteArray &sceneBlob,
+                                       const QByteArray &thumbnail)
+{
+    bool updated = false;
+    const QString connectionName = QString("ProjectSaveConnection_%1")
+        .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+
+    {
+        QSqlDatabase connection = QSqlDatabase::addDatabase(Constants::DB_DRIVER, connectionName);
+        connection.setDatabaseName(db.databaseName());
+        // The GUI thread keeps writing through the default connection, wait for its locks instead of failing
+        connection.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+
+        if (!connection.open()) {
+            irisLog(QString("Couldn't open a database connection! %1").arg(connection.lastError().text()));
+        }
+        else {
+            QSqlQuery query(connection);
+            query.prepare("UPDATE projects SET scene = ?, last_written = datetime(), thumbnail = ? WHERE guid = ?");
+            query.addBindValue(sceneBlob);
+            query.addBindValue(thumbnail);
+            query.addBindValue(projectGuid);
+            updated = executeAndCheckQuery(query, "updateProjectConcurrent");
+
+            connection.close();
+        }
+    }
+
+    QSqlDatabase::removeDatabase(connectionName);
+    return updated;
+}
+
 bool Database::hasCachedThumbnail(const QString &name)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT EXISTS (SELECT 1 FROM " + Constants::DB_THUMBS_TABLE + " WHERE name = ? LIMIT 1)");
     query.addBindValue(name);
 
@@ -1414,8 +1947,11 @@ bool Database::hasCachedThumbnail(const QString &name)
 
 QVector<AssetRecord> Database::fetchThumbnails()
 {
-	QSqlQuery query;
-	query.prepare("SELECT name, thumbnail, guid, type FROM assets WHERE type = 5");
+	QSqlQuery query(db);
+	query.prepare(
+		"SELECT A.name, P.thumbnail, A.guid, A.type FROM assets A "
+		"LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.type = 5"
+	);
 	executeAndCheckQuery(query, "fetchThumbnails");
 
 	QVector<AssetRecord> tileData;
@@ -1437,7 +1973,7 @@ QVector<AssetRecord> Database::fetchThumbnails()
 
 QVector<AssetRecord> Database::fetchFavorites()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(
         "SELECT F.asset_guid, F.name, F.date_created, A.type, F.thumbnail FROM favorites F "
         "LEFT JOIN assets A ON A.guid = F.asset_guid"
@@ -1464,7 +2000,7 @@ QVector<AssetRecord> Database::fetchFavorites()
 
 QVector<AssetRecord> Database::fetchFilteredAssets(const QString &guid, const int &type)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT name, guid FROM assets WHERE project_guid = ? AND type = ?");
 	query.addBindValue(guid);
 	query.addBindValue(type);
@@ -1487,7 +2023,7 @@ QVector<AssetRecord> Database::fetchFilteredAssets(const QString &guid, const in
 
 QVector<CollectionRecord> Database::fetchCollections()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT name, collection_id FROM " + Constants::DB_COLLECT_TABLE + " ORDER BY name, date_created DESC");
     executeAndCheckQuery(query, "fetchCollections");
 
@@ -1508,7 +2044,7 @@ QVector<CollectionRecord> Database::fetchCollections()
 
 QVector<ProjectTileData> Database::fetchProjects()
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT name, thumbnail, guid FROM projects ORDER BY last_written DESC");
     executeAndCheckQuery(query, "FetchProjects");
 
@@ -1530,7 +2066,7 @@ QVector<ProjectTileData> Database::fetchProjects()
 
 QByteArray Database::getSceneBlobGlobal() const
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT scene FROM projects WHERE guid = ?");
     query.addBindValue(Globals::project->getProjectGuid());
 
@@ -1547,7 +2083,7 @@ QByteArray Database::getSceneBlobGlobal() const
 
 QByteArray Database::fetchCachedThumbnail(const QString &name) const
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT thumbnail FROM " + Constants::DB_THUMBS_TABLE + " WHERE name = ?");
     query.addBindValue(name);
 
@@ -1598,11 +2134,15 @@ bool Database::createBlobFromNode(const iris::SceneNodePtr &node, const QString
         }
     }
 
+    // children commonly share materials and textures, export each asset once
+    allAssetsToExport.removeDuplicates();
+
     for (const auto &asset : allAssetsToExport) {
-        QSqlQuery selectAssetQuery;
+        QSqlQuery selectAssetQuery(db);
         selectAssetQuery.prepare(
-            "SELECT guid, type, name, collection, times_used, project_guid, date_created, last_updated, "
-            "author, license, hash, version, parent, tags, properties, asset, thumbnail, view_filter FROM assets WHERE guid = ?"
+            "SELECT A.guid, A.type, A.name, A.collection, A.times_used, A.project_guid, A.date_created, A.last_updated, "
+            "A.author, A.license, A.hash, A.version, A.parent, A.tags, A.properties, P.asset, P.thumbnail, A.view_filter "
+            "FROM assets A LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.guid = ?"
         );
         selectAssetQuery.addBindValue(asset);
 
@@ -1682,7 +2222,7 @@ bool Database::createBlobFromNode(const iris::SceneNodePtr &node, const QString
     QVector<DependencyRecord> dependenciesToExport;
 
     for (const auto &asset : assetList) {
-        QSqlQuery selectDep;
+        QSqlQuery selectDep(db);
         selectDep.prepare(
             "SELECT depender_type, dependee_type, project_guid, depender, dependee, id "
             "FROM dependencies WHERE "
@@ -1767,10 +2307,11 @@ bool Database::createBlobFromAsset(const QString &guid, const QString &writePath
     }
 
     for (const auto &asset : allAssetsToExport) {
-        QSqlQuery selectAssetQuery;
+        QSqlQuery selectAssetQuery(db);
         selectAssetQuery.prepare(
-            "SELECT guid, type, name, collection, times_used, project_guid, date_created, last_updated, "
-            "author, license, hash, version, parent, tags, properties, asset, thumbnail, view_filter FROM assets WHERE guid = ?"
+            "SELECT A.guid, A.type, A.name, A.collection, A.times_used, A.project_guid, A.date_created, A.last_updated, "
+            "A.author, A.license, A.hash, A.version, A.parent, A.tags, A.properties, P.asset, P.thumbnail, A.view_filter "
+            "FROM assets A LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.guid = ?"
         );
         selectAssetQuery.addBindValue(asset);
 
@@ -1839,7 +2380,7 @@ bool Database::createBlobFromAsset(const QString &guid, const QString &writePath
     QVector<DependencyRecord> dependenciesToExport;
 
     for (const auto &asset : assetList) {
-        QSqlQuery selectDep;
+        QSqlQuery selectDep(db);
         selectDep.prepare(
             "SELECT depender_type, dependee_type, project_guid, depender, dependee, id "
             "FROM dependencies WHERE "
@@ -1893,7 +2434,7 @@ bool Database::createBlobFromAsset(const QString &guid, const QString &writePath
 
 void Database::createExportScene(const QString &outTempFilePath)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT name, scene, thumbnail, version, last_written, last_accessed, guid FROM projects WHERE guid = ?");
     query.addBindValue(Globals::project->getProjectGuid());
 
@@ -1906,7 +2447,8 @@ void Database::createExportScene(const QString &outTempFilePath)
     }
 
     auto sceneName  = query.value(0).toString();
-    auto sceneBlob  = query.value(1).toByteArray();
+    // Exports carry the scene as binary JSON so any version can import them
+    auto sceneBlob  = SceneFormat::toBinaryJson(query.value(1).toByteArray());
     auto sceneThumb = query.value(2).toByteArray();
     auto sceneVersion = query.value(3).toString();
     auto sceneLastW = query.value(4).toDateTime();
@@ -2010,10 +2552,11 @@ void Database::createExportScene(const QString &outTempFilePath)
 
     QVector<AssetRecord> assetList;
 
-    QSqlQuery selectAssetQuery;
+    QSqlQuery selectAssetQuery(db);
     selectAssetQuery.prepare(
-        "SELECT guid, type, name, collection, times_used, project_guid, date_created, last_updated, author, "
-        "license, hash, version, parent, tags, properties, asset, thumbnail, view_filter FROM assets WHERE project_guid = ?"
+        "SELECT A.guid, A.type, A.name, A.collection, A.times_used, A.project_guid, A.date_created, A.last_updated, "
+        "A.author, A.license, A.hash, A.version, A.parent, A.tags, A.properties, P.asset, P.thumbnail, A.view_filter "
+        "FROM assets A LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.project_guid = ?"
     );
     selectAssetQuery.addBindValue(Globals::project->getProjectGuid());
     executeAndCheckQuery(selectAssetQuery, "selectAssetQuery");
@@ -2076,7 +2619,7 @@ void Database::createExportScene(const QString &outTempFilePath)
 
     QVector<DependencyRecord> dependenciesToExport;
 
-    QSqlQuery selectDep;
+    QSqlQuery selectDep(db);
     selectDep.prepare(
 		"SELECT depender_type, dependee_type, project_guid, depender, dependee, id FROM dependencies WHERE project_guid = ?"
 	);
@@ -2113,7 +2656,7 @@ void Database::createExportScene(const QString &outTempFilePath)
 
     QVector<FolderRecord> foldersToExport;
 
-    QSqlQuery selectFolder;
+    QSqlQuery selectFolder(db);
     selectFolder.prepare(
 		"SELECT guid, name, parent, count, project_guid, date_created, last_updated, visible FROM folders WHERE project_guid = ?"
 	);
@@ -2157,7 +2700,7 @@ void Database::createExportScene(const QString &outTempFilePath)
 
 bool Database::checkIfRecordExists(const QString & record, const QVariant &value, const QString &table, bool perProject)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	QString queryString = "SELECT EXISTS (SELECT 1 FROM %1 WHERE %2 = ? ";
 	if (!perProject) queryString.append("AND project_guid = ? ");
 	queryString.append("LIMIT 1)");
@@ -2177,7 +2720,7 @@ bool Database::checkIfRecordExists(const QString & record, const QVariant &value
 
 bool Database::checkIfDependencyExists(const QString& depender, const QString& dependee)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(QString("SELECT 1 from dependencies WHERE depender = ? and dependee = ?"));
 	query.addBindValue(depender);
 	query.addBindValue(dependee);
@@ -2192,7 +2735,7 @@ bool Database::checkIfDependencyExists(const QString& depender, const QString& d
 
 QStringList Database::fetchFolderNameByParent(const QString &guid)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT name FROM folders WHERE parent = ?");
 	query.addBindValue(guid);
 	executeAndCheckQuery(query, "fetchFolderNameByParent");
@@ -2208,7 +2751,7 @@ QStringList Database::fetchFolderNameByParent(const QString &guid)
 
 QStringList Database::fetchAssetNameByParent(const QString &guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT name FROM assets WHERE parent = ?");
     query.addBindValue(guid);
     executeAndCheckQuery(query, "FetchAssetNameByParent");
@@ -2224,28 +2767,18 @@ QStringList Database::fetchAssetNameByParent(const QString &guid)
 
 QStringList Database::fetchFolderAndChildFolders(const QString &guid)
 {
-	std::function<void(QStringList&, const QString&)> fetchFolders
-		= [&](QStringList &folders, const QString &guid) -> void
-	{
-		QSqlQuery query;
-		query.prepare("SELECT guid FROM folders WHERE parent = ?");
-		query.addBindValue(guid);
-		executeAndCheckQuery(query, "fetchFolderAndDependencies");
-
-		QStringList subFolders;
-		while (query.next()) {
-			QSqlRecord record = query.record();
-			subFolders.append(record.value(0).toString());
-			folders.append(record.value(0).toString());
-		}
-
-		for (const QString &folder : subFolders) {
-			fetchFolders(folders, folder);
-		}
-	};
+	QSqlQuery query(db);
+	query.prepare(FolderSubtree::subtreeQuery + "SELECT guid FROM subtree WHERE guid <> ?");
+	query.addBindValue(guid);
+	query.addBindValue(guid);
+	executeAndCheckQuery(query, "fetchFolderAndChildFolders");
 
 	QStringList folders;
-	fetchFolders(folders, guid);
+	while (query.next()) {
+		folders.append(query.value(0).toString());
+	}
+
+	// the folder itself comes last, after everything below it
 	folders.append(guid);
 
 	return folders;
@@ -2253,7 +2786,7 @@ QStringList Database::fetchFolderAndChildFolders(const QString &guid)
 
 QStringList Database::fetchChildFolderAssets(const QString &guid)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT guid FROM assets WHERE parent = ?");
 	query.addBindValue(guid);
 	executeAndCheckQuery(query, "fetchChildFolderAssets");
@@ -2270,7 +2803,7 @@ QStringList Database::fetchChildFolderAssets(const QString &guid)
 
 QStringList Database::fetchAssetDependeesByType(const QString & guid, const ModelTypes &type)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(
         "SELECT assets.guid FROM dependencies "
         "INNER JOIN assets ON dependencies.dependee = assets.guid "
@@ -2289,7 +2822,7 @@ QStringList Database::fetchAssetDependeesByType(const QString & guid, const Mode
 
 QStringList Database::fetchAssetAndDependencies(const QString &guid)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(
 		"SELECT assets.name, assets.guid FROM dependencies "
 		"INNER JOIN assets ON dependencies.dependee = assets.guid "
@@ -2317,7 +2850,7 @@ QStringList Database::fetchAssetAndDependencies(const QString &guid)
 
 QStringList Database::fetchAssetGUIDAndDependencies(const QString &guid, bool appendSelf)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare(
         "SELECT assets.guid FROM dependencies INNER JOIN assets ON "
         "dependencies.dependee = assets.guid WHERE depender = ?"
@@ -2337,29 +2870,33 @@ QStringList Database::fetchAssetGUIDAndDependencies(const QString &guid, bool ap
 
 QStringList Database::fetchAssetAndAllDependencies(const QString & guid)
 {
-    QStringList topLevelAssets;
-    QStringList assetAndDependencies;
-
-    for (const auto &asset : fetchAssetGUIDAndDependencies(guid)) {
-        topLevelAssets.append(asset);
-        assetAndDependencies.append(asset);
-    }
+    // Transitive closure of the dependency graph in one query, dependencies of dependencies
+    // are followed at any depth and shared or cyclic ones are only visited once
+    QSqlQuery query(db);
+    query.prepare(
+        "WITH RECURSIVE closure(guid) AS ("
+        "    SELECT ?"
+        "    UNION"
+        "    SELECT D.dependee FROM dependencies D"
+        "    INNER JOIN closure C ON D.depender = C.guid"
+        "    INNER JOIN assets A ON A.guid = D.dependee"
+        ") "
+        "SELECT guid FROM closure"
+    );
+    query.addBindValue(guid);
+    executeAndCheckQuery(query, "fetchAssetAndAllDependencies");
 
-    // Dependency level is always max 2
-    for (const auto &asset : topLevelAssets) {
-        for (const auto &guid : fetchAssetGUIDAndDependencies(asset)) {
-            assetAndDependencies.append(guid);
-        }
+    QStringList assetAndDependencies;
+    while (query.next()) {
+        assetAndDependencies.append(query.value(0).toString());
     }
 
-    assetAndDependencies.removeDuplicates();
-
     return assetAndDependencies;
 }
 
 QVector<DependencyRecord> Database::fetchAssetDependencies(const AssetRecord &record)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare(
         "SELECT D.depender_type, D.dependee_type, D.depender, D.dependee, D.id, D.project_guid "
         "FROM dependencies D INNER JOIN assets ON "
@@ -2387,27 +2924,14 @@ QVector<DependencyRecord> Database::fetchAssetDependencies(const AssetRecord &re
 
 QStringList Database::deleteFolderAndDependencies(const QString &guid)
 {
-	QStringList files;
-
-	// Get all child folders
-	for (const auto &folder : fetchFolderAndChildFolders(guid)) {
-		// For every folder, fetch assets inside
-		for (const auto &asset : fetchChildFolderAssets(folder)) {
-			// For every asset, find their dependencies
-			for (const auto &dep : fetchAssetAndDependencies(asset)) {
-				files.append(dep);
-			}
-
-			deleteAsset(asset);
-			
-            for (const auto &dep : fetchAssetGUIDAndDependencies(asset, false)) {
-                deleteDependency(asset, dep);
-            }
-		}
+	const FolderSubtree::Deletion deletion = FolderSubtree::remove(db, guid);
 
-		deleteFolder(folder);
+	for (const QString &asset : deletion.removedAssets) {
+		AssetManager::removeAsset(asset);
+		ShaderCache::invalidate(asset);
 	}
 
+	QStringList files = deletion.files;
 	for (int i = 0; i < files.size(); ++i) {
 		if (QFileInfo(files[i]).suffix().isEmpty()) {
 			files.removeAt(i);
@@ -2447,7 +2971,7 @@ QStringList Database::deleteAssetAndDependencies(const QString & guid)
 
 QString Database::fetchAssetGUIDByName(const QString & name)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT guid FROM assets WHERE name = ? AND project_guid = ?");
 	query.addBindValue(name);
 	query.addBindValue(Globals::project->getProjectGuid());
@@ -2468,7 +2992,7 @@ QString Database::fetchAssetGUIDByName(const QString & name)
 
 QString Database::fetchObjectMesh(const QString &guid, const int ertype, const int eetype)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT dependee FROM dependencies WHERE depender = ? AND depender_type = ? AND dependee_type = ?");
 	query.addBindValue(guid);
 	query.addBindValue(ertype);
@@ -2490,7 +3014,7 @@ QString Database::fetchObjectMesh(const QString &guid, const int ertype, const i
 
 QString Database::fetchMeshObject(const QString &guid, const int ertype, const int eetype)
 {
-	QSqlQuery query;
+	QSqlQuery query(db);
 	query.prepare("SELECT depender FROM dependencies WHERE dependee = ? AND depender_type = ? AND dependee_type == ?");
 	query.addBindValue(guid);
 	query.addBindValue(ertype);
@@ -2512,7 +3036,7 @@ QString Database::fetchMeshObject(const QString &guid, const int ertype, const i
 
 QStringList Database::hasMultipleDependers(const QString &guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT depender FROM dependencies WHERE dependee = ?");
     query.addBindValue(guid);
     executeAndCheckQuery(query, "HasMultipleDependers");
@@ -2527,7 +3051,7 @@ QStringList Database::hasMultipleDependers(const QString &guid)
 
 bool Database::hasDependencies(const QString &guid)
 {
-    QSqlQuery query;
+    QSqlQuery query(db);
     query.prepare("SELECT COUNT(*) FROM dependencies WHERE depender = ?");
     query.addBindValue(guid);
     executeAndCheckQuery(query, "HasDependencies");
@@ -2613,24 +3137,18 @@ bool Database::importProject(const QString &inFilePath, const QString &newSceneG
         assetList.push_back(data);
     }
 
-    QSqlQuery query3;
+    // Everything from here on is written in a single transaction, a failed import is rolled back
+    // completely instead of leaving a partial project behind and we only sync to disk once
+    const bool inTransaction = beginTransaction("Project import");
+
+    QSqlQuery query3(db);
     query3.prepare(
         "INSERT INTO projects "
         "(name, scene, thumbnail, version, last_written, last_accessed, guid) "
         "VALUES (:name, :scene, :thumbnail, :version, :last_written, :last_accessed, :guid)"
     );
 
-    auto doc = QJsonDocument::fromBinaryData(sceneBlob);
-    QString docToString = doc.toJson(QJsonDocument::Compact);
-
-    QMapIterator<QString, QString> i(assetGuids);
-    while (i.hasNext()) {
-        i.next();
-        docToString.replace(i.key(), i.value());
-    }
-
-    QJsonDocument updatedDoc = QJsonDocument::fromJson(docToString.toUtf8());
-    sceneBlob = updatedDoc.toBinaryData();
+    sceneBlob = GUIDManager::remapGuidsInBinaryJson(SceneFormat::toBinaryJson(sceneBlob), assetGuids);
 
     query3.bindValue(":name", sceneName);
     query3.bindValue(":scene", sceneBlob);
@@ -2640,17 +3158,22 @@ bool Database::importProject(const QString &inFilePath, const QString &newSceneG
     query3.bindValue(":last_accessed", sceneLastA);
     query3.bindValue(":guid", newSceneGuid);
 
-    executeAndCheckQuery(query3, "insertSceneGlobal");
+    bool imported = executeAndCheckQuery(query3, "insertSceneGlobal");
+
+    QSqlQuery insertImportAssetQuery(db);
+    insertImportAssetQuery.prepare(
+        "INSERT INTO assets"
+        " (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
+        " license, hash, version, parent, tags, properties, view_filter)"
+        " VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
+        " :license, :hash, :version, :parent, :tags, :properties, :view_filter)"
+    );
+
+    QSqlQuery insertPayloadQuery(db);
+    insertPayloadQuery.prepare(assetPayloadInsertQuery);
 
     for (auto &asset : assetList) {
-        QSqlQuery insertImportAssetQuery;
-        insertImportAssetQuery.prepare(
-            "INSERT INTO assets"
-            " (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
-            " license, hash, version, parent, tags, properties, asset, thumbnail, view_filter)"
-            " VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
-            " :license, :hash, :version, :parent, :tags, :properties, :asset, :thumbnail, :view_filter)"
-        );
+        if (!imported) break;
 
         insertImportAssetQuery.bindValue(":guid", asset.guid);
         insertImportAssetQuery.bindValue(":type", asset.type);
@@ -2677,27 +3200,18 @@ bool Database::importProject(const QString &inFilePath, const QString &newSceneG
             asset.type == static_cast<int>(ModelTypes::Shader) ||
             asset.type == static_cast<int>(ModelTypes::Material))
         {
-            auto doc = QJsonDocument::fromBinaryData(asset.asset);
-            QString docToString = doc.toJson(QJsonDocument::Compact);
-
-            QMapIterator<QString, QString> i(assetGuids);
-            while (i.hasNext()) {
-                i.next();
-                docToString.replace(i.key(), i.value());
-            }
-
-            QJsonDocument updatedDoc = QJsonDocument::fromJson(docToString.toUtf8());
-            asset.asset = updatedDoc.toBinaryData();
-            insertImportAssetQuery.bindValue(":asset", asset.asset);
-        }
-        else {
-            insertImportAssetQuery.bindValue(":asset", asset.asset);
+            asset.asset = GUIDManager::remapGuidsInBinaryJson(asset.asset, assetGuids);
         }
 
-        insertImportAssetQuery.bindValue(":thumbnail", asset.thumbnail);
         insertImportAssetQuery.bindValue(":view_filter", asset.view_filter);
 
-        executeAndCheckQuery(insertImportAssetQuery, "insertImportAssetQuery");
+        imported &= executeAndCheckQuery(insertImportAssetQuery, "insertImportAssetQuery");
+        if (!asset.tags.isEmpty()) updateSearchTags(asset.guid, asset.tags);
+
+        insertPayloadQuery.bindValue(":guid", asset.guid);
+        insertPayloadQuery.bindValue(":thumbnail", asset.thumbnail);
+        insertPayloadQuery.bindValue(":asset", asset.asset);
+        imported &= executeAndCheckQuery(insertPayloadQuery, "insertImportPayloadQuery");
     }
 
     QVector<DependencyRecord> dependenciesToImport;
@@ -2717,12 +3231,14 @@ bool Database::importProject(const QString &inFilePath, const QString &newSceneG
         dependenciesToImport.append(record);
     }
 
+    QSqlQuery importDep(db);
+    importDep.prepare(
+        "INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
+        "VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
+    );
+
     for (const auto &dep : dependenciesToImport) {
-        QSqlQuery importDep;
-        importDep.prepare(
-            "INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
-            "VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
-        );
+        if (!imported) break;
 
         auto depender = assetGuids.value(dep.depender);
         auto dependee = assetGuids.value(dep.dependee);
@@ -2734,7 +3250,7 @@ bool Database::importProject(const QString &inFilePath, const QString &newSceneG
         importDep.bindValue(":dependee", !dependee.isEmpty() ? dependee : dep.dependee);
         importDep.bindValue(":id", GUIDManager::generateGUID());
 
-        executeAndCheckQuery(importDep, "importDep");
+        imported &= executeAndCheckQuery(importDep, "importDep");
     }
 
     QVector<FolderRecord> foldersToImport;
@@ -2756,12 +3272,14 @@ bool Database::importProject(const QString &inFilePath, const QString &newSceneG
         foldersToImport.append(record);
     }
 
+    QSqlQuery importFolder(db);
+    importFolder.prepare(
+        "INSERT INTO folders (guid, name, parent, count, project_guid, date_created, last_updated, visible) "
+        "VALUES (:guid, :name, :parent, :count, :project_guid, :date_created, :last_updated, :visible)"
+    );
+
     for (const auto &folder : foldersToImport) {
-        QSqlQuery importFolder;
-        importFolder.prepare(
-            "INSERT INTO folders (guid, name, parent, count, project_guid, date_created, last_updated, visible) "
-            "VALUES (:guid, :name, :parent, :count, :project_guid, :date_created, :last_updated, :visible)"
-        );
+        if (!imported) break;
 
         auto newFolderGuid = GUIDManager::generateGUID();
         importFolder.bindValue(":guid", newFolderGuid);
@@ -2778,11 +3296,13 @@ bool Database::importProject(const QString &inFilePath, const QString &newSceneG
         importFolder.bindValue(":last_updated", folder.lastUpdated);
         importFolder.bindValue(":visible", folder.visible);
 
-        executeAndCheckQuery(importFolder, "importFolder");
+        imported &= executeAndCheckQuery(importFolder, "importFolder");
     }
 
     dbe.close();
 
+    if (!endTransaction(inTransaction, imported, "Project import")) return false;
+
     return true;
 }
 
@@ -2880,17 +3400,7 @@ QString Database::importAsset(
             asset.type == static_cast<int>(ModelTypes::Sky) ||
             asset.type == static_cast<int>(ModelTypes::Object))
         {
-            auto doc = QJsonDocument::fromBinaryData(asset.asset);
-            QString docToString = doc.toJson(QJsonDocument::Compact);
-
-            QMapIterator<QString, QString> i(assetGuids);
-            while (i.hasNext()) {
-                i.next();
-                docToString.replace(i.key(), i.value());
-            }
-
-            QJsonDocument updatedDoc = QJsonDocument::fromJson(docToString.toUtf8());
-            asset.asset = updatedDoc.toBinaryData();
+            asset.asset = GUIDManager::remapGuidsInBinaryJson(asset.asset, assetGuids);
         }
     }
 
@@ -2917,15 +3427,23 @@ QString Database::importAsset(
 		if (!data.depender.isEmpty()) depsToImport.push_back(data);
 	}
 
+	const bool inTransaction = beginTransaction("Asset import");
+	bool imported = true;
+
+	QSqlQuery insertAssetQuery(db);
+	insertAssetQuery.prepare(
+		"INSERT INTO assets"
+		" (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
+		" license, hash, version, parent, tags, properties, view_filter)"
+		" VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
+		" :license, :hash, :version, :parent, :tags, :properties, :view_filter)"
+	);
+
+	QSqlQuery insertPayloadQuery(db);
+	insertPayloadQuery.prepare(assetPayloadInsertQuery);
+
 	for (const auto &asset : assetsToImport) {
-		QSqlQuery insertAssetQuery;
-		insertAssetQuery.prepare(
-			"INSERT INTO assets"
-			" (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
-			" license, hash, version, parent, tags, properties, asset, thumbnail, view_filter)"
-			" VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
-			" :license, :hash, :version, :parent, :tags, :properties, :asset, :thumbnail, :view_filter)"
-		);
+		if (!imported) break;
 
         if (jafType == ModelTypes::Texture) {
             guidToReturn = asset.guid;
@@ -2946,32 +3464,44 @@ QString Database::importAsset(
 		insertAssetQuery.bindValue(":parent", asset.parent);
 		insertAssetQuery.bindValue(":tags", asset.tags);
 		insertAssetQuery.bindValue(":properties", asset.properties);
-		insertAssetQuery.bindValue(":asset", asset.asset);
-		insertAssetQuery.bindValue(":thumbnail", asset.thumbnail);
 		insertAssetQuery.bindValue(":view_filter", asset.view_filter);
 
-		executeAndCheckQuery(insertAssetQuery, "insertAssetQuery");
+		imported &= executeAndCheckQuery(insertAssetQuery, "insertAssetQuery");
+		if (!asset.tags.isEmpty()) updateSearchTags(asset.guid, asset.tags);
+
+		insertPayloadQuery.bindValue(":guid", asset.guid);
+		insertPayloadQuery.bindValue(":thumbnail", asset.thumbnail);
+		insertPayloadQuery.bindValue(":asset", asset.asset);
+		imported &= executeAndCheckQuery(insertPayloadQuery, "insertPayloadQuery");
 	}
 
+    QSqlQuery importDep(db);
+    importDep.prepare(
+        "INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
+        "VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
+    );
+
 	for (const auto &dep : depsToImport) {
-        QSqlQuery importDep;
-        importDep.prepare(
-            "INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
-            "VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
-        );
+		if (!imported) break;
+
         importDep.bindValue(":depender_type",   dep.dependerType);
         importDep.bindValue(":dependee_type",   dep.dependeeType);
         importDep.bindValue(":project_guid",    dep.projectGuid);
         importDep.bindValue(":depender",        dep.depender);
         importDep.bindValue(":dependee",        dep.dependee);
         importDep.bindValue(":id",              dep.id);
-		executeAndCheckQuery(importDep, "ImportDep");
+		imported &= executeAndCheckQuery(importDep, "ImportDep");
 	}
 
     importConnection.close();
     importConnection = QSqlDatabase();
     QSqlDatabase::removeDatabase("NodeImportConnection");
 
+	if (!endTransaction(inTransaction, imported, "Asset import")) {
+		assetRecords.clear();
+		return QString();
+	}
+
 	return guidToReturn;
 }
 
@@ -3061,17 +3591,7 @@ QString Database::importAssetBundle(const QString & pathToDb, const QMap<QString
             asset.type == static_cast<int>(ModelTypes::Material) ||
             asset.type == static_cast<int>(ModelTypes::Object))
         {
-            auto doc = QJsonDocument::fromBinaryData(asset.asset);
-            QString docToString = doc.toJson(QJsonDocument::Compact);
-
-            QMapIterator<QString, QString> i(assetGuids);
-            while (i.hasNext()) {
-                i.next();
-                docToString.replace(i.key(), i.value());
-            }
-
-            QJsonDocument updatedDoc = QJsonDocument::fromJson(docToString.toUtf8());
-            asset.asset = updatedDoc.toBinaryData();
+            asset.asset = GUIDManager::remapGuidsInBinaryJson(asset.asset, assetGuids);
         }
     }
 
@@ -3097,15 +3617,23 @@ QString Database::importAssetBundle(const QString & pathToDb, const QMap<QString
         depsToImport.push_back(data);
     }
 
+    const bool inTransaction = beginTransaction("Asset bundle import");
+    bool imported = true;
+
+    QSqlQuery insertAssetQuery(db);
+    insertAssetQuery.prepare(
+        "INSERT INTO assets"
+        " (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
+        " license, hash, version, parent, tags, properties, view_filter)"
+        " VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
+        " :license, :hash, :version, :parent, :tags, :properties, :view_filter)"
+    );
+
+    QSqlQuery insertPayloadQuery(db);
+    insertPayloadQuery.prepare(assetPayloadInsertQuery);
+
     for (const auto &asset : assetsToImport) {
-        QSqlQuery insertAssetQuery;
-        insertAssetQuery.prepare(
-            "INSERT INTO assets"
-            " (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
-            " license, hash, version, parent, tags, properties, asset, thumbnail, view_filter)"
-            " VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
-            " :license, :hash, :version, :parent, :tags, :properties, :asset, :thumbnail, :view_filter)"
-        );
+        if (!imported) break;
 
         //if (jafType == ModelTypes::Texture) {
         //    guidToReturn = asset.guid;
@@ -3126,32 +3654,44 @@ QString Database::importAssetBundle(const QString & pathToDb, const QMap<QString
         insertAssetQuery.bindValue(":parent", asset.parent);
         insertAssetQuery.bindValue(":tags", asset.tags);
         insertAssetQuery.bindValue(":properties", asset.properties);
-        insertAssetQuery.bindValue(":asset", asset.asset);
-        insertAssetQuery.bindValue(":thumbnail", asset.thumbnail);
         insertAssetQuery.bindValue(":view_filter", asset.view_filter);
 
-        executeAndCheckQuery(insertAssetQuery, "insertAssetQuery");
+        imported &= executeAndCheckQuery(insertAssetQuery, "insertAssetQuery");
+        if (!asset.tags.isEmpty()) updateSearchTags(asset.guid, asset.tags);
+
+        insertPayloadQuery.bindValue(":guid", asset.guid);
+        insertPayloadQuery.bindValue(":thumbnail", asset.thumbnail);
+        insertPayloadQuery.bindValue(":asset", asset.asset);
+        imported &= executeAndCheckQuery(insertPayloadQuery, "insertPayloadQuery");
     }
 
+    QSqlQuery importDep(db);
+    importDep.prepare(
+        "INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
+        "VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
+    );
+
     for (const auto &dep : depsToImport) {
-        QSqlQuery importDep;
-        importDep.prepare(
-            "INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
-            "VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
-        );
+        if (!imported) break;
+
         importDep.bindValue(":depender_type", dep.dependerType);
         importDep.bindValue(":dependee_type", dep.dependeeType);
         importDep.bindValue(":project_guid", dep.projectGuid);
         importDep.bindValue(":depender", dep.depender);
         importDep.bindValue(":dependee", dep.dependee);
         importDep.bindValue(":id", dep.id);
-        executeAndCheckQuery(importDep, "ImportDep");
+        imported &= executeAndCheckQuery(importDep, "ImportDep");
     }
 
     importConnection.close();
     importConnection = QSqlDatabase();
     QSqlDatabase::removeDatabase("NodeImportConnection");
 
+    if (!endTransaction(inTransaction, imported, "Asset bundle import")) {
+        assetRecords.clear();
+        return QString();
+    }
+
     return guidToReturn;
 }
 
@@ -3170,10 +3710,11 @@ QString Database::copyAsset(
     QStringList fullAssetList = AssetHelper::fetchAssetAndAllDependencies(guid, this);
 
     for (const auto &asset : fullAssetList) {
-        QSqlQuery selectAssetQuery;
+        QSqlQuery selectAssetQuery(db);
         selectAssetQuery.prepare(
-            "SELECT guid, type, name, collection, times_used, project_guid, date_created, last_updated, author, "
-            "license, hash, version, parent, tags, properties, asset, thumbnail FROM assets WHERE guid = ?"
+            "SELECT A.guid, A.type, A.name, A.collection, A.times_used, A.project_guid, A.date_created, A.last_updated, "
+            "A.author, A.license, A.hash, A.version, A.parent, A.tags, A.properties, P.asset, P.thumbnail "
+            "FROM assets A LEFT JOIN asset_payloads P ON P.guid = A.guid WHERE A.guid = ?"
         );
         selectAssetQuery.addBindValue(asset);
         executeAndCheckQuery(selectAssetQuery, "fetchImportAssets");
@@ -3228,31 +3769,30 @@ QString Database::copyAsset(
 			asset.type == static_cast<int>(ModelTypes::Material) ||
 			asset.type == static_cast<int>(ModelTypes::Shader))
         {
-            auto doc = QJsonDocument::fromBinaryData(asset.asset);
-            QString docToString = doc.toJson(QJsonDocument::Compact);
-
-            QMapIterator<QString, QString> i(assetGuids);
-            while (i.hasNext()) {
-                i.next();
-                docToString.replace(i.key(), i.value());
-            }
-
-            QJsonDocument updatedDoc = QJsonDocument::fromJson(docToString.toUtf8());
-            asset.asset = updatedDoc.toBinaryData();
+            asset.asset = GUIDManager::remapGuidsInBinaryJson(asset.asset, assetGuids);
         }
     }
 
 	oldAssetRecords = assetsToImport;
 
+    const bool inTransaction = beginTransaction("Asset copy");
+    bool copied = true;
+
+    QSqlQuery insertAssetQuery(db);
+    insertAssetQuery.prepare(
+        "INSERT INTO assets"
+        " (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
+        " license, hash, version, parent, tags, properties, view_filter)"
+        " VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
+        " :license, :hash, :version, :parent, :tags, :properties, :view_filter)"
+    );
+
+    QSqlQuery insertPayloadQuery(db);
+    insertPayloadQuery.prepare(assetPayloadInsertQuery);
+
     for (const auto &asset : assetsToImport) {
-        QSqlQuery insertAssetQuery;
-        insertAssetQuery.prepare(
-            "INSERT INTO assets"
-            " (guid, type, name, collection, times_used, project_guid, date_created, last_updated, author,"
-            " license, hash, version, parent, tags, properties, asset, thumbnail, view_filter)"
-            " VALUES(:guid, :type, :name, :collection, :times_used, :project_guid, :date_created, :last_updated, :author,"
-            " :license, :hash, :version, :parent, :tags, :properties, :asset, :thumbnail, :view_filter)"
-        );
+        if (!copied) break;
+
         insertAssetQuery.bindValue(":guid", asset.guid);
         insertAssetQuery.bindValue(":type", asset.type);
         insertAssetQuery.bindValue(":name", asset.name);
@@ -3268,10 +3808,14 @@ QString Database::copyAsset(
         insertAssetQuery.bindValue(":parent", asset.parent);
         insertAssetQuery.bindValue(":tags", asset.tags);
         insertAssetQuery.bindValue(":properties", asset.properties);
-        insertAssetQuery.bindValue(":asset", asset.asset);
-        insertAssetQuery.bindValue(":thumbnail", asset.thumbnail);
         insertAssetQuery.bindValue(":view_filter", view_filter_to);
-        executeAndCheckQuery(insertAssetQuery, "insertAssetQuery");
+        copied &= executeAndCheckQuery(insertAssetQuery, "insertAssetQuery");
+        if (!asset.tags.isEmpty()) updateSearchTags(asset.guid, asset.tags);
+
+        insertPayloadQuery.bindValue(":guid", asset.guid);
+        insertPayloadQuery.bindValue(":thumbnail", asset.thumbnail);
+        insertPayloadQuery.bindValue(":asset", asset.asset);
+        copied &= executeAndCheckQuery(insertPayloadQuery, "insertPayloadQuery");
     }
 
 	QVector<DependencyRecord> dependenciesToCopy;
@@ -3282,19 +3826,27 @@ QString Database::copyAsset(
 		}
 	}
 
+	QSqlQuery exportDep(db);
+	exportDep.prepare(
+		"INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
+		"VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
+	);
+
     for (const auto &dep : dependenciesToCopy) {
-		QSqlQuery exportDep;
-		exportDep.prepare(
-			"INSERT INTO dependencies (depender_type, dependee_type, project_guid, depender, dependee, id) "
-			"VALUES (:depender_type, :dependee_type, :project_guid, :depender, :dependee, :id)"
-		);
+        if (!copied) break;
+
         exportDep.bindValue(":depender_type", dep.dependerType);
         exportDep.bindValue(":dependee_type", dep.dependeeType);
         exportDep.bindValue(":project_guid", parent);
         exportDep.bindValue(":depender", assetGuids.value(dep.depender));
         exportDep.bindValue(":dependee", assetGuids.value(dep.dependee));
         exportDep.bindValue(":id", GUIDManager::generateGUID());
-        executeAndCheckQuery(exportDep, "CopyDependency");
+        copied &= executeAndCheckQuery(exportDep, "CopyDependency");
+    }
+
+    if (!endTransaction(inTransaction, copied, "Asset copy")) {
+        oldAssetRecords.clear();
+        return QString();
     }
 
     return guidToReturn;
@@ -12,6 +12,7 @@ For more information see the LICENSE file
 #ifndef DATABASE_H
 #define DATABASE_H
 
+#include <QHash>
 #include <QSqlDatabase>
 #include <QSqlDriver>
 #include <QSqlError>
@@ -36,8 +37,17 @@ public:
 
     bool executeAndCheckQuery(QSqlQuery&, const QString&);
 
+    // Batched writes, beginTransaction returns false (and logs) when SQLite won't start one, the
+    // statements then still run but each one is committed on its own and nothing can be rolled back
+    // endTransaction commits when succeeded and rolls back otherwise, returns whether the batch was written
+    bool beginTransaction(const QString &name);
+    bool endTransaction(bool inTransaction, bool succeeded, const QString &name);
+
     // MANAGE ===============================================================================
     bool initializeDatabase(const QString &pathToBlob);
+    // Opens a named connection to an existing database for use on another thread, only that thread may use it
+    bool openReadOnlyConnection(const QString &pathToBlob, const QString &connectionName);
+    QString getDatabasePath() const;
     void closeDatabase();
 
     // CREATE ===============================================================================
@@ -45,11 +55,16 @@ public:
     bool createThumbnailsTable();
     bool createCollectionsTable();
     bool createAssetsTable();
+    bool createAssetPayloadsTable();
     bool createDependenciesTable();
     bool createAuthorTable();
     bool createFoldersTable();
     bool createMetadataTable();
     bool createFavoritesTable();
+    bool createIndexes();
+    // Creates the full text index over assets and its triggers, then fills it from the existing assets
+    bool createSearchIndex();
+    bool rebuildSearchIndex();
     void createAllTables();
 
     // INSERT ===============================================================================
@@ -78,6 +93,8 @@ public:
 							 const QByteArray &properties = QByteArray(),
 							 const AssetViewFilter view_filter = AssetViewFilter::Editor);
 
+    bool createAssetPayload(const QString &guid, const QByteArray &thumbnail, const QByteArray &asset);
+
     bool createDependency(const int &dependerType,
                           const int &dependeeType,
                           const QString &depender,
@@ -110,6 +127,7 @@ public:
     bool updateAssetThumbnail(const QString &guid, const QByteArray &thumbnail);
     bool updateAssetAsset(const QString &guid, const QByteArray &asset);
     bool updateSceneThumbnail(const QString &guid, const QByteArray &asset);
+    bool updateAssetHash(const QString &guid, const QString &hash);
     bool updateAssetMetadata(const QString &guid, const QString &name, const QByteArray &tags);
     bool updateAssetProperties(const QString &guid, const QByteArray &asset);
 	bool updateAssetViewFilter(const QString& guid, const int& filter);
@@ -123,7 +141,14 @@ public:
     QVector<AssetRecord> fetchAssetsFromParent(const QString &guid);
     QVector<AssetRecord> fetchAssetsByCollection(const int &collection_id);
 	QVector<AssetRecord> fetchAssetsByType(const int &type);
+	// Content hash -> asset guid for every asset of the project that was imported with one
+	QHash<QString, QString> fetchAssetHashes(const QString &projectGuid);
 	QVector<AssetRecord> fetchAssetsByViewFilter(const AssetViewFilter& filter);
+	// Full text search over asset names, tags, authors, licenses and types, best matches first
+	// Every word is matched as a prefix and all words have to match, "column:word" limits a word to
+	// one of those columns (type:texture). Pass a negative limit to fetch every match
+	QVector<AssetRecord> searchProjectAssets(const QString &text, const QString &projectGuid, int offset = 0, int limit = -1);
+	QVector<AssetRecord> searchLibraryAssets(const QString &text, int offset = 0, int limit = -1);
     QVector<AssetRecord> fetchFilteredAssets(const QString &guid, const int &type);
     QVector<AssetRecord> fetchThumbnails();
     QVector<AssetRecord> fetchFavorites();
@@ -133,13 +158,22 @@ public:
     QVector<FolderRecord> fetchCrumbTrail(const QString &parent);
     QVector<AssetRecord> fetchAssetThumbnails(const QStringList &guids);
     QByteArray fetchAssetData(const QString &guid) const;
+    // Fetches every asset of the given types in the project with a single query, payloads are only read
+    // for payloadTypes. Uses its own connection so it can run on a worker thread while the GUI keeps the default one
+    QVector<AssetRecord> fetchProjectAssetsConcurrent(const QString &projectGuid,
+                                                      const QVector<int> &types,
+                                                      const QVector<int> &payloadTypes);
+    // Same as updateProject but on its own connection, for saves written from a worker thread
+    bool updateProjectConcurrent(const QString &projectGuid, const QByteArray &sceneBlob, const QByteArray &thumbnail);
 
     QByteArray fetchCachedThumbnail(const QString& name) const;
     QStringList fetchFolderNameByParent(const QString &guid);
     QStringList fetchAssetNameByParent(const QString &guid);
+    // Every folder below guid at any depth followed by guid itself, resolved in a single query
     QStringList fetchFolderAndChildFolders(const QString &guid);
     QStringList fetchChildFolderAssets(const QString &guid);
     QStringList fetchAssetGUIDAndDependencies(const QString &guid, bool appendSelf = true);
+    // guid followed by everything it depends on directly or indirectly, resolved in a single query
     QStringList fetchAssetAndAllDependencies(const QString &guid);
     QVector<DependencyRecord> fetchAssetDependencies(const AssetRecord &record);
     QStringList fetchAssetDependeesByType(const QString &guid, const ModelTypes&);
@@ -184,6 +218,9 @@ public:
 
     int getTableCount();
     bool checkIfTableExists(const QString &tableName);
+    bool checkIfIndexExists(const QString &indexName);
+    bool checkIfColumnExists(const QString &tableName, const QString &columnName);
+    bool schemaNeedsUpdating();
 
     QString getVersion();
 
@@ -211,18 +248,33 @@ public:
     QSqlDatabase getDb() { return db; }
 
 private:
+    bool updateSearchTags(const QString &guid, const QByteArray &tags);
+    QVector<AssetRecord> searchAssets(const QString &text,
+                                      const QString &filter,
+                                      const QVariant &filterValue,
+                                      int offset,
+                                      int limit);
+    static QString buildSearchExpression(const QString &text);
+
     QString projectsTableSchema;
     QString thumbnailsTableSchema;
     QString collectionsTableSchema;
     QString assetsTableSchema;
+    QString assetPayloadsTableSchema;
+    QString assetPayloadInsertQuery;
     QString dependenciesTableSchema;
     QString authorTableSchema;
     QString foldersTableSchema;
     QString metadataTableSchema;
     QString favoritesTableSchema;
+    QString assetsSearchTableSchema;
+    QStringList assetsSearchTriggers;
+    QString assetsSearchPopulateQuery;
+    bool searchIndexAvailable;
 
 	QString version080SchemaUpdate;
 	QString version080SchemaDowngrade;
+	QStringList version081PayloadsUpdate;
 
     QSqlDatabase db;
 };
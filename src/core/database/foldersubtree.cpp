@@ -0,0 +1,168 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "foldersubtree.h"
+
+#include <QHash>
+#include <QSet>
+#include <QSqlError>
+
+#include "irisgl/src/core/logger.h"
+
+// UNION rather than UNION ALL so a parent cycle can't make the walk endless
+const QString FolderSubtree::subtreeQuery =
+    "WITH RECURSIVE subtree(guid) AS ("
+    "    SELECT ?"
+    "    UNION"
+    "    SELECT F.guid FROM folders F INNER JOIN subtree S ON F.parent = S.guid"
+    ") ";
+
+const QString FolderSubtree::assetsQuery =
+    "SELECT A.guid FROM assets A INNER JOIN subtree S ON A.parent = S.guid";
+
+FolderSubtree::Deletion FolderSubtree::remove(QSqlDatabase &db, const QString &rootGuid)
+{
+    Deletion deletion;
+    deletion.deleted = false;
+
+    QSqlQuery assetsInSubtree(db);
+    assetsInSubtree.prepare(subtreeQuery + "SELECT A.guid, A.name FROM assets A INNER JOIN subtree S ON A.parent = S.guid");
+    assetsInSubtree.addBindValue(rootGuid);
+    if (!exec(assetsInSubtree, "FetchFolderSubtreeAssets")) return deletion;
+
+    QHash<QString, QString> names;
+    QSet<QString> removed;
+    while (assetsInSubtree.next()) {
+        names.insert(assetsInSubtree.value(0).toString(), assetsInSubtree.value(1).toString());
+        removed.insert(assetsInSubtree.value(0).toString());
+    }
+
+    // Every depender of the subtree's assets and of whatever those assets depend on
+    QSqlQuery edgesQuery(db);
+    edgesQuery.prepare(
+        subtreeQuery +
+        "SELECT D.dependee, D.depender, A.name FROM dependencies D "
+        "LEFT JOIN assets A ON A.guid = D.dependee "
+        "WHERE D.dependee IN (" + assetsQuery + ") "
+        "OR D.dependee IN (SELECT dependee FROM dependencies WHERE depender IN (" + assetsQuery + "))"
+    );
+    edgesQuery.addBindValue(rootGuid);
+    if (!exec(edgesQuery, "FetchFolderSubtreeDependencies")) return deletion;
+
+    QHash<QString, QSet<QString>> dependers;
+    while (edgesQuery.next()) {
+        const QString dependee = edgesQuery.value(0).toString();
+        dependers[dependee].insert(edgesQuery.value(1).toString());
+        if (!names.contains(dependee)) names.insert(dependee, edgesQuery.value(2).toString());
+    }
+
+    // An asset used by anything that stays has to stay as well, which can in turn keep what it depends on
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = removed.begin(); it != removed.end();) {
+            bool usedOutside = false;
+            for (const QString &depender : dependers.value(*it)) {
+                if (!removed.contains(depender)) {
+                    usedOutside = true;
+                    break;
+                }
+            }
+
+            if (usedOutside) {
+                deletion.keptAssets.append(*it);
+                it = removed.erase(it);
+                changed = true;
+            }
+            else ++it;
+        }
+    }
+
+    // Files of the removed assets and of dependees elsewhere that only removed assets used
+    for (const QString &asset : removed) deletion.files.append(names.value(asset));
+    for (auto it = dependers.constBegin(); it != dependers.constEnd(); ++it) {
+        if (removed.contains(it.key()) || deletion.keptAssets.contains(it.key())) continue;
+
+        bool onlyRemoved = true;
+        for (const QString &depender : it.value()) onlyRemoved &= removed.contains(depender);
+        if (onlyRemoved) deletion.files.append(names.value(it.key()));
+    }
+
+    if (!db.transaction()) {
+        irisLog("Couldn't start a transaction to delete folder " + rootGuid + ", nothing was deleted " + db.lastError().text());
+        deletion.files.clear();
+        deletion.keptAssets.clear();
+        return deletion;
+    }
+
+    QSqlQuery payloadQuery(db);
+    payloadQuery.prepare("DELETE FROM asset_payloads WHERE guid = ?");
+    QSqlQuery dependenciesQuery(db);
+    dependenciesQuery.prepare("DELETE FROM dependencies WHERE depender = ?");
+    QSqlQuery assetQuery(db);
+    assetQuery.prepare("DELETE FROM assets WHERE guid = ?");
+
+    bool deleted = true;
+    for (const QString &asset : removed) {
+        payloadQuery.addBindValue(asset);
+        dependenciesQuery.addBindValue(asset);
+        assetQuery.addBindValue(asset);
+        deleted &= exec(payloadQuery, "DeleteFolderSubtreePayload");
+        deleted &= exec(dependenciesQuery, "DeleteFolderSubtreeDependencies");
+        deleted &= exec(assetQuery, "DeleteFolderSubtreeAsset");
+        deletion.removedAssets.append(asset);
+    }
+
+    // Kept assets would otherwise sit in a folder that no longer exists
+    if (!deletion.keptAssets.isEmpty()) {
+        QSqlQuery parentQuery(db);
+        parentQuery.prepare("SELECT parent FROM folders WHERE guid = ?");
+        parentQuery.addBindValue(rootGuid);
+        deleted &= exec(parentQuery, "FetchFolderParent");
+        const QString parent = parentQuery.first() ? parentQuery.value(0).toString() : QString();
+
+        QSqlQuery moveQuery(db);
+        moveQuery.prepare("UPDATE assets SET parent = ? WHERE guid = ?");
+        for (const QString &asset : deletion.keptAssets) {
+            if (parent.isEmpty()) break;
+            moveQuery.addBindValue(parent);
+            moveQuery.addBindValue(asset);
+            deleted &= exec(moveQuery, "MoveKeptAsset");
+        }
+    }
+
+    QSqlQuery foldersQuery(db);
+    foldersQuery.prepare(subtreeQuery + "DELETE FROM folders WHERE guid IN (SELECT guid FROM subtree)");
+    foldersQuery.addBindValue(rootGuid);
+    deleted &= exec(foldersQuery, "DeleteFolderSubtree");
+
+    if (!deleted || !db.commit()) {
+        db.rollback();
+        irisLog("Deleting folder " + rootGuid + " was rolled back");
+        deletion.files.clear();
+        deletion.removedAssets.clear();
+        deletion.keptAssets.clear();
+        return deletion;
+    }
+
+    deletion.deleted = true;
+    return deletion;
+}
+
+bool FolderSubtree::exec(QSqlQuery &query, const QString &name)
+{
+    if (!query.exec()) {
+        irisLog(QString("%1 query failed to execute! %2").arg(name, query.lastError().text()));
+        return false;
+    }
+
+    return true;
+}
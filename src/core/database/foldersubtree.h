@@ -0,0 +1,50 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef FOLDERSUBTREE_H
+#define FOLDERSUBTREE_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Queries over a folder and every folder below it
+ * Only needs a connection and the folders, assets, asset_payloads and dependencies tables so it can be used
+ * (and tested) without the rest of Database
+ */
+class FolderSubtree
+{
+public:
+    struct Deletion
+    {
+        bool deleted;
+        QStringList files;          // file names nothing left in the database refers to
+        QStringList removedAssets;
+        QStringList keptAssets;     // still depended on from outside, moved up to the root's parent folder
+    };
+
+    // Recursive CTE named subtree, binds the root folder's guid as its only parameter
+    static const QString subtreeQuery;
+    // Assets directly inside any folder of the subtree, goes after subtreeQuery
+    static const QString assetsQuery;
+
+    // Deletes the folders of the subtree and the assets inside them in one transaction
+    // Deduplicated imports let assets in other folders depend on an asset in the subtree, those assets (and
+    // whatever they depend on in turn) are kept along with their files instead of being left dangling
+    static Deletion remove(QSqlDatabase &db, const QString &rootGuid);
+
+private:
+    static bool exec(QSqlQuery &query, const QString &name);
+};
+
+#endif // FOLDERSUBTREE_H
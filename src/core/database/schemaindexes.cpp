@@ -0,0 +1,31 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+
+#include "schemaindexes.h"
+
+// Secondary indexes for the hot lookups, the asset browser and folder views filter on these
+// columns on every click so without them each fetch is a full table scan
+const QStringList SchemaIndexes::statements = {
+    "CREATE INDEX IF NOT EXISTS assets_parent_idx ON assets (parent, project_guid, name)",
+    "CREATE INDEX IF NOT EXISTS assets_project_type_idx ON assets (project_guid, type)",
+    "CREATE INDEX IF NOT EXISTS assets_view_filter_idx ON assets (view_filter, name)",
+    "CREATE INDEX IF NOT EXISTS assets_hash_idx ON assets (project_guid, hash)",
+    "CREATE INDEX IF NOT EXISTS dependencies_depender_idx ON dependencies (depender, dependee_type, dependee)",
+    "CREATE INDEX IF NOT EXISTS dependencies_dependee_idx ON dependencies (dependee, depender_type, depender)",
+    "CREATE INDEX IF NOT EXISTS dependencies_project_idx ON dependencies (project_guid)",
+    "CREATE INDEX IF NOT EXISTS folders_parent_idx ON folders (parent, project_guid)"
+};
+
+QString SchemaIndexes::nameOf(const QString &statement)
+{
+    return statement.section(' ', 5, 5);
+}
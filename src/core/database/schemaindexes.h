@@ -0,0 +1,32 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+
+#ifndef SCHEMAINDEXES_H
+#define SCHEMAINDEXES_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * Secondary indexes of the asset database
+ * Kept apart from Database so the query benchmarks can build the same indexes on a bare connection
+ */
+class SchemaIndexes
+{
+public:
+    // "CREATE INDEX IF NOT EXISTS <name> ON ..." statements, safe to run against any schema
+    static const QStringList statements;
+
+    static QString nameOf(const QString &statement);
+};
+
+#endif // SCHEMAINDEXES_H
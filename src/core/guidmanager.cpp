@@ -11,7 +11,76 @@ For more information see the LICENSE file
 
 #include "guidmanager.h"
 
+#include <QJsonDocument>
+
 GUIDManager::GUIDManager()
 {
 
 }
+
+bool GUIDManager::isGuidAt(const QChar *data, int length, int index)
+{
+    static const int guidLength = 36;
+    if (index + guidLength > length) return false;
+
+    for (int i = 0; i < guidLength; ++i) {
+        const ushort c = data[index + i].unicode();
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (c != '-') return false;
+        }
+        else if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QString GUIDManager::remapGuids(const QString &text, const QMap<QString, QString> &guidMap)
+{
+    if (guidMap.isEmpty()) return text;
+
+    static const int guidLength = 36;
+    const QChar *data = text.constData();
+    const int length = text.length();
+
+    QString result;
+    result.reserve(length);
+
+    int copyFrom = 0;
+    int index = 0;
+    while (index + guidLength <= length) {
+        // Cheap rejection on the first dash before checking the whole token
+        if (data[index + 8] != QLatin1Char('-') || !isGuidAt(data, length, index)) {
+            index++;
+            continue;
+        }
+
+        auto it = guidMap.constFind(QString::fromRawData(data + index, guidLength));
+        if (it != guidMap.constEnd()) {
+            result.append(data + copyFrom, index - copyFrom);
+            result.append(it.value());
+            copyFrom = index + guidLength;
+        }
+
+        index += guidLength;
+    }
+
+    if (copyFrom == 0) return text;
+
+    result.append(data + copyFrom, length - copyFrom);
+    return result;
+}
+
+QByteArray GUIDManager::remapGuidsInBinaryJson(const QByteArray &blob, const QMap<QString, QString> &guidMap)
+{
+    if (guidMap.isEmpty()) return blob;
+
+    const QString docToString = QJsonDocument::fromBinaryData(blob).toJson(QJsonDocument::Compact);
+    const QString remapped = remapGuids(docToString, guidMap);
+
+    // Nothing referenced an imported guid, keep the original blob
+    if (remapped.constData() == docToString.constData()) return blob;
+
+    return QJsonDocument::fromJson(remapped.toUtf8()).toBinaryData();
+}
@@ -12,6 +12,7 @@ For more information see the LICENSE file
 #ifndef GUIDMANAGER_H
 #define GUIDMANAGER_H
 
+#include <QMap>
 #include <QUuid>
 
 class GUIDManager
@@ -25,6 +26,17 @@ public:
         guid.chop(1);
         return guid;
     }
+
+    // Rewrites every guid in text that has an entry in guidMap in a single pass
+    // Guids are matched by shape (36 chars, 8-4-4-4-12 hex digits) so the cost
+    // doesn't grow with the number of entries in the map
+    static QString remapGuids(const QString &text, const QMap<QString, QString> &guidMap);
+
+    // Convenience wrapper for the binary json blobs we store in the database
+    static QByteArray remapGuidsInBinaryJson(const QByteArray &blob, const QMap<QString, QString> &guidMap);
+
+private:
+    static bool isGuidAt(const QChar *data, int length, int index);
 };
 
 #endif // GUIDMANAGER_H
@@ -0,0 +1,147 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "meshcache.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "assimp/Exporter.hpp"
+#include "assimp/Importer.hpp"
+#include "assimp/postprocess.h"
+#include "assimp/scene.h"
+#include "assimp/version.h"
+
+#include <irisgl/IrisGL.h>
+#include "../helpers/hashhelper.h"
+
+namespace
+{
+    const quint32 cacheMagic = 0x4A4D5348;  // JMSH
+    // Bump whenever the header or payload layout changes, it's part of the entry name as well
+    const quint32 cacheVersion = 1;
+    const int headerSize = 24;
+    const char *cacheFormat = "assbin";
+}
+
+const unsigned int MeshCache::importFlags = aiProcessPreset_TargetRealtime_Fast;
+
+const aiScene *MeshCache::loadScene(Assimp::Importer *importer, const QString &filePath)
+{
+    const QByteArray sourceHash = HashHelper::hashFile(filePath);
+    if (sourceHash.isEmpty()) return nullptr;
+
+    const QString entryPath = getEntryPath(sourceHash, importFlags);
+    if (QFile::exists(entryPath)) {
+        if (auto scene = readEntry(importer, entryPath)) return scene;
+
+        // Written by an older build or truncated, rebuild it from the source
+        irisLog(QString("Discarding stale mesh cache entry for %1").arg(filePath));
+        QFile::remove(entryPath);
+    }
+
+    auto scene = importer->ReadFile(filePath.toStdString().c_str(), importFlags);
+    if (scene) writeEntry(scene, entryPath);
+
+    return scene;
+}
+
+bool MeshCache::storeScene(const aiScene *scene, const QString &filePath, unsigned int flags)
+{
+    if (!scene) return false;
+
+    const QByteArray sourceHash = HashHelper::hashFile(filePath);
+    if (sourceHash.isEmpty()) return false;
+
+    const QString entryPath = getEntryPath(sourceHash, flags);
+    if (QFile::exists(entryPath)) return true;
+
+    return writeEntry(scene, entryPath);
+}
+
+QString MeshCache::getCacheFolder()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("MeshCache");
+}
+
+QString MeshCache::getEntryPath(const QByteArray &sourceHash, unsigned int flags)
+{
+    // The same file processed with other flags is a different scene
+    const QString entryName = QString("%1_%2_v%3.jmc")
+        .arg(QString::fromLatin1(sourceHash))
+        .arg(flags, 8, 16, QChar('0'))
+        .arg(cacheVersion);
+    return QDir(getCacheFolder()).filePath(entryName);
+}
+
+const aiScene *MeshCache::readEntry(Assimp::Importer *importer, const QString &entryPath)
+{
+    QFile file(entryPath);
+    if (!file.open(QFile::ReadOnly) || file.size() <= headerSize) return nullptr;
+
+    // Map the entry instead of reading it, Assimp parses straight out of the mapping
+    const uchar *data = file.map(0, file.size());
+    if (!data) return nullptr;
+
+    quint32 magic, version, assimpMajor, assimpMinor;
+    quint64 payloadSize;
+
+    QDataStream header(QByteArray::fromRawData(reinterpret_cast<const char*>(data), headerSize));
+    header >> magic >> version >> assimpMajor >> assimpMinor >> payloadSize;
+
+    const aiScene *scene = nullptr;
+
+    // The binary dump is only guaranteed to be readable by the Assimp version that wrote it
+    if (magic == cacheMagic &&
+        version == cacheVersion &&
+        assimpMajor == aiGetVersionMajor() &&
+        assimpMinor == aiGetVersionMinor() &&
+        payloadSize == quint64(file.size() - headerSize))
+    {
+        scene = importer->ReadFileFromMemory(data + headerSize, payloadSize, 0, cacheFormat);
+    }
+
+    file.unmap(const_cast<uchar*>(data));
+    return scene;
+}
+
+bool MeshCache::writeEntry(const aiScene *scene, const QString &entryPath)
+{
+    Assimp::Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(scene, cacheFormat);
+    if (!blob) {
+        irisLog(QString("Couldn't serialize mesh cache entry! %1").arg(exporter.GetErrorString()));
+        return false;
+    }
+
+    if (!QDir().mkpath(QFileInfo(entryPath).absolutePath())) return false;
+
+    QByteArray header;
+    QDataStream stream(&header, QIODevice::WriteOnly);
+    stream << cacheMagic
+           << cacheVersion
+           << quint32(aiGetVersionMajor())
+           << quint32(aiGetVersionMinor())
+           << quint64(blob->size);
+
+    // Projects are opened on several threads, QSaveFile keeps a reader from seeing a partial entry
+    QSaveFile file(entryPath);
+    if (!file.open(QFile::WriteOnly)) return false;
+
+    file.write(header);
+    file.write(static_cast<const char*>(blob->data), blob->size);
+
+    return file.commit();
+}
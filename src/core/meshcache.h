@@ -0,0 +1,57 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+struct aiScene;
+
+namespace Assimp
+{
+    class Importer;
+}
+
+/**
+ * On-disk cache of post-processed model files
+ * Entries hold the scene Assimp produced (vertex and index buffers, bone weights, node hierarchy and
+ * animation tracks) in Assimp's binary format behind a small versioned header. They're keyed by a hash
+ * of the source file's contents so renamed or copied files still hit and edited files simply miss, along
+ * with the post-process flags and format version so scenes processed differently never get mixed up
+ * Entries are shared between projects and live in the user's cache location
+ */
+class MeshCache
+{
+public:
+    // Returns the scene for filePath, reading the cached entry when there's a valid one and
+    // falling back to a full Assimp import otherwise (which then writes the entry)
+    // The scene is owned by the importer, nullptr is returned when the file can't be imported either
+    // Safe to call from worker threads as long as each call uses its own importer
+    static const aiScene *loadScene(Assimp::Importer *importer, const QString &filePath);
+
+    // Writes the entry for filePath from a scene that was already imported, used at import time
+    // flags are the post-process flags the scene was imported with
+    static bool storeScene(const aiScene *scene, const QString &filePath, unsigned int flags = importFlags);
+
+    static QString getCacheFolder();
+
+    // Flags used when the cache has to fall back to the source file
+    static const unsigned int importFlags;
+
+private:
+    static QString getEntryPath(const QByteArray &sourceHash, unsigned int flags);
+    static const aiScene *readEntry(Assimp::Importer *importer, const QString &entryPath);
+    static bool writeEntry(const aiScene *scene, const QString &entryPath);
+};
+
+#endif // MESHCACHE_H
@@ -0,0 +1,113 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "programcache.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QOpenGLShaderProgram>
+
+#include "irisgl/src/core/logger.h"
+
+QOpenGLShaderProgram *ProgramCache::load(const QString &vertexPath,
+                                         const QString &fragmentPath,
+                                         const QStringList &defines)
+{
+    QFile vertexFile(vertexPath);
+    QFile fragmentFile(fragmentPath);
+    if (!vertexFile.open(QFile::ReadOnly) || !fragmentFile.open(QFile::ReadOnly)) {
+        irisLog(QString("Couldn't read the shaders %1 and %2").arg(vertexPath, fragmentPath));
+        return nullptr;
+    }
+
+    return fromSource(vertexFile.readAll(), fragmentFile.readAll(), defines);
+}
+
+QOpenGLShaderProgram *ProgramCache::fromSource(const QByteArray &vertexSource,
+                                               const QByteArray &fragmentSource,
+                                               const QStringList &defines)
+{
+    const QByteArray vertex = addDefines(vertexSource, defines);
+    const QByteArray fragment = addDefines(fragmentSource, defines);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(vertex);
+    hash.addData("\0", 1);
+    hash.addData(fragment);
+    const QByteArray key = hash.result();
+
+    auto iter = programs.constFind(key);
+    if (iter != programs.constEnd()) {
+        hits++;
+        return iter.value();
+    }
+
+    misses++;
+
+    // Cacheable shaders are what Qt keeps program binaries on disk for, it compiles from source
+    // whenever there's no binary yet or the driver refuses the one it has
+    auto program = new QOpenGLShaderProgram;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    program->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, vertex);
+    program->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, fragment);
+#else
+    program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertex);
+    program->addShaderFromSourceCode(QOpenGLShader::Fragment, fragment);
+#endif
+
+    if (!program->link()) {
+        irisLog("Couldn't link program " + program->log());
+        delete program;
+        return nullptr;
+    }
+
+    programs.insert(key, program);
+    return program;
+}
+
+qint64 ProgramCache::getHits()
+{
+    return hits;
+}
+
+qint64 ProgramCache::getMisses()
+{
+    return misses;
+}
+
+void ProgramCache::resetStatistics()
+{
+    hits = 0;
+    misses = 0;
+}
+
+QByteArray ProgramCache::addDefines(const QByteArray &source, const QStringList &defines)
+{
+    if (defines.isEmpty()) return source;
+
+    QByteArray defineBlock;
+    for (const QString &define : defines) defineBlock += "#define " + define.toUtf8() + '\n';
+
+    // Defines have to follow the #version line, which must stay the first statement
+    int insertAt = 0;
+    if (source.trimmed().startsWith("#version")) {
+        insertAt = source.indexOf('\n', source.indexOf("#version"));
+        insertAt = insertAt < 0 ? source.size() : insertAt + 1;
+    }
+
+    QByteArray result = source;
+    result.insert(insertAt, defineBlock);
+    return result;
+}
+
+QHash<QByteArray, QOpenGLShaderProgram*> ProgramCache::programs;
+qint64 ProgramCache::hits = 0;
+qint64 ProgramCache::misses = 0;
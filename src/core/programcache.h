@@ -0,0 +1,54 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class QOpenGLShaderProgram;
+
+/**
+ * Process wide cache of linked GL programs
+ * Programs are keyed by a hash of their final vertex and fragment source and defines, every caller asking for
+ * the same sources shares one program. Linked programs are also written to disk as program binaries by Qt, keyed
+ * by GL_VENDOR, GL_RENDERER, GL_VERSION and a hash of the sources, so later runs skip compiling altogether
+ * A binary the driver rejects (after a driver update for instance) is compiled from source again
+ * Programs are GL objects owned by the cache, callers need a context current that shares with the application's
+ * Only used from the GUI thread
+ */
+class ProgramCache
+{
+public:
+    // Returns nullptr when the files can't be read or the program doesn't compile or link
+    static QOpenGLShaderProgram *load(const QString &vertexPath,
+                                      const QString &fragmentPath,
+                                      const QStringList &defines = QStringList());
+    static QOpenGLShaderProgram *fromSource(const QByteArray &vertexSource,
+                                            const QByteArray &fragmentSource,
+                                            const QStringList &defines = QStringList());
+
+    static qint64 getHits();
+    static qint64 getMisses();
+    static void resetStatistics();
+
+private:
+    static QByteArray addDefines(const QByteArray &source, const QStringList &defines);
+
+    static QHash<QByteArray, QOpenGLShaderProgram*> programs;
+    static qint64 hits;
+    static qint64 misses;
+};
+
+#endif // PROGRAMCACHE_H
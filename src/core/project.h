@@ -141,6 +141,7 @@ enum class ModelTypes
 #define	MODEL_TYPE_ROLE		0x0123
 #define	MODEL_MESH_ROLE		0x0173
 #define SKY_TYPE_ROLE		0x0179
+#define MODEL_THUMBNAIL_ROLE	0x0183
 
 #define MODEL_ITEM_TYPE		0x0981
 #define MODEL_FOLDER		0x0871
@@ -0,0 +1,458 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "scenepicker.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "irisgl/src/geometry/trimesh.h"
+#include "irisgl/src/graphics/mesh.h"
+#include "irisgl/src/scenegraph/scenenode.h"
+#include "irisgl/src/scenegraph/meshnode.h"
+
+namespace
+{
+    const int maxLeafTriangles = 4;
+    const int maxTraversalDepth = 64;
+    const float triangleEpsilon = 1e-7f;
+
+    inline QVector3D componentMin(const QVector3D &a, const QVector3D &b)
+    {
+        return QVector3D(qMin(a.x(), b.x()), qMin(a.y(), b.y()), qMin(a.z(), b.z()));
+    }
+
+    inline QVector3D componentMax(const QVector3D &a, const QVector3D &b)
+    {
+        return QVector3D(qMax(a.x(), b.x()), qMax(a.y(), b.y()), qMax(a.z(), b.z()));
+    }
+
+    inline QVector3D inverseDirection(const QVector3D &dir)
+    {
+        // Division by zero is intended here, the slab test relies on the infinities
+        return QVector3D(1.0f / dir.x(), 1.0f / dir.y(), 1.0f / dir.z());
+    }
+}
+
+TriangleBVH::TriangleBVH(const iris::TriMesh *triMesh)
+{
+    const int count = triMesh->triangles.size();
+    if (count == 0) return;
+
+    QVector<QVector3D> source;
+    QVector<QVector3D> centroids;
+    source.reserve(count * 3);
+    centroids.reserve(count);
+
+    for (const auto &triangle : triMesh->triangles) {
+        source.append(triangle.a);
+        source.append(triangle.b);
+        source.append(triangle.c);
+        centroids.append((triangle.a + triangle.b + triangle.c) / 3.0f);
+    }
+
+    QVector<int> order(count);
+    for (int i = 0; i < count; ++i) order[i] = i;
+
+    // Swap the centroids for the vertices while building, bounds need the actual vertices
+    triangles = source;
+    nodes.reserve(2 * count / maxLeafTriangles + 1);
+    build(order, centroids, 0, count);
+
+    triangles.resize(count * 3);
+    triangleIndices = order;
+    for (int i = 0; i < count; ++i) {
+        triangles[i * 3 + 0] = source[order[i] * 3 + 0];
+        triangles[i * 3 + 1] = source[order[i] * 3 + 1];
+        triangles[i * 3 + 2] = source[order[i] * 3 + 2];
+    }
+}
+
+int TriangleBVH::build(QVector<int> &order, const QVector<QVector3D> &centroids, int first, int count)
+{
+    const int nodeIndex = nodes.size();
+    nodes.append(Node());
+
+    // triangles still holds the source vertices at this point
+    QVector3D boundsMin = triangles[order[first] * 3];
+    QVector3D boundsMax = boundsMin;
+    QVector3D centroidMin = centroids[order[first]];
+    QVector3D centroidMax = centroidMin;
+
+    for (int i = first; i < first + count; ++i) {
+        const int tri = order[i];
+        for (int v = 0; v < 3; ++v) {
+            boundsMin = componentMin(boundsMin, triangles[tri * 3 + v]);
+            boundsMax = componentMax(boundsMax, triangles[tri * 3 + v]);
+        }
+        centroidMin = componentMin(centroidMin, centroids[tri]);
+        centroidMax = componentMax(centroidMax, centroids[tri]);
+    }
+
+    nodes[nodeIndex].boundsMin = boundsMin;
+    nodes[nodeIndex].boundsMax = boundsMax;
+
+    const QVector3D extent = centroidMax - centroidMin;
+    if (count <= maxLeafTriangles || qFuzzyIsNull(qMax(extent.x(), qMax(extent.y(), extent.z())))) {
+        nodes[nodeIndex].first = first;
+        nodes[nodeIndex].count = count;
+        return nodeIndex;
+    }
+
+    // Median split along the longest axis keeps the tree balanced, which bounds the traversal depth
+    int axis = 0;
+    if (extent.y() > extent[axis]) axis = 1;
+    if (extent.z() > extent[axis]) axis = 2;
+
+    const int half = count / 2;
+    std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+                     [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+
+    build(order, centroids, first, half);
+    const int right = build(order, centroids, first + half, count - half);
+
+    nodes[nodeIndex].first = right;
+    nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+bool TriangleBVH::intersectsNode(const Node &node, const QVector3D &origin, const QVector3D &invDir,
+                                 float tMax, float &tEntry) const
+{
+    float tNear = 0.0f;
+    float tFar = tMax;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        float t0 = (node.boundsMin[axis] - origin[axis]) * invDir[axis];
+        float t1 = (node.boundsMax[axis] - origin[axis]) * invDir[axis];
+        if (t0 > t1) std::swap(t0, t1);
+
+        // NaN from 0 * inf (origin on a slab of a flat box) fails both comparisons and leaves the range as is
+        if (t0 > tNear) tNear = t0;
+        if (t1 < tFar) tFar = t1;
+        if (tNear > tFar) return false;
+    }
+
+    tEntry = tNear;
+    return true;
+}
+
+bool TriangleBVH::intersectTriangle(int index, const QVector3D &origin, const QVector3D &dir, float &t) const
+{
+    // Moller-Trumbore, double sided since picking doesn't care about winding
+    const QVector3D &v0 = triangles[index * 3 + 0];
+    const QVector3D edge1 = triangles[index * 3 + 1] - v0;
+    const QVector3D edge2 = triangles[index * 3 + 2] - v0;
+
+    const QVector3D p = QVector3D::crossProduct(dir, edge2);
+    const float det = QVector3D::dotProduct(edge1, p);
+    if (qAbs(det) < triangleEpsilon) return false;
+
+    const float invDet = 1.0f / det;
+    const QVector3D s = origin - v0;
+    const float u = QVector3D::dotProduct(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    const QVector3D q = QVector3D::crossProduct(s, edge1);
+    const float v = QVector3D::dotProduct(dir, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    t = QVector3D::dotProduct(edge2, q) * invDet;
+    return t >= 0.0f && t <= 1.0f;
+}
+
+bool TriangleBVH::segmentEntersBounds(const QVector3D &segStart, const QVector3D &segEnd, float &tEntry) const
+{
+    if (nodes.isEmpty()) return false;
+    return intersectsNode(nodes[0], segStart, inverseDirection(segEnd - segStart), 1.0f, tEntry);
+}
+
+int TriangleBVH::getSegmentIntersections(const QVector3D &segStart,
+                                         const QVector3D &segEnd,
+                                         QList<TriangleHit> &hits) const
+{
+    if (nodes.isEmpty()) return 0;
+
+    const QVector3D dir = segEnd - segStart;
+    const QVector3D invDir = inverseDirection(dir);
+
+    int hitCount = 0;
+    int stack[maxTraversalDepth];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const int nodeIndex = stack[--stackSize];
+        const Node &node = nodes[nodeIndex];
+
+        float tEntry;
+        if (!intersectsNode(node, segStart, invDir, 1.0f, tEntry)) continue;
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                float t;
+                if (intersectTriangle(i, segStart, dir, t)) {
+                    TriangleHit hit;
+                    hit.triangleIndex = triangleIndices[i];
+                    hit.t = t;
+                    hit.hitPoint = segStart + dir * t;
+                    hits.append(hit);
+                    hitCount++;
+                }
+            }
+        }
+        else {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+
+    return hitCount;
+}
+
+bool TriangleBVH::getNearestIntersection(const QVector3D &segStart,
+                                         const QVector3D &segEnd,
+                                         TriangleHit &hit) const
+{
+    return findIntersection(segStart, segEnd, false, hit);
+}
+
+bool TriangleBVH::getAnyIntersection(const QVector3D &segStart,
+                                     const QVector3D &segEnd,
+                                     TriangleHit &hit) const
+{
+    return findIntersection(segStart, segEnd, true, hit);
+}
+
+bool TriangleBVH::findIntersection(const QVector3D &segStart,
+                                   const QVector3D &segEnd,
+                                   bool stopAtFirstHit,
+                                   TriangleHit &hit) const
+{
+    if (nodes.isEmpty()) return false;
+
+    const QVector3D dir = segEnd - segStart;
+    const QVector3D invDir = inverseDirection(dir);
+
+    float bestT = 1.0f;
+    int bestTriangle = -1;
+
+    int stack[maxTraversalDepth];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const int nodeIndex = stack[--stackSize];
+        const Node &node = nodes[nodeIndex];
+
+        float tEntry;
+        if (!intersectsNode(node, segStart, invDir, bestT, tEntry)) continue;
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                float t;
+                if (intersectTriangle(i, segStart, dir, t) && t <= bestT) {
+                    bestT = t;
+                    bestTriangle = i;
+                    if (stopAtFirstHit) break;
+                }
+            }
+
+            if (stopAtFirstHit && bestTriangle >= 0) break;
+            continue;
+        }
+
+        // Visit the nearer child first so the farther one is more likely to be pruned
+        const int left = nodeIndex + 1;
+        const int right = node.first;
+        float tLeft, tRight;
+        const bool hitLeft = intersectsNode(nodes[left], segStart, invDir, bestT, tLeft);
+        const bool hitRight = intersectsNode(nodes[right], segStart, invDir, bestT, tRight);
+
+        if (hitLeft && hitRight) {
+            if (tLeft <= tRight) {
+                stack[stackSize++] = right;
+                stack[stackSize++] = left;
+            }
+            else {
+                stack[stackSize++] = left;
+                stack[stackSize++] = right;
+            }
+        }
+        else if (hitLeft) {
+            stack[stackSize++] = left;
+        }
+        else if (hitRight) {
+            stack[stackSize++] = right;
+        }
+    }
+
+    if (bestTriangle < 0) return false;
+
+    hit.triangleIndex = triangleIndices[bestTriangle];
+    hit.t = bestT;
+    hit.hitPoint = segStart + dir * bestT;
+    return true;
+}
+
+QHash<iris::Mesh*, ScenePicker::CachedBVH> ScenePicker::bvhCache;
+
+QSharedPointer<TriangleBVH> ScenePicker::getTriangleBVH(const iris::MeshPtr &mesh)
+{
+    auto triMesh = mesh->getTriMesh();
+    if (!triMesh) return QSharedPointer<TriangleBVH>();
+
+    auto it = bvhCache.find(mesh.data());
+    if (it != bvhCache.end()) {
+        // The address can be reused by a new mesh once the old one is gone, so check it's still the same one
+        if (!it->mesh.isNull() && it->triMesh == triMesh && it->triangleCount == triMesh->triangles.size()) {
+            return it->bvh;
+        }
+
+        bvhCache.erase(it);
+    }
+
+    // Drop the entries of meshes that were released before growing the cache any further
+    if (bvhCache.size() > 256) {
+        for (auto entry = bvhCache.begin(); entry != bvhCache.end();) {
+            if (entry->mesh.isNull()) entry = bvhCache.erase(entry);
+            else ++entry;
+        }
+    }
+
+    CachedBVH cached;
+    cached.mesh = mesh;
+    cached.triMesh = triMesh;
+    cached.triangleCount = triMesh->triangles.size();
+    cached.bvh = QSharedPointer<TriangleBVH>::create(triMesh);
+    bvhCache.insert(mesh.data(), cached);
+
+    return cached.bvh;
+}
+
+void ScenePicker::clearCache()
+{
+    bvhCache.clear();
+}
+
+void ScenePicker::collectCandidates(const iris::SceneNodePtr &node,
+                                    const QVector3D &segStart,
+                                    const QVector3D &segEnd,
+                                    bool forcePickable,
+                                    QVector<Candidate> &candidates)
+{
+    if (node->getSceneNodeType() == iris::SceneNodeType::Mesh && (node->isPickable() || forcePickable)) {
+        auto meshNode = node.staticCast<iris::MeshNode>();
+        auto mesh = meshNode->getMesh();
+        if (mesh != nullptr) {
+            auto bvh = getTriangleBVH(mesh);
+            if (!!bvh && !bvh->isEmpty()) {
+                // Test in mesh space so the root bounds act as an oriented box around the node
+                auto invTransform = meshNode->globalTransform.inverted();
+
+                Candidate candidate;
+                candidate.localStart = invTransform * segStart;
+                candidate.localEnd = invTransform * segEnd;
+
+                if (bvh->segmentEntersBounds(candidate.localStart, candidate.localEnd, candidate.tEntry)) {
+                    candidate.node = meshNode;
+                    candidate.bvh = bvh;
+                    candidates.append(candidate);
+                }
+            }
+        }
+    }
+
+    for (auto child : node->children) {
+        collectCandidates(child, segStart, segEnd, forcePickable, candidates);
+    }
+}
+
+iris::PickingResult ScenePicker::makeResult(const Candidate &candidate,
+                                            const TriangleHit &hit,
+                                            const QVector3D &segStart)
+{
+    iris::PickingResult pick;
+    pick.hitNode = candidate.node;
+    pick.hitPoint = candidate.node->globalTransform * hit.hitPoint;
+    pick.distanceFromStartSqrd = (pick.hitPoint - segStart).lengthSquared();
+    return pick;
+}
+
+void ScenePicker::pickMeshes(const iris::SceneNodePtr &root,
+                             const QVector3D &segStart,
+                             const QVector3D &segEnd,
+                             QList<iris::PickingResult> &hits,
+                             bool forcePickable)
+{
+    QVector<Candidate> candidates;
+    collectCandidates(root, segStart, segEnd, forcePickable, candidates);
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.tEntry < b.tEntry;
+    });
+
+    QList<TriangleHit> triangleHits;
+    for (const auto &candidate : candidates) {
+        triangleHits.clear();
+        candidate.bvh->getSegmentIntersections(candidate.localStart, candidate.localEnd, triangleHits);
+        for (const auto &hit : triangleHits) {
+            hits.append(makeResult(candidate, hit, segStart));
+        }
+    }
+}
+
+bool ScenePicker::pickMesh(const iris::SceneNodePtr &root,
+                           const QVector3D &segStart,
+                           const QVector3D &segEnd,
+                           iris::PickingResult &result,
+                           PickingMode mode,
+                           bool forcePickable)
+{
+    if (mode == PickingMode::All) {
+        QList<iris::PickingResult> hits;
+        pickMeshes(root, segStart, segEnd, hits, forcePickable);
+        if (hits.isEmpty()) return false;
+        result = hits.first();
+        return true;
+    }
+
+    QVector<Candidate> candidates;
+    collectCandidates(root, segStart, segEnd, forcePickable, candidates);
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.tEntry < b.tEntry;
+    });
+
+    // t is shared between world and mesh space since the transforms are affine
+    float bestT = std::numeric_limits<float>::max();
+    bool found = false;
+
+    for (const auto &candidate : candidates) {
+        // Candidates are sorted by where the segment enters them, nothing after this can be closer
+        if (candidate.tEntry > bestT) break;
+
+        TriangleHit hit;
+        const bool hasHit = mode == PickingMode::Any
+                ? candidate.bvh->getAnyIntersection(candidate.localStart, candidate.localEnd, hit)
+                : candidate.bvh->getNearestIntersection(candidate.localStart, candidate.localEnd, hit);
+
+        if (hasHit && hit.t < bestT) {
+            bestT = hit.t;
+            result = makeResult(candidate, hit, segStart);
+            found = true;
+
+            if (mode == PickingMode::Any) break;
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,143 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef SCENEPICKER_H
+#define SCENEPICKER_H
+
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QVector>
+#include <QVector3D>
+
+#include "irisglfwd.h"
+#include "irisgl/src/scenegraph/scene.h"
+
+enum class PickingMode
+{
+    Nearest,    // closest hit only, anything farther than the best hit so far is pruned
+    Any,        // stops at the first hit found, for hover tests that only need to know if something is there
+    All         // every hit along the segment, unsorted
+};
+
+struct TriangleHit
+{
+    int triangleIndex;
+    float t;                // along the segment, 0 at the start and 1 at the end
+    QVector3D hitPoint;
+};
+
+// Bounding volume hierarchy over the triangles of a TriMesh, everything is in mesh space
+// Triangles are copied in tree order so leaves are contiguous in memory
+class TriangleBVH
+{
+public:
+    explicit TriangleBVH(const iris::TriMesh *triMesh);
+
+    int triangleCount() const { return triangles.size() / 3; }
+    bool isEmpty() const { return nodes.isEmpty(); }
+
+    // Returns the entry point of the segment into the root bounds, false if it misses the mesh entirely
+    bool segmentEntersBounds(const QVector3D &segStart, const QVector3D &segEnd, float &tEntry) const;
+
+    // Appends every triangle the segment passes through, same contract as TriMesh::getSegmentIntersections
+    int getSegmentIntersections(const QVector3D &segStart,
+                                const QVector3D &segEnd,
+                                QList<TriangleHit> &hits) const;
+
+    // Closest hit only, subtrees that start farther than the best hit so far are skipped
+    bool getNearestIntersection(const QVector3D &segStart,
+                                const QVector3D &segEnd,
+                                TriangleHit &hit) const;
+
+    // Returns as soon as any triangle is hit, the hit isn't necessarily the closest one
+    bool getAnyIntersection(const QVector3D &segStart,
+                            const QVector3D &segEnd,
+                            TriangleHit &hit) const;
+
+private:
+    struct Node
+    {
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+        int first;      // leaf: first triangle, inner: index of the right child (left child is next)
+        int count;      // number of triangles in a leaf, 0 for inner nodes
+    };
+
+    int build(QVector<int> &order, const QVector<QVector3D> &centroids, int first, int count);
+    bool findIntersection(const QVector3D &segStart, const QVector3D &segEnd,
+                          bool stopAtFirstHit, TriangleHit &hit) const;
+    bool intersectsNode(const Node &node, const QVector3D &origin, const QVector3D &invDir,
+                        float tMax, float &tEntry) const;
+    bool intersectTriangle(int index, const QVector3D &origin, const QVector3D &dir, float &t) const;
+
+    QVector<Node> nodes;
+    QVector<QVector3D> triangles;   // three vertices per triangle
+    QVector<int> triangleIndices;   // tree order -> index in the source TriMesh
+};
+
+// Scene picking against mesh nodes
+// Meshes are rejected with their world bounds first and only the survivors are tested against
+// their triangle BVH, which is built once per mesh and cached for as long as the mesh lives
+class ScenePicker
+{
+public:
+    // Appends a hit for every triangle the segment passes through (PickingMode::All)
+    static void pickMeshes(const iris::SceneNodePtr &root,
+                           const QVector3D &segStart,
+                           const QVector3D &segEnd,
+                           QList<iris::PickingResult> &hits,
+                           bool forcePickable = false);
+
+    // Single hit query for PickingMode::Nearest or PickingMode::Any, returns false when nothing was hit
+    // Only the current best hit is kept so nothing is allocated per triangle and nothing needs sorting
+    static bool pickMesh(const iris::SceneNodePtr &root,
+                         const QVector3D &segStart,
+                         const QVector3D &segEnd,
+                         iris::PickingResult &result,
+                         PickingMode mode = PickingMode::Nearest,
+                         bool forcePickable = false);
+
+    static QSharedPointer<TriangleBVH> getTriangleBVH(const iris::MeshPtr &mesh);
+    static void clearCache();
+
+private:
+    struct Candidate
+    {
+        iris::MeshNodePtr node;
+        QSharedPointer<TriangleBVH> bvh;
+        QVector3D localStart;
+        QVector3D localEnd;
+        float tEntry;
+    };
+
+    struct CachedBVH
+    {
+        QWeakPointer<iris::Mesh> mesh;
+        iris::TriMesh *triMesh;
+        int triangleCount;
+        QSharedPointer<TriangleBVH> bvh;
+    };
+
+    static void collectCandidates(const iris::SceneNodePtr &node,
+                                  const QVector3D &segStart,
+                                  const QVector3D &segEnd,
+                                  bool forcePickable,
+                                  QVector<Candidate> &candidates);
+
+    static iris::PickingResult makeResult(const Candidate &candidate,
+                                          const TriangleHit &hit,
+                                          const QVector3D &segStart);
+
+    static QHash<iris::Mesh*, CachedBVH> bvhCache;
+};
+
+#endif // SCENEPICKER_H
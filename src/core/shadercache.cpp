@@ -0,0 +1,84 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "shadercache.h"
+
+#include <QMutexLocker>
+
+bool ShaderCache::find(const QString &shaderGuid, const QString &sourceFolder, QJsonObject &definition)
+{
+    QMutexLocker locker(&mutex);
+
+    auto iter = definitions.constFind(getKey(shaderGuid, sourceFolder));
+    if (iter == definitions.constEnd()) {
+        misses++;
+        return false;
+    }
+
+    // QJsonObject is implicitly shared, handing it out doesn't copy the definition
+    definition = iter.value();
+    hits++;
+    return true;
+}
+
+void ShaderCache::insert(const QString &shaderGuid, const QString &sourceFolder, const QJsonObject &definition)
+{
+    if (shaderGuid.isEmpty() || definition.isEmpty()) return;
+
+    QMutexLocker locker(&mutex);
+    definitions.insert(getKey(shaderGuid, sourceFolder), definition);
+}
+
+void ShaderCache::invalidate(const QString &shaderGuid)
+{
+    QMutexLocker locker(&mutex);
+
+    const QString prefix = shaderGuid + '|';
+    for (auto iter = definitions.begin(); iter != definitions.end();) {
+        if (iter.key().startsWith(prefix)) iter = definitions.erase(iter);
+        else ++iter;
+    }
+}
+
+void ShaderCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    definitions.clear();
+}
+
+void ShaderCache::resetStatistics()
+{
+    QMutexLocker locker(&mutex);
+    hits = 0;
+    misses = 0;
+}
+
+qint64 ShaderCache::getHits()
+{
+    QMutexLocker locker(&mutex);
+    return hits;
+}
+
+qint64 ShaderCache::getMisses()
+{
+    QMutexLocker locker(&mutex);
+    return misses;
+}
+
+QString ShaderCache::getKey(const QString &shaderGuid, const QString &sourceFolder)
+{
+    return shaderGuid + '|' + sourceFolder;
+}
+
+QMutex ShaderCache::mutex;
+QHash<QString, QJsonObject> ShaderCache::definitions;
+qint64 ShaderCache::hits = 0;
+qint64 ShaderCache::misses = 0;
@@ -0,0 +1,52 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+
+/**
+ * Process wide cache of resolved shader definitions
+ * Every material of a shader used to read and parse the definition again (a file for builtin shaders, an asset
+ * payload and two asset lookups for project shaders). Definitions are now resolved once per shader and source
+ * folder and shared by every material created from it afterwards
+ * Builtin shaders are also keyed by the file's modification time, project shaders are dropped whenever their
+ * asset changes in the database. Safe to use from worker threads
+ */
+class ShaderCache
+{
+public:
+    // Returns false when there's no entry yet for shaderGuid resolved against sourceFolder
+    static bool find(const QString &shaderGuid, const QString &sourceFolder, QJsonObject &definition);
+    static void insert(const QString &shaderGuid, const QString &sourceFolder, const QJsonObject &definition);
+
+    // Drops every entry of the shader, called when its asset is written to
+    static void invalidate(const QString &shaderGuid);
+    static void clear();
+
+    static qint64 getHits();
+    static qint64 getMisses();
+    static void resetStatistics();
+
+private:
+    static QString getKey(const QString &shaderGuid, const QString &sourceFolder);
+
+    static QMutex mutex;
+    static QHash<QString, QJsonObject> definitions;
+    static qint64 hits;
+    static qint64 misses;
+};
+
+#endif // SHADERCACHE_H
@@ -0,0 +1,292 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "texturecache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QVector>
+
+#include <algorithm>
+
+#include "irisgl/src/graphics/texture2d.h"
+#include "../helpers/hashhelper.h"
+
+iris::Texture2DPtr TextureCache::load(const QString &path, bool flipY)
+{
+    const QString contentKey = getContentKey(path);
+
+    // Missing files aren't cached, they're handed to irisgl as before
+    if (contentKey.isEmpty()) return iris::Texture2D::load(path, flipY);
+
+    const QString key = contentKey + (flipY ? "|flipped" : "");
+    {
+        QMutexLocker locker(&mutex);
+        if (auto texture = lookup(key)) {
+            hits++;
+            return texture;
+        }
+    }
+
+    // Decoding and uploading happen outside the lock so other threads can use the cache meanwhile
+    auto texture = iris::Texture2D::load(path, flipY);
+    if (!texture) return texture;
+
+    const qint64 size = estimateSize(path);
+
+    QMutexLocker locker(&mutex);
+    // Another thread may have loaded the same texture in the meantime, everyone shares the first one
+    if (auto cached = lookup(key)) return cached;
+
+    insert(key, texture, size);
+    return texture;
+}
+
+iris::Texture2DPtr TextureCache::loadAsset(const QString &assetGuid, const QString &path, bool flipY)
+{
+    const QString fileStamp = getFileStamp(path);
+
+    // The file behind an asset can be replaced, the stamp tells if the key is still the right one
+    if (!fileStamp.isEmpty()) {
+        QMutexLocker locker(&mutex);
+        auto it = assetKeys.constFind(assetGuid);
+        if (it != assetKeys.constEnd() && it->fileStamp == fileStamp) {
+            if (auto texture = lookup(it->contentKey + (flipY ? "|flipped" : ""))) {
+                hits++;
+                return texture;
+            }
+        }
+    }
+
+    auto texture = load(path, flipY);
+    if (!fileStamp.isEmpty()) {
+        const QString contentKey = getContentKey(path);
+        QMutexLocker locker(&mutex);
+        assetKeys.insert(assetGuid, { fileStamp, contentKey });
+    }
+
+    return texture;
+}
+
+iris::Texture2DPtr TextureCache::loadCubeMap(const QString &front, const QString &back,
+                                             const QString &top, const QString &bottom,
+                                             const QString &left, const QString &right)
+{
+    const QStringList sides = { front, back, top, bottom, left, right };
+
+    QString key = "cubemap";
+    QString infoSide;
+    qint64 size = 0;
+
+    for (const auto &side : sides) {
+        const QString contentKey = side.isEmpty() ? QString() : getContentKey(side);
+        key += "|" + contentKey;
+
+        if (!contentKey.isEmpty()) {
+            if (infoSide.isEmpty()) infoSide = side;
+            size += estimateSize(side);
+        }
+    }
+
+    // We need at least one valid image to get some metadata from
+    if (infoSide.isEmpty()) return iris::Texture2DPtr();
+
+    {
+        QMutexLocker locker(&mutex);
+        if (auto texture = lookup(key)) {
+            hits++;
+            return texture;
+        }
+    }
+
+    auto texture = iris::Texture2D::createCubeMap(front, back, top, bottom, left, right, new QImage(infoSide));
+    if (!texture) return texture;
+
+    QMutexLocker locker(&mutex);
+    if (auto cached = lookup(key)) return cached;
+
+    insert(key, texture, size);
+    return texture;
+}
+
+void TextureCache::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+    memoryBudget = bytes;
+    trim();
+}
+
+void TextureCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    for (auto it = entries.begin(); it != entries.end();) {
+        it->retained.clear();
+
+        if (it->texture.isNull()) it = entries.erase(it);
+        else ++it;
+    }
+}
+
+void TextureCache::resetStatistics()
+{
+    QMutexLocker locker(&mutex);
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+TextureCache::Statistics TextureCache::getStatistics()
+{
+    QMutexLocker locker(&mutex);
+    Statistics stats;
+    stats.textureCount = 0;
+    stats.memoryUsage = 0;
+    stats.retainedMemory = 0;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+
+    for (const auto &entry : entries) {
+        if (entry.texture.isNull()) continue;
+
+        stats.textureCount++;
+        stats.memoryUsage += entry.size;
+        if (!!entry.retained) stats.retainedMemory += entry.size;
+    }
+
+    return stats;
+}
+
+iris::Texture2DPtr TextureCache::lookup(const QString &contentKey)
+{
+    auto it = entries.find(contentKey);
+    if (it == entries.end()) return iris::Texture2DPtr();
+
+    auto texture = it->texture.toStrongRef();
+    if (!texture) {
+        entries.erase(it);
+        return texture;
+    }
+
+    it->lastUsed = ++useCounter;
+    it->retained = texture;
+
+    return texture;
+}
+
+void TextureCache::insert(const QString &contentKey, const iris::Texture2DPtr &texture, qint64 size)
+{
+    Entry entry;
+    entry.texture = texture;
+    entry.retained = texture;
+    entry.size = size;
+    entry.lastUsed = ++useCounter;
+
+    entries.insert(contentKey, entry);
+    misses++;
+
+    trim();
+}
+
+void TextureCache::trim()
+{
+    qint64 usage = 0;
+    QVector<QPair<quint64, QString>> candidates;
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->texture.isNull()) {
+            it = entries.erase(it);
+            continue;
+        }
+
+        usage += it->size;
+        if (!!it->retained) candidates.append(qMakePair(it->lastUsed, it.key()));
+        ++it;
+    }
+
+    if (usage <= memoryBudget) return;
+
+    // Least recently used first, textures that are still in use elsewhere survive being let go of
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto &candidate : candidates) {
+        if (usage <= memoryBudget) break;
+
+        auto it = entries.find(candidate.second);
+        it->retained.clear();
+
+        if (it->texture.isNull()) {
+            usage -= it->size;
+            entries.erase(it);
+            evictions++;
+        }
+    }
+}
+
+QString TextureCache::getContentKey(const QString &path)
+{
+    // Resources are part of the binary and can't change
+    if (path.startsWith(":")) return QFile::exists(path) ? "resource:" + path : QString();
+
+    const QString fileStamp = getFileStamp(path);
+    if (fileStamp.isEmpty()) return QString();
+
+    {
+        QMutexLocker locker(&mutex);
+        auto it = fileHashes.constFind(fileStamp);
+        if (it != fileHashes.constEnd()) return it.value();
+    }
+
+    // Hashed without the lock, two threads hashing the same file just store the same value
+    const QByteArray hash = HashHelper::hashFile(path);
+    if (hash.isEmpty()) return QString();
+
+    QMutexLocker locker(&mutex);
+    return fileHashes.insert(fileStamp, "sha1:" + QString::fromLatin1(hash)).value();
+}
+
+QString TextureCache::getFileStamp(const QString &path)
+{
+    if (path.startsWith(":")) return QFile::exists(path) ? path : QString();
+
+    QFileInfo fileInfo(path);
+    if (!fileInfo.isFile()) return QString();
+
+    return QString("%1|%2|%3")
+        .arg(fileInfo.absoluteFilePath())
+        .arg(fileInfo.lastModified().toMSecsSinceEpoch())
+        .arg(fileInfo.size());
+}
+
+qint64 TextureCache::estimateSize(const QString &path)
+{
+    // Only the header is read, RGBA8 plus a third for the mip chain
+    const QSize size = QImageReader(path).size();
+    if (!size.isValid()) return 0;
+
+    const qint64 bytes = qint64(size.width()) * size.height() * 4;
+    return bytes + bytes / 3;
+}
+
+QHash<QString, TextureCache::Entry> TextureCache::entries;
+QHash<QString, TextureCache::AssetKey> TextureCache::assetKeys;
+QHash<QString, QString> TextureCache::fileHashes;
+qint64 TextureCache::memoryBudget = qint64(512) * 1024 * 1024;
+quint64 TextureCache::useCounter = 0;
+qint64 TextureCache::hits = 0;
+qint64 TextureCache::misses = 0;
+qint64 TextureCache::evictions = 0;
+QMutex TextureCache::mutex;
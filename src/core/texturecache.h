@@ -0,0 +1,90 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWeakPointer>
+
+#include "irisgl/src/irisglfwd.h"
+
+/**
+ * Process wide cache of GPU textures
+ * Textures are keyed by the contents of their files so every user of the same image shares one upload, no matter
+ * which path or asset it came from. Callers get a shared reference, textures stay alive for as long as anything uses
+ * them. The cache also keeps recently used textures around on its own until it goes over its memory budget
+ * Textures are GL objects, callers need a context current that shares with the application's. Thumbnail workers
+ * load through it as well, the lock only guards the lookups and inserts so hashing and uploads run in parallel
+ */
+class TextureCache
+{
+public:
+    struct Statistics
+    {
+        int textureCount;       // textures currently alive
+        qint64 memoryUsage;     // estimated GPU memory of those textures
+        qint64 retainedMemory;  // part of it the cache holds on to itself, let go of first when over budget
+        qint64 hits;
+        qint64 misses;
+        qint64 evictions;
+    };
+
+    static iris::Texture2DPtr load(const QString &path, bool flipY = true);
+    // Same as load, lookups for a known asset don't have to hash the file again
+    static iris::Texture2DPtr loadAsset(const QString &assetGuid, const QString &path, bool flipY = true);
+    static iris::Texture2DPtr loadCubeMap(const QString &front, const QString &back,
+                                          const QString &top, const QString &bottom,
+                                          const QString &left, const QString &right);
+
+    static void setMemoryBudget(qint64 bytes);
+    // Lets go of every texture the cache only keeps for reuse, textures in use stay cached
+    static void clear();
+    static Statistics getStatistics();
+    // Zeroes hits, misses and evictions so they only count from here on
+    static void resetStatistics();
+
+private:
+    struct Entry
+    {
+        QWeakPointer<iris::Texture2D> texture;
+        iris::Texture2DPtr retained;    // null once the entry was trimmed, it stays cached while in use
+        qint64 size;
+        quint64 lastUsed;
+    };
+
+    struct AssetKey
+    {
+        QString fileStamp;
+        QString contentKey;
+    };
+
+    static iris::Texture2DPtr lookup(const QString &contentKey);
+    static void insert(const QString &contentKey, const iris::Texture2DPtr &texture, qint64 size);
+    static void trim();
+    static QString getContentKey(const QString &path);
+    static QString getFileStamp(const QString &path);
+    static qint64 estimateSize(const QString &path);
+
+    static QHash<QString, Entry> entries;
+    static QHash<QString, AssetKey> assetKeys;      // asset guid -> content key
+    static QHash<QString, QString> fileHashes;      // file stamp -> content hash, so files are only hashed once
+    static qint64 memoryBudget;
+    static quint64 useCounter;
+    static qint64 hits;
+    static qint64 misses;
+    static qint64 evictions;
+    static QMutex mutex;    // only held around the maps, never while hashing, decoding or uploading
+};
+
+#endif // TEXTURECACHE_H
@@ -11,48 +11,136 @@ For more information see the LICENSE file
 
 #include <QCryptographicHash>
 #include <QImage>
+#include <QImageReader>
 #include <QSharedPointer>
 #include <QFile>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QDir>
 #include <QHash>
 #include <QDebug>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include "thumbnailmanager.h"
 
+namespace
+{
+    // The size of the source is kept in the cached file so Thumbnail::originalSize survives a restart
+    const char *originalSizeKey = "OriginalSize";
+
+    int imageCost(const QImage &image)
+    {
+        return qMax(1, image.byteCount() / 1024);
+    }
+}
+
 QSharedPointer<Thumbnail> ThumbnailManager::createThumbnail(QString filename, int width, int height)
 {
     // assumes file exist for now
     QFileInfo fileInfo(filename);
-    auto lastModified = fileInfo.lastModified();
-    auto hash = filename + lastModified.toMSecsSinceEpoch() + QString("-") + width + QString("-") + height;
+    auto hash = getCacheKey(fileInfo, width, height);
+
+    QImage runtimeImage;
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (auto cached = thumbnails.object(hash)) {
+            return *cached;
+        }
 
-    if (ThumbnailManager::thumbnails.contains(hash)) {
-        return ThumbnailManager::thumbnails[hash];
+        // runtime images have nothing on disk to key the cache with
+        if (auto source = cachedImages.object(filename)) runtimeImage = *source;
     }
 
     QImage image;
-    if (cachedImages.contains(filename))
-        image = cachedImages[filename];
+    QSize originalSize;
+
+    const QString diskPath = QDir(getCacheFolder())
+        .filePath(QCryptographicHash::hash(hash.toUtf8(), QCryptographicHash::Sha1).toHex() + ".png");
+
+    if (!runtimeImage.isNull()) {
+        originalSize = runtimeImage.size();
+        image = runtimeImage.scaledToHeight(height, Qt::SmoothTransformation);
+    }
+    else if (image.load(diskPath, "PNG")) {
+        const QStringList size = image.text(originalSizeKey).split('x');
+        if (size.size() == 2) originalSize = QSize(size[0].toInt(), size[1].toInt());
+    }
     else {
-        image = QImage(filename);
+        image = loadScaledImage(filename, height, originalSize);
+
+        if (!image.isNull() && QDir().mkpath(getCacheFolder())) {
+            QImage stored = image;
+            stored.setText(originalSizeKey, QString("%1x%2").arg(originalSize.width()).arg(originalSize.height()));
+
+            QSaveFile file(diskPath);
+            if (file.open(QIODevice::WriteOnly) && stored.save(&file, "PNG")) file.commit();
+        }
     }
 
     auto thumb = new Thumbnail;
     thumb->filePath		= filename;
     thumb->thumbSize	= QSize(width, height);
-    thumb->originalSize = image.size();
-    thumb->thumb		= new QImage(image.scaledToHeight(height, Qt::SmoothTransformation));
+    thumb->originalSize = originalSize;
+    thumb->thumb		= new QImage(image);
 
     auto thumbPtr = QSharedPointer<Thumbnail>(thumb);
-    ThumbnailManager::thumbnails.insert(hash, thumbPtr);
+
+    QMutexLocker locker(&cacheMutex);
+    thumbnails.insert(hash, new QSharedPointer<Thumbnail>(thumbPtr), imageCost(image));
 
     return thumbPtr;
 }
 
 void ThumbnailManager::cacheImage(QString filename, QImage image)
 {
-    cachedImages.insert(filename, image);
+    const int cost = imageCost(image);
+
+    QMutexLocker locker(&cacheMutex);
+    cachedImages.insert(filename, new QImage(image), cost);
+}
+
+void ThumbnailManager::clearMemoryCache()
+{
+    QMutexLocker locker(&cacheMutex);
+    thumbnails.clear();
+    cachedImages.clear();
+}
+
+QString ThumbnailManager::getCacheFolder()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("Thumbnails");
+}
+
+QImage ThumbnailManager::loadScaledImage(const QString &filename, int height, QSize &originalSize)
+{
+    QImageReader reader(filename);
+    originalSize = reader.size();
+
+    // Let the decoder produce the thumbnail directly, large textures are never decoded at full size
+    // Only downscaling is done this way, smaller images are still scaled up after decoding as before
+    if (originalSize.isValid() && originalSize.height() > height) {
+        reader.setScaledSize(QSize(qMax(1, originalSize.width() * height / originalSize.height()), height));
+        return reader.read();
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) return image;
+
+    if (!originalSize.isValid()) originalSize = image.size();
+    return image.scaledToHeight(height, Qt::SmoothTransformation);
+}
+
+QString ThumbnailManager::getCacheKey(const QFileInfo &fileInfo, int width, int height)
+{
+    return QString("%1|%2|%3|%4x%5")
+        .arg(fileInfo.absoluteFilePath())
+        .arg(fileInfo.lastModified().toMSecsSinceEpoch())
+        .arg(fileInfo.size())
+        .arg(width)
+        .arg(height);
 }
 
-QHash<QString, QSharedPointer<Thumbnail>> ThumbnailManager::thumbnails = QHash<QString, QSharedPointer<Thumbnail>>();
-QHash<QString, QImage> ThumbnailManager::cachedImages = QHash<QString, QImage>();
+QCache<QString, QSharedPointer<Thumbnail>> ThumbnailManager::thumbnails(ThumbnailManager::memoryCacheLimit);
+QCache<QString, QImage> ThumbnailManager::cachedImages(ThumbnailManager::imageCacheLimit);
+QMutex ThumbnailManager::cacheMutex;
@@ -12,6 +12,7 @@ For more information see the LICENSE file
 #ifndef THUMBNAILMANAGER_H
 #define THUMBNAILMANAGER_H
 
+#include <QCache>
 #include <QCryptographicHash>
 #include <QImage>
 #include <QSharedPointer>
@@ -19,6 +20,7 @@ For more information see the LICENSE file
 #include <QFileInfo>
 #include <QDateTime>
 #include <QHash>
+#include <QMutex>
 #include <QDebug>
 
 class QImage;
@@ -26,6 +28,8 @@ class QCryptographicHash;
 
 struct Thumbnail
 {
+    ~Thumbnail() { delete thumb; }
+
     QImage* thumb;
     QString filePath;
 
@@ -36,17 +40,33 @@ struct Thumbnail
 
 /**
  * This class caches thumbnails for image files
- * todo: find a way to remove unused thumbnails
+ * Thumbnails live in a size bounded LRU in memory backed by a cache on disk keyed by the
+ * source's path, modification time and size so they survive restarts and go stale on their own
+ * Sources are decoded straight at the thumbnail size instead of at full resolution
+ * Safe to call from worker threads, the import pipeline decodes thumbnails on its pool
  */
 class ThumbnailManager
 {
 public:
     static QSharedPointer<Thumbnail> createThumbnail(QString filename, int width, int height);
-    static QHash<QString, QSharedPointer<Thumbnail>> thumbnails;
 
     static void cacheImage(QString filename, QImage image);
+    static void clearMemoryCache();
+    static QString getCacheFolder();
+
+private:
+    static QImage loadScaledImage(const QString &filename, int height, QSize &originalSize);
+    static QString getCacheKey(const QFileInfo &fileInfo, int width, int height);
+
+    // Costs are in kilobytes of pixel data
+    static const int memoryCacheLimit = 32 * 1024;
+    static const int imageCacheLimit = 64 * 1024;
+
+    static QCache<QString, QSharedPointer<Thumbnail>> thumbnails;
     // this is for images generated at runtime that dont have physical files associated with them
-    static QHash<QString, QImage> cachedImages;
+    static QCache<QString, QImage> cachedImages;
+    // guards both caches, decoding and the disk cache happen outside of it
+    static QMutex cacheMutex;
 };
 
 
@@ -13,12 +13,20 @@ For more information see the LICENSE file
 #include "ui_progressdialog.h"
 
 #include <QApplication>
+#include <QPushButton>
 
 ProgressDialog::ProgressDialog(QDialog *parent) : QDialog(parent), ui(new Ui::ProgressDialog)
 {
     ui->setupUi(this);
     this->setWindowFlags(Qt::FramelessWindowHint);
 	setWindowModality(Qt::WindowModal);
+
+    cancelButton = new QPushButton("Cancel", this);
+    cancelButton->setStyleSheet("QPushButton { background: #333; color: #EEE; border: 1px solid black; padding: 4px 16px; }"
+                                "QPushButton:hover { background: #404040; }");
+    cancelButton->hide();
+    ui->verticalLayout->addWidget(cancelButton, 0, Qt::AlignRight);
+    connect(cancelButton, &QPushButton::clicked, this, &ProgressDialog::canceled);
 }
 
 ProgressDialog::~ProgressDialog()
@@ -26,6 +34,12 @@ ProgressDialog::~ProgressDialog()
     delete ui;
 }
 
+void ProgressDialog::setCancelable(bool cancelable)
+{
+    cancelButton->setVisible(cancelable);
+    adjustSize();
+}
+
 void ProgressDialog::setLabelText(const QString &text)
 {
     ui->label->setText(text);
@@ -14,6 +14,8 @@ For more information see the LICENSE file
 
 #include <QDialog>
 
+class QPushButton;
+
 namespace Ui {
     class ProgressDialog;
 }
@@ -26,6 +28,12 @@ public:
     ProgressDialog(QDialog *parent = nullptr);
     ~ProgressDialog();
 
+    // Shows a cancel button, pressing it emits canceled()
+    void setCancelable(bool cancelable);
+
+signals:
+    void canceled();
+
 public slots:
     void setLabelText(const QString&);
     void setRange(int, int);
@@ -35,6 +43,7 @@ public slots:
 
 private:
     Ui::ProgressDialog *ui;
+    QPushButton *cancelButton;
 };
 
 #endif // PROGRESSDIALOG_H
@@ -27,11 +27,13 @@ For more information see the LICENSE file
 #include "../irisgl/src/math/mathhelper.h"
 #include "../irisgl/src/scenegraph/cameranode.h"
 #include "../core/keyboardstate.h"
+#include "../core/scenepicker.h"
 #include "../irisgl/src/graphics/renderlist.h"
 #include "../irisgl/src/content/contentmanager.h"
 #include "../commands/transfrormscenenodecommand.h"
 #include "../uimanager.h"
 #include "irisgl/extras/Materials.h"
+#include "../core/texturecache.h"
 #include <QtMath>
 
 
@@ -83,7 +85,7 @@ EditorVrController::EditorVrController(iris::ContentManagerPtr content)
 	auto mat = iris::DefaultMaterial::create();
 
     mat->setDiffuseTexture(
-                iris::Texture2D::load(
+                TextureCache::load(
                     IrisUtils::getAbsoluteAssetPath("app/content/models/external_controller01_col.png")));
 
     leftHandRenderItem = new iris::RenderItem();
@@ -456,21 +458,12 @@ void EditorVrController::update(float dt)
 
 bool EditorVrController::rayCastToScene(QMatrix4x4 handMatrix, iris::PickingResult& result)
 {
-    QList<iris::PickingResult> hits;
-
-    scene->rayCast(handMatrix * QVector3D(0,0,0),
-                   handMatrix * QVector3D(0,0,-100),
-                   hits);
-
-    if(hits.size() == 0)
-        return false;
-
-    qSort(hits.begin(), hits.end(), [](const iris::PickingResult& a, const iris::PickingResult& b){
-        return a.distanceFromStartSqrd < b.distanceFromStartSqrd;
-    });
-
-    result = hits.first();
-    return true;
+    // Runs every frame, only the closest hit is needed so let the picker stop early
+    return ScenePicker::pickMesh(scene->getRootNode(),
+                                 handMatrix * QVector3D(0,0,0),
+                                 handMatrix * QVector3D(0,0,-100),
+                                 result,
+                                 PickingMode::Nearest);
 }
 
 iris::SceneNodePtr EditorVrController::getObjectRoot(iris::SceneNodePtr node)
@@ -25,6 +25,7 @@ For more information see the LICENSE file
 #include "uimanager.h"
 #include "../commands/transfrormscenenodecommand.h"
 #include "irisgl/src/math/mathhelper.h"
+#include "core/programcache.h"
 #include "uimanager.h"
 #include "../widgets/scenenodepropertieswidget.h"
 
@@ -165,7 +166,8 @@ void RotationGizmo::loadAssets()
 	handleMeshes.append(iris::Mesh::loadMesh(IrisUtils::getAbsoluteAssetPath("app/models/rot_y.obj")));
 	handleMeshes.append(iris::Mesh::loadMesh(IrisUtils::getAbsoluteAssetPath("app/models/rot_z.obj")));
 
-	shader = iris::GraphicsHelper::loadShader(
+	// Shared by every gizmo, the cache owns it
+	shader = ProgramCache::load(
 		IrisUtils::getAbsoluteAssetPath("app/shaders/gizmo.vert"),
 		IrisUtils::getAbsoluteAssetPath("app/shaders/gizmo.frag"));
 
@@ -25,6 +25,7 @@ For more information see the LICENSE file
 #include "uimanager.h"
 #include "../commands/transfrormscenenodecommand.h"
 #include "irisgl/src/math/mathhelper.h"
+#include "core/programcache.h"
 #include "../widgets/scenenodepropertieswidget.h"
 #include "../widgets/propertywidgets/transformpropertywidget.h"
 
@@ -188,7 +189,8 @@ void ScaleGizmo::loadAssets()
 
 	centerMesh = iris::Mesh::loadMesh(IrisUtils::getAbsoluteAssetPath("app/models/axis_cube.obj"));
 
-	shader = iris::GraphicsHelper::loadShader(
+	// Shared by every gizmo, the cache owns it
+	shader = ProgramCache::load(
 		IrisUtils::getAbsoluteAssetPath("app/shaders/gizmo.vert"),
 		IrisUtils::getAbsoluteAssetPath("app/shaders/gizmo.frag"));
 }
@@ -11,6 +11,8 @@ For more information see the LICENSE file
 
 #include "thumbnailgenerator.h"
 
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QMutex>
 #include <QMutexLocker>
@@ -18,6 +20,7 @@ For more information see the LICENSE file
 #include <QtMath>
 #include <QStandardPaths>
 
+#include "irisgl/src/core/logger.h"
 #include "irisgl/src/graphics/forwardrenderer.h"
 #include "irisgl/src/graphics/mesh.h"
 #include "irisgl/src/graphics/rendertarget.h"
@@ -27,19 +30,127 @@ For more information see the LICENSE file
 #include "irisgl/src/scenegraph/meshnode.h"
 #include "irisgl/src/scenegraph/scene.h"
 
+#include "assimp/scene.h"
+
 #include "constants.h"
-#include "io/assetmanager.h"
+#include "globals.h"
+#include "core/meshcache.h"
+#include "core/project.h"
 #include "io/scenereader.h"
 #include "io/materialreader.hpp"
 
 ThumbnailGenerator* ThumbnailGenerator::instance = nullptr;
 
-void RenderThread::requestThumbnail(const ThumbnailRequest &request)
+QString ThumbnailQueue::requestKey(const ThumbnailRequest &request)
+{
+    // previews are saved by the user so they never replace a regular thumbnail
+    return QString("%1:%2").arg(request.preview ? "preview" : "thumb", request.id.isEmpty() ? request.path : request.id);
+}
+
+void ThumbnailQueue::push(ThumbnailRequest request)
+{
+    QMutexLocker locker(&mutex);
+    if (closed) return;
+
+    request.generation = generation;
+
+    const QString key = requestKey(request);
+    auto existing = pending.find(key);
+    if (existing != pending.end()) {
+        // Keep the newest request data but never make it less urgent than it already was
+        const auto oldPriority = existing->priority;
+        request.priority = qMin(request.priority, oldPriority);
+        request.queuedAt = existing->queuedAt;
+        *existing = request;
+
+        if (request.priority != oldPriority) {
+            order[static_cast<int>(oldPriority)].removeOne(key);
+            order[static_cast<int>(request.priority)].append(key);
+        }
+
+        return;
+    }
+
+    pending.insert(key, request);
+    order[static_cast<int>(request.priority)].append(key);
+    requestsAvailable.wakeOne();
+}
+
+bool ThumbnailQueue::pop(ThumbnailRequest &request)
+{
+    QMutexLocker locker(&mutex);
+    while (!closed && pending.isEmpty()) requestsAvailable.wait(&mutex);
+    if (closed) return false;
+
+    for (auto &keys : order) {
+        if (keys.isEmpty()) continue;
+        request = pending.take(keys.takeFirst());
+        return true;
+    }
+
+    return false;
+}
+
+bool ThumbnailQueue::cancel(const QString &id)
+{
+    QMutexLocker locker(&mutex);
+
+    bool cancelled = false;
+    for (const auto &key : pending.keys()) {
+        const auto &request = pending[key];
+        if (request.id != id) continue;
+        order[static_cast<int>(request.priority)].removeOne(key);
+        pending.remove(key);
+        cancelled = true;
+    }
+
+    return cancelled;
+}
+
+bool ThumbnailQueue::prioritise(const QString &id, ThumbnailPriority priority)
+{
+    QMutexLocker locker(&mutex);
+
+    bool found = false;
+    for (const auto &key : pending.keys()) {
+        auto &request = pending[key];
+        if (request.id != id) continue;
+        found = true;
+        if (request.priority == priority) continue;
+
+        order[static_cast<int>(request.priority)].removeOne(key);
+        order[static_cast<int>(priority)].append(key);
+        request.priority = priority;
+    }
+
+    return found;
+}
+
+void ThumbnailQueue::cancelAll()
+{
+    QMutexLocker locker(&mutex);
+    pending.clear();
+    for (auto &keys : order) keys.clear();
+    generation++;
+}
+
+void ThumbnailQueue::close()
+{
+    QMutexLocker locker(&mutex);
+    closed = true;
+    requestsAvailable.wakeAll();
+}
+
+bool ThumbnailQueue::isCurrent(const ThumbnailRequest &request)
+{
+    QMutexLocker locker(&mutex);
+    return request.generation == generation;
+}
+
+int ThumbnailQueue::depth()
 {
-    QMutexLocker locker(&requestMutex);
-    requests.append(request);
-    requestsAvailable.release();
-    locker.unlock();
+    QMutexLocker locker(&mutex);
+    return pending.size();
 }
 
 void RenderThread::run()
@@ -52,40 +163,41 @@ void RenderThread::run()
     tex = iris::Texture2D::create(512, 512);
     renderTarget->addTexture(tex);
 
-    shutdown = false;
+    ThumbnailRequest request;
+    while (queue->pop(request)) {
+        QElapsedTimer renderTimer;
+        renderTimer.start();
+        const qint64 waitTime = QDateTime::currentMSecsSinceEpoch() - request.queuedAt;
 
-    while(!shutdown) {
-        requestsAvailable.acquire();
-        // the size still has to be checked because there is a case where the size
-        // of the requests isnt equal to the available locks in the semaphore i.e.
-        // when the thread needs to die but the semaphore is waiting for a lock in order
-        // to continue execution
-        if (requests.size() > 0) {
-            QMutexLocker locker(&requestMutex);
-            auto request = requests.takeFirst();
-            locker.unlock();
+        prepareScene(request);
 
-            prepareScene(request);
+        scene->update(0);
+        renderer->renderSceneToRenderTarget(renderTarget, cam, true, false);
 
-            scene->update(0);
-            renderer->renderSceneToRenderTarget(renderTarget, cam, true, false);
+        cleanupScene();
+        request.sceneSource.clear();    // the parsed model isn't needed once it's on the GPU
 
-            cleanupScene();
+        // save contents to file
+        auto img = renderTarget->toImage();
 
-            // save contents to file
-            auto img = renderTarget->toImage();
+        // The project this was requested for was closed while it was rendering
+        if (!queue->isCurrent(request)) continue;
 
-            auto result = new ThumbnailResult;
-            result->id			= request.id;
-            result->type		= request.type;
-            result->path		= request.path;
-            result->preview     = request.preview;
-            result->thumbnail	= img;
+        auto result = new ThumbnailResult;
+        result->id			= request.id;
+        result->type		= request.type;
+        result->path		= request.path;
+        result->preview     = request.preview;
+        result->thumbnail	= img;
+        result->waitTime    = waitTime;
+        result->renderTime  = renderTimer.elapsed();
+        result->queueDepth  = queue->depth();
 
-            emit thumbnailComplete(result);
-        }
+        emit thumbnailComplete(result);
     }
 
+    database.closeDatabase();
+
     // move to main thread to be cleaned up
     // all ui objects must be destroyed on the main thread
     auto mainThread = qApp->instance()->thread();
@@ -156,13 +268,14 @@ void RenderThread::prepareScene(const ThumbnailRequest &request)
     auto guid = request.id;
 
     if (request.type == ThumbnailRequestType::ImportedMesh) {
-        QJsonDocument document = QJsonDocument::fromBinaryData(db->fetchAssetData(guid));
+        if (!openDatabase(request.databasePath)) return;
+
+        QJsonDocument document = QJsonDocument::fromBinaryData(database.fetchAssetData(guid));
         QJsonObject objectHierarchy = document.object();
 
         SceneReader *reader = new SceneReader;
-        reader->setBaseDirectory(IrisUtils::join(
-            Globals::project->getProjectFolder())
-        );
+        reader->setDatabaseHandle(&database);
+        reader->setBaseDirectory(request.projectFolder);
 
         sceneNode = reader->readSceneNode(objectHierarchy);
         delete reader;
@@ -198,9 +311,18 @@ void RenderThread::prepareScene(const ThumbnailRequest &request)
     }
     else if (request.type == ThumbnailRequestType::Mesh)
     {
-		ssource = new iris::SceneSource();
-        // load mesh as scene
-        sceneNode = iris::MeshNode::loadAsSceneFragment(request.path, [&](iris::MeshPtr mesh, iris::MeshMaterialData& data)
+        auto sceneSource = request.sceneSource;
+        if (!sceneSource) {
+            // Nothing was handed over, the mesh cache still spares a full import for anything seen before
+            sceneSource = QSharedPointer<iris::SceneSource>::create();
+            MeshCache::loadScene(&sceneSource->importer, request.path);
+        }
+
+        const aiScene *aiScene = sceneSource->importer.GetScene();
+        if (!aiScene) return;
+
+        // build the scene from the parsed data, only the GPU upload happens here
+        sceneNode = iris::MeshNode::loadAsSceneFragment(request.path, aiScene, [&](iris::MeshPtr mesh, iris::MeshMaterialData& data)
         {
             auto mat = iris::CustomMaterial::create();
             mat->generate(IrisUtils::getAbsoluteAssetPath("app/shader_defs/Default.shader"));
@@ -222,7 +344,7 @@ void RenderThread::prepareScene(const ThumbnailRequest &request)
                 mat->setValue("normalTexture", data.normalTexture);
 
             return mat;
-        }, ssource);
+        });
 
         if (!sceneNode) return;
 
@@ -252,73 +374,15 @@ void RenderThread::prepareScene(const ThumbnailRequest &request)
         cam->update(0);
     }
 	else if (request.type == ThumbnailRequestType::Material) {
+		if (!openDatabase(request.databasePath)) return;
+
 		QFile *file = new QFile(request.path);
 		file->open(QIODevice::ReadOnly | QIODevice::Text);
 		QJsonDocument doc = QJsonDocument::fromJson(file->readAll());
 
-		MaterialReader reader;
-		auto material = reader.parseMaterial(doc.object(), db);
-		/*
-        auto material = iris::CustomMaterial::create();
-		const QJsonObject materialDefinition = doc.object();
-        auto shaderGuid = materialDefinition["guid"].toString();
-        material->setName(materialDefinition["name"].toString());
-        material->setGuid(shaderGuid);
-
-        QFileInfo shaderFile;
-
-        QMapIterator<QString, QString> it(Constants::Reserved::BuiltinShaders);
-        while (it.hasNext()) {
-            it.next();
-            if (it.key() == shaderGuid) {
-                shaderFile = QFileInfo(IrisUtils::getAbsoluteAssetPath(it.value()));
-                break;
-            }
-        }
-
-        if (shaderFile.exists()) {
-            material->generate(shaderFile.absoluteFilePath());
-        }
-        else {
-            // Reading is thread safe...
-            for (auto asset : AssetManager::getAssets()) {
-                if (asset->type == ModelTypes::Shader) {
-                    if (asset->assetGuid == material->getGuid()) {
-                        auto def = asset->getValue().toJsonObject();
-                        auto vertexShader = def["vertex_shader"].toString();
-                        auto fragmentShader = def["fragment_shader"].toString();
-                        for (auto asset : AssetManager::getAssets()) {
-                            if (asset->type == ModelTypes::File) {
-                                if (vertexShader == asset->assetGuid) vertexShader = asset->path;
-                                if (fragmentShader == asset->assetGuid) fragmentShader = asset->path;
-                            }
-                        }
-                        def["vertex_shader"] = vertexShader;
-                        def["fragment_shader"] = fragmentShader;
-                        material->generate(def);
-                    }
-                }
-            }
-        }
-
-		for (const auto &prop : material->properties) {
-			if (materialDefinition.contains(prop->name)) {
-				if (prop->type == iris::PropertyType::Texture) {
-					auto textureStr = !materialDefinition[prop->name].toString().isEmpty()
-										? QDir(QFileInfo(request.path).absolutePath())
-											.filePath(materialDefinition[prop->name].toString())
-										: QString();
-
-					if (!textureStr.isEmpty()) {
-						material->setValue(prop->name, textureStr);
-					}
-				}
-				else {
-					material->setValue(prop->name, materialDefinition[prop->name].toVariant());
-				}
-			}
-		}
-		*/
+		// Shader and texture guids resolve through the worker's own connection against the folder queued with the request
+		MaterialReader reader(TextureSource::Project, request.projectFolder);
+		auto material = reader.parseMaterial(doc.object(), &database);
 		materialNode->setMaterial(material);
 		materialNode->show();
 
@@ -328,6 +392,25 @@ void RenderThread::prepareScene(const ThumbnailRequest &request)
 		cam->update(0);
     }
 }
+bool RenderThread::openDatabase(const QString &path)
+{
+    if (path.isEmpty()) {
+        irisLog("Thumbnail requested without a database to read the asset from!");
+        return false;
+    }
+
+    if (database.getDatabasePath() == path) return true;
+
+    // The project database changed since the last request
+    if (!database.getDatabasePath().isEmpty()) database.closeDatabase();
+    if (!database.openReadOnlyConnection(path, QString("ThumbnailConnection_%1").arg(reinterpret_cast<quintptr>(this)))) {
+        database.closeDatabase();   // so the next request tries again
+        return false;
+    }
+
+    return true;
+}
+
 void RenderThread::cleanupScene()
 {
     if (!!sceneNode) sceneNode->removeFromParent();
@@ -383,8 +466,7 @@ void RenderThread::createMaterial(QJsonObject &matObj, iris::CustomMaterialPtr m
 
 ThumbnailGenerator::ThumbnailGenerator()
 {
-    renderThread = new RenderThread();
-    renderThread->setDatabase(db);
+    db = nullptr;
 
     auto curCtx = QOpenGLContext::currentContext();
     if (curCtx != Q_NULLPTR) curCtx->doneCurrent();
@@ -396,19 +478,34 @@ ThumbnailGenerator::ThumbnailGenerator()
     format.setProfile(QSurfaceFormat::CoreProfile);
     format.setSamples(1);
 
-    auto context = new QOpenGLContext();
-    context->setFormat(format);
-    context->create();
-    context->moveToThread(renderThread);
-    renderThread->context = context;
-
-    auto surface = new QOffscreenSurface();
-    surface->setFormat(context->format());
-    surface->create();
-    surface->moveToThread(renderThread);
-    renderThread->surface = surface;
-
-    renderThread->start();
+    // Drivers serialize a lot of GL work so a couple of workers is where this stops scaling
+    const int workerCount = qBound(1, QThread::idealThreadCount() / 2, 3);
+
+    for (int i = 0; i < workerCount; ++i) {
+        auto renderThread = new RenderThread();
+        renderThread->queue = &queue;
+
+        // Each worker has its own context but shares resources with the rest of the application
+        auto context = new QOpenGLContext();
+        context->setFormat(format);
+        context->setShareContext(QOpenGLContext::globalShareContext());
+        context->create();
+        context->moveToThread(renderThread);
+        renderThread->context = context;
+
+        auto surface = new QOffscreenSurface();
+        surface->setFormat(context->format());
+        surface->create();
+        surface->moveToThread(renderThread);
+        renderThread->surface = surface;
+
+        // Forwarded from the worker thread, receivers get a queued call as before
+        connect(renderThread, &RenderThread::thumbnailComplete,
+                this, &ThumbnailGenerator::thumbnailComplete, Qt::DirectConnection);
+
+        renderThreads.append(renderThread);
+        renderThread->start();
+    }
 }
 
 ThumbnailGenerator *ThumbnailGenerator::getSingleton()
@@ -417,19 +514,69 @@ ThumbnailGenerator *ThumbnailGenerator::getSingleton()
     return instance;
 }
 
-void ThumbnailGenerator::requestThumbnail(ThumbnailRequestType type, QString path, QString id, bool preview)
+void ThumbnailGenerator::requestMeshThumbnail(QString path,
+                                              QString id,
+                                              QSharedPointer<iris::SceneSource> sceneSource,
+                                              ThumbnailPriority priority)
 {
     ThumbnailRequest req;
-    req.type	= type;
-    req.path	= path;
-    req.id		= id;
-    req.preview = preview;
-    renderThread->requestThumbnail(req);
+    req.type        = ThumbnailRequestType::Mesh;
+    req.path        = path;
+    req.id          = id;
+    req.preview     = false;
+    req.priority    = priority;
+    req.queuedAt    = QDateTime::currentMSecsSinceEpoch();
+    req.sceneSource = sceneSource;
+    req.databasePath = db ? db->getDatabasePath() : QString();
+    req.projectFolder = Globals::project ? Globals::project->getProjectFolder() : QString();
+    queue.push(req);
+}
+
+void ThumbnailGenerator::requestThumbnail(ThumbnailRequestType type,
+                                          QString path,
+                                          QString id,
+                                          bool preview,
+                                          ThumbnailPriority priority)
+{
+    ThumbnailRequest req;
+    req.type	 = type;
+    req.path	 = path;
+    req.id		 = id;
+    req.preview  = preview;
+    req.priority = priority;
+    req.queuedAt = QDateTime::currentMSecsSinceEpoch();
+    req.databasePath = db ? db->getDatabasePath() : QString();
+    req.projectFolder = Globals::project ? Globals::project->getProjectFolder() : QString();
+    queue.push(req);
+}
+
+bool ThumbnailGenerator::cancelRequest(const QString &id)
+{
+    return queue.cancel(id);
+}
+
+bool ThumbnailGenerator::prioritiseRequest(const QString &id, ThumbnailPriority priority)
+{
+    return queue.prioritise(id, priority);
+}
+
+void ThumbnailGenerator::cancelAllRequests()
+{
+    queue.cancelAll();
+}
+
+int ThumbnailGenerator::getQueueDepth()
+{
+    return queue.depth();
+}
+
+void ThumbnailGenerator::setDatabase(Database *db)
+{
+    this->db = db;
 }
 
 void ThumbnailGenerator::shutdown()
 {
-    renderThread->shutdown = true;
-    renderThread->requestsAvailable.release();// release 1 so the thread's main loop continues;
-    renderThread->wait();
-}
\ No newline at end of file
+    queue.close();  // wakes every worker so their loops can exit
+    for (auto renderThread : renderThreads) renderThread->wait();
+}
@@ -21,10 +21,13 @@ For more information see the LICENSE file
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
 #include <QOpenGLFunctions_3_2_Core>
+#include <QHash>
 #include <QMutex>
-#include <QSemaphore>
+#include <QWaitCondition>
 #include <QImage>
+#include <QSharedPointer>
 #include <QJsonObject>
+#include <QVector>
 
 #include "core/database/database.h"
 
@@ -35,12 +38,29 @@ enum class ThumbnailRequestType
     ImportedMesh // Stuff that's already in the app to refresh previews
 };
 
+// Lower values are rendered first
+enum class ThumbnailPriority
+{
+    Visible,    // tiles the user is currently looking at
+    Preview,    // previews the user explicitly asked for
+    Background  // imports and other bulk work
+};
+
 struct ThumbnailRequest
 {
     ThumbnailRequestType type;
     QString path;
     QString id;
     bool preview;
+    ThumbnailPriority priority;
+    qint64 queuedAt;    // msecs since epoch, used to report latency
+    int generation;     // requests from before the last cancelAll() are dropped
+    QString databasePath;   // workers read assets through a connection of their own to this file
+    QString projectFolder;  // resolved when queued, workers never touch Globals or the AssetManager
+
+    // Mesh requests only, an importer that already holds the parsed model
+    // When it's missing the scene is read through the mesh cache instead of the source file
+    QSharedPointer<iris::SceneSource> sceneSource;
 };
 
 struct ThumbnailResult
@@ -50,6 +70,40 @@ struct ThumbnailResult
     QString path;
     QString id;
     QImage thumbnail;
+
+    qint64 waitTime;    // time spent in the queue
+    qint64 renderTime;
+    int queueDepth;     // requests still pending when this one finished
+};
+
+// Pending thumbnail requests shared by every render worker
+// Requests are keyed by id (or path when there is none), requesting something that's already
+// pending replaces the queued request and keeps the more urgent of the two priorities
+class ThumbnailQueue
+{
+public:
+    void push(ThumbnailRequest request);
+    // Blocks until a request is available, returns false once the queue is closed
+    bool pop(ThumbnailRequest &request);
+
+    bool cancel(const QString &id);
+    // Moves a pending request to another priority, returns false if nothing with that id is queued
+    bool prioritise(const QString &id, ThumbnailPriority priority);
+    void cancelAll();
+    void close();
+
+    bool isCurrent(const ThumbnailRequest &request);
+    int depth();
+
+private:
+    static QString requestKey(const ThumbnailRequest &request);
+
+    QMutex mutex;
+    QWaitCondition requestsAvailable;
+    QHash<QString, ThumbnailRequest> pending;
+    QList<QString> order[3];    // request keys per priority, oldest first
+    int generation = 0;
+    bool closed = false;
 };
 
 class RenderThread : public QThread
@@ -72,53 +126,68 @@ public:
     iris::CameraNodePtr cam;
     iris::CustomMaterialPtr material;
 
-    QMutex requestMutex;
-    QList<ThumbnailRequest> requests;
-    QSemaphore requestsAvailable;
-
-	iris::SceneSource *ssource;
-    bool shutdown;
+    ThumbnailQueue *queue;
 
     void run() override;
     void initScene();
     void cleanupScene();
-    void requestThumbnail(const ThumbnailRequest& request);
     void prepareScene(const ThumbnailRequest& request);
 
 	void createMaterial(QJsonObject &matObj, iris::CustomMaterialPtr mat);
 
-    Database *db;
-    void setDatabase(Database *db) {
-        this->db = db;
-    }
-
 signals:
     void thumbnailComplete(ThumbnailResult* result);
 
 private:
     float getBoundingRadius(iris::SceneNodePtr node);
     void getBoundingSpheres(iris::SceneNodePtr node, QList<iris::BoundingSphere>& spheres);
+    bool openDatabase(const QString &path);
+
+    // Connections can't be shared between threads, each worker reads through its own
+    Database database;
 };
 
 // http://doc.qt.io/qt-5/qtquick-scenegraph-textureinthread-threadrenderer-cpp.html
-class ThumbnailGenerator
+// A small pool of render threads, each with its own context shared with the application's
+class ThumbnailGenerator : public QObject
 {
+    Q_OBJECT
+
 public:
-    RenderThread* renderThread;
+    QVector<RenderThread*> renderThreads;
     static ThumbnailGenerator* getSingleton();
-    void requestThumbnail(ThumbnailRequestType type, QString path, QString id = "", bool preview = false);
+    void requestThumbnail(ThumbnailRequestType type,
+                          QString path,
+                          QString id = "",
+                          bool preview = false,
+                          ThumbnailPriority priority = ThumbnailPriority::Background);
+    // Renders a mesh from a scene that was already imported, the importer is kept alive until the render is done
+    void requestMeshThumbnail(QString path,
+                              QString id,
+                              QSharedPointer<iris::SceneSource> sceneSource,
+                              ThumbnailPriority priority = ThumbnailPriority::Background);
+
+    // Drops a pending request, a request that's already rendering still completes
+    bool cancelRequest(const QString &id);
+    bool prioritiseRequest(const QString &id, ThumbnailPriority priority);
+    // Drops everything pending and discards results that are still rendering
+    void cancelAllRequests();
+    int getQueueDepth();
 
     // must be called to properly shutdown ui components
     void shutdown();
 
     Database *db;
-    void setDatabase(Database *db) {
-        this->db = db;
-    }
+    void setDatabase(Database *db);
+
+signals:
+    void thumbnailComplete(ThumbnailResult* result);
 
 private:
 	static ThumbnailGenerator* instance;
 	ThumbnailGenerator();
+
+    ThumbnailQueue queue;
 };
 
 #endif // THUMBNAILGENERATOR_H
@@ -23,6 +23,7 @@ For more information see the LICENSE file
 #include "irisgl/src/graphics/graphicshelper.h"
 #include "irisgl/src/graphics/shader.h"
 #include "irisgl/src/math/mathhelper.h"
+#include "core/programcache.h"
 #include "../uimanager.h"
 #include "../widgets/scenenodepropertieswidget.h"
 
@@ -185,7 +186,8 @@ void TranslationGizmo::loadAssets()
 
 	centerMesh = iris::Mesh::loadMesh(IrisUtils::getAbsoluteAssetPath("app/models/axis_sphere.obj"));
 
-	shader = iris::GraphicsHelper::loadShader(
+	// Shared by every gizmo, the cache owns it
+	shader = ProgramCache::load(
 		IrisUtils::getAbsoluteAssetPath("app/shaders/gizmo.vert"),
 		IrisUtils::getAbsoluteAssetPath("app/shaders/gizmo.frag"));
 
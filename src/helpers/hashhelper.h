@@ -0,0 +1,27 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+
+#ifndef HASHHELPER_H
+#define HASHHELPER_H
+
+#include <QByteArray>
+#include <QString>
+
+class HashHelper
+{
+public:
+    // Hex encoded SHA-1 of a file's contents, streamed so large files aren't read in whole
+    // Empty when the file can't be read, safe to call from any thread
+    static QByteArray hashFile(const QString &filePath);
+};
+
+#endif // HASHHELPER_H
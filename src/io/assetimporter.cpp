@@ -0,0 +1,237 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "assetimporter.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QtConcurrent>
+
+#include "irisgl/src/core/logger.h"
+#include "irisgl/src/scenegraph/meshnode.h"
+#include "../core/meshcache.h"
+#include "../core/thumbnailmanager.h"
+#include "../helpers/hashhelper.h"
+
+namespace
+{
+    double toMsecs(qint64 nsecs)
+    {
+        return nsecs / 1000000.0;
+    }
+
+    // items per second of busy time, summed over the workers
+    QString throughput(int count, qint64 nsecs)
+    {
+        if (nsecs <= 0) return QString("-");
+        return QString::number(count / (nsecs / 1000000000.0), 'f', 1);
+    }
+
+    // QtConcurrent::mapped needs result_type to be spelled out for anything that isn't a plain function
+    struct ImportFile
+    {
+        typedef AssetImportResult result_type;
+
+        QHash<QString, QString> projectHashes;
+
+        AssetImportResult operator()(const AssetImportJob &job) const;
+    };
+
+    AssetImportResult ImportFile::operator()(const AssetImportJob &job) const
+    {
+        AssetImportResult result;
+        result.job = job;
+        result.copied = false;
+        result.hashTime = 0;
+        result.copyTime = 0;
+        result.decodeTime = 0;
+        result.parseTime = 0;
+
+        QElapsedTimer stageTimer;
+
+        if (job.deduplicate) {
+            stageTimer.start();
+            result.contentHash = QString::fromLatin1(HashHelper::hashFile(job.sourcePath));
+            result.duplicateOf = projectHashes.value(result.contentHash);
+            result.hashTime = stageTimer.nsecsElapsed();
+
+            // the existing asset is used instead, there's nothing left to do for this one
+            if (!result.contentHash.isEmpty() && !result.duplicateOf.isEmpty()) return result;
+        }
+
+        if (job.type == ModelTypes::Texture) {
+            stageTimer.start();
+            auto thumb = ThumbnailManager::createThumbnail(job.sourcePath, 72, 72);
+            if (!thumb->thumb->isNull()) {
+                QBuffer buffer(&result.thumbnail);
+                buffer.open(QIODevice::WriteOnly);
+                thumb->thumb->save(&buffer, "PNG");
+            }
+            result.decodeTime = stageTimer.nsecsElapsed();
+        }
+
+        if (job.type == ModelTypes::Shader) {
+            stageTimer.start();
+            QFile shaderFile(job.sourcePath);
+            if (shaderFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                result.definition = QJsonDocument::fromJson(shaderFile.readAll()).object();
+            }
+            result.parseTime = stageTimer.nsecsElapsed();
+        }
+
+        if (job.type == ModelTypes::Mesh) {
+            stageTimer.start();
+            // Each job has its own importer, the cache entry written here is also what opening a project reads
+            result.sceneSource = QSharedPointer<iris::SceneSource>::create();
+            if (!MeshCache::loadScene(&result.sceneSource->importer, job.sourcePath)) {
+                irisLog(QString("Couldn't parse model %1").arg(job.sourcePath));
+            }
+            result.parseTime = stageTimer.nsecsElapsed();
+        }
+
+        stageTimer.start();
+        result.copied = QFile::copy(job.sourcePath, job.destination);
+        result.copyTime = stageTimer.nsecsElapsed();
+
+        return result;
+    }
+}
+
+AssetImporter::AssetImporter(QObject *parent) :
+    QObject(parent),
+    nextResult(0),
+    importing(false),
+    canceled(false)
+{
+    connect(&watcher, SIGNAL(resultReadyAt(int)), this, SLOT(deliverResults()));
+    connect(&watcher, SIGNAL(finished()), this, SLOT(finishImport()));
+}
+
+AssetImporter::~AssetImporter()
+{
+    // the receivers may already be gone, nothing is delivered anymore
+    watcher.cancel();
+    watcher.waitForFinished();
+}
+
+void AssetImporter::start(const QVector<AssetImportJob> &jobs, const QHash<QString, QString> &projectHashes)
+{
+    if (importing) {
+        irisLog("An import is already running!");
+        return;
+    }
+
+    importing = true;
+    canceled = false;
+    nextResult = 0;
+    statistics = AssetImportStatistics();
+    timer.start();
+
+    ImportFile importFile;
+    importFile.projectHashes = projectHashes;
+    watcher.setFuture(QtConcurrent::mapped(jobs, importFile));
+}
+
+bool AssetImporter::isImporting() const
+{
+    return importing;
+}
+
+void AssetImporter::waitForFinished()
+{
+    if (!importing) return;
+
+    watcher.waitForFinished();
+    finishImport();
+}
+
+void AssetImporter::cancel()
+{
+    if (!importing || canceled) return;
+
+    canceled = true;
+    watcher.cancel();
+}
+
+void AssetImporter::addCommitTime(qint64 nsecs)
+{
+    statistics.commitTime += nsecs;
+}
+
+void AssetImporter::deliverResults()
+{
+    // Results arrive in whatever order the workers finish, they're handed out in job order
+    auto future = watcher.future();
+    const int total = future.progressMaximum();
+
+    QVector<AssetImportResult> results;
+    while (importing && !canceled && nextResult < total && future.isResultReadyAt(nextResult)) {
+        const AssetImportResult result = future.resultAt(nextResult++);
+
+        statistics.files++;
+        if (!result.duplicateOf.isEmpty()) statistics.duplicates++;
+        if (result.copied) statistics.bytesCopied += QFileInfo(result.job.destination).size();
+        if (!result.thumbnail.isEmpty()) statistics.thumbnails++;
+        if (!!result.sceneSource) statistics.models++;
+        statistics.hashTime += result.hashTime;
+        statistics.copyTime += result.copyTime;
+        statistics.decodeTime += result.decodeTime;
+        statistics.parseTime += result.parseTime;
+
+        results.append(result);
+    }
+
+    if (!results.isEmpty()) emit assetsImported(results, nextResult, total);
+}
+
+void AssetImporter::finishImport()
+{
+    // Called by the watcher and by waitForFinished, whichever gets to a finished import first handles it
+    if (!importing || !watcher.isFinished()) return;
+
+    deliverResults();
+    importing = false;
+    statistics.elapsed = timer.elapsed();
+
+    if (canceled) {
+        // Nothing refers to the copies of jobs that finished but were never handed out
+        auto future = watcher.future();
+        for (int i = nextResult; i < future.progressMaximum(); ++i) {
+            if (!future.isResultReadyAt(i)) continue;
+
+            const AssetImportResult result = future.resultAt(i);
+            if (result.copied) QFile::remove(result.job.destination);
+        }
+
+        irisLog(QString("Import canceled after %1 files").arg(statistics.files));
+    }
+
+    irisLog(QString("Imported %1 files in %2 ms, %3 threads").arg(statistics.files).arg(statistics.elapsed)
+            .arg(QThreadPool::globalInstance()->maxThreadCount()));
+    irisLog(QString("  hash: %1 already in the project, %2 ms busy")
+            .arg(statistics.duplicates).arg(toMsecs(statistics.hashTime), 0, 'f', 1));
+    irisLog(QString("  copy: %1 files, %2 MB, %3 ms busy (%4 files/s per thread)")
+            .arg(statistics.files - statistics.duplicates).arg(statistics.bytesCopied / (1024.0 * 1024.0), 0, 'f', 1)
+            .arg(toMsecs(statistics.copyTime), 0, 'f', 1)
+            .arg(throughput(statistics.files - statistics.duplicates, statistics.copyTime)));
+    irisLog(QString("  thumbnails: %1 images, %2 ms busy (%3 images/s per thread)")
+            .arg(statistics.thumbnails).arg(toMsecs(statistics.decodeTime), 0, 'f', 1)
+            .arg(throughput(statistics.thumbnails, statistics.decodeTime)));
+    irisLog(QString("  models: %1 parsed, %2 ms busy (%3 models/s per thread)")
+            .arg(statistics.models).arg(toMsecs(statistics.parseTime), 0, 'f', 1)
+            .arg(throughput(statistics.models, statistics.parseTime)));
+    irisLog(QString("  database and GL: %1 ms on the GUI thread (%2 files/s)")
+            .arg(toMsecs(statistics.commitTime), 0, 'f', 1).arg(throughput(statistics.files, statistics.commitTime)));
+
+    emit finished(statistics);
+}
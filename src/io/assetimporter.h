@@ -0,0 +1,124 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef ASSETIMPORTER_H
+#define ASSETIMPORTER_H
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "irisgl/src/irisglfwd.h"
+#include "../core/project.h"
+
+namespace iris
+{
+    class SceneSource;
+}
+
+// A single file to import, everything the GUI thread decided up front
+struct AssetImportJob
+{
+    QString sourcePath;
+    QString guid;
+    QString parentGuid;
+    ModelTypes type;
+    QString fileName;       // name in the project folder after duplicates were renamed
+    QString destination;
+    bool deduplicate;       // plain files whose content can be shared with an identical asset
+};
+
+// What the worker stage produced for a job
+struct AssetImportResult
+{
+    AssetImportJob job;
+    bool copied;
+    QString contentHash;                            // deduplicated jobs only
+    QString duplicateOf;                            // guid of the project asset with the same content
+    QByteArray thumbnail;                           // PNG, textures only
+    QJsonObject definition;                         // shaders only
+    QSharedPointer<iris::SceneSource> sceneSource;  // meshes only, parsed and written to the mesh cache
+
+    // time spent in each worker stage in nanoseconds
+    qint64 hashTime;
+    qint64 copyTime;
+    qint64 decodeTime;
+    qint64 parseTime;
+};
+
+struct AssetImportStatistics
+{
+    int files = 0;
+    int duplicates = 0;     // files that weren't copied because the project already had them
+    qint64 bytesCopied = 0;
+    int thumbnails = 0;
+    int models = 0;
+
+    // summed over all workers
+    qint64 hashTime = 0;
+    qint64 copyTime = 0;
+    qint64 decodeTime = 0;
+    qint64 parseTime = 0;
+
+    // spent on the GUI thread writing records and creating GL resources
+    qint64 commitTime = 0;
+    qint64 elapsed = 0;
+};
+
+// Worker stage of asset imports
+// Plain files are hashed first, content the project already has isn't copied or decoded again. Copying, thumbnail decoding, shader parsing and model parsing run for every file at once on the global
+// thread pool. Results are handed back on the GUI thread in the order the jobs were given, as soon as all the
+// jobs before them are done, so dependent assets (materials and models using imported textures) always find
+// what they depend on. Database writes and anything needing a GL context stay with the receiver
+class AssetImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AssetImporter(QObject *parent = Q_NULLPTR);
+    ~AssetImporter();
+
+    // projectHashes maps content hashes to the guids of assets already in the project
+    void start(const QVector<AssetImportJob> &jobs, const QHash<QString, QString> &projectHashes);
+    bool isImporting() const;
+
+    // Blocks until every job is done and delivers the remaining results before returning
+    void waitForFinished();
+    // Stops the import after the results delivered so far, files copied for the rest are removed again
+    void cancel();
+
+    // Adds the time the receiver spent on a result, for the report at the end
+    void addCommitTime(qint64 nsecs);
+    AssetImportStatistics getStatistics() const { return statistics; }
+
+signals:
+    // every result that became ready since the last one, in job order
+    void assetsImported(const QVector<AssetImportResult> &results, int done, int total);
+    void finished(const AssetImportStatistics &statistics);
+
+private slots:
+    void deliverResults();
+    void finishImport();
+
+private:
+    QFutureWatcher<AssetImportResult> watcher;
+    QElapsedTimer timer;
+    AssetImportStatistics statistics;
+    int nextResult;
+    bool importing;
+    bool canceled;
+};
+
+#endif // ASSETIMPORTER_H
@@ -12,44 +12,153 @@ For more information see the LICENSE file
 #include "assetmanager.h"
 
 QVector<Asset*> AssetManager::assets;
+QHash<QString, QVector<Asset*>> AssetManager::guidIndex;
+QHash<QString, QVector<Asset*>> AssetManager::pathIndex;
+QHash<int, QVector<Asset*>> AssetManager::typeIndex;
 
-QVector<Asset*> &AssetManager::getAssets()
+const QVector<Asset*> &AssetManager::getAssets()
 {
     return assets;
 }
 
+const QVector<Asset*> &AssetManager::getAssetsByType(ModelTypes type)
+{
+    static const QVector<Asset*> empty;
+    auto it = typeIndex.constFind(static_cast<int>(type));
+    return it != typeIndex.constEnd() ? it.value() : empty;
+}
+
+QVector<Asset*> AssetManager::getAssetsByGuid(const QString &guid)
+{
+    return guidIndex.value(guid);
+}
+
+QVector<Asset*> AssetManager::getAssetsByPath(const QString &path)
+{
+    return pathIndex.value(path);
+}
+
 void AssetManager::addAsset(Asset *asset)
 {
     assets.append(asset);
+    indexAsset(asset);
 }
 
 void AssetManager::replaceAssets(QString oldAssetGuid, Asset* asset)
 {
 	auto assetOld = getAssedByGuid(oldAssetGuid);
-	if (!assetOld) {
-		assets.append(asset);
-		return;
+	if (assetOld && assetOld != asset) {
+		unindexAsset(assetOld);
+		assets.removeOne(assetOld);
+		delete assetOld;
 	}
 
-	assets.removeOne(assetOld);
-	assets.append(asset);
+	addAsset(asset);
 }
 
+void AssetManager::replaceAsset(Asset *oldAsset, Asset *newAsset)
+{
+    // Keeps the position of the old asset in the list
+    const int index = assets.indexOf(oldAsset);
+    if (index < 0 || oldAsset == newAsset) {
+        if (index < 0) addAsset(newAsset);
+        return;
+    }
 
+    unindexAsset(oldAsset);
+    assets[index] = newAsset;
+    indexAsset(newAsset);
+    delete oldAsset;
+}
+
+void AssetManager::removeAsset(const QString &guid)
+{
+    // Copy since unindexing modifies the bucket we're iterating
+    const auto matches = guidIndex.value(guid);
+    for (auto asset : matches) {
+        unindexAsset(asset);
+        assets.removeOne(asset);
+        delete asset;
+    }
+}
 
 void AssetManager::clearAssetList()
 {
+    qDeleteAll(assets);
     assets.clear();
     assets.squeeze();
+    guidIndex.clear();
+    pathIndex.clear();
+    typeIndex.clear();
 }
 
 Asset* AssetManager::getAssedByGuid(QString guid)
 {
-	for (auto asset : AssetManager::getAssets()) {
-		if (asset->assetGuid == guid) {
-			return asset;
-		}
-	}
+    auto it = guidIndex.constFind(guid);
+    if (it == guidIndex.constEnd() || it.value().isEmpty()) return nullptr;
+    return it.value().first();
+}
+
+Asset* AssetManager::getAssetByGuid(const QString &guid, ModelTypes type)
+{
+    auto it = guidIndex.constFind(guid);
+    if (it == guidIndex.constEnd()) return nullptr;
+
+    for (auto asset : it.value()) {
+        if (asset->type == type) return asset;
+    }
 
-	return nullptr;
-}
\ No newline at end of file
+    return nullptr;
+}
+
+void AssetManager::updateAssetGuid(Asset *asset, const QString &guid)
+{
+    if (asset->assetGuid == guid) return;
+
+    auto it = guidIndex.find(asset->assetGuid);
+    if (it != guidIndex.end()) {
+        it.value().removeOne(asset);
+        if (it.value().isEmpty()) guidIndex.erase(it);
+    }
+
+    asset->assetGuid = guid;
+    guidIndex[guid].append(asset);
+}
+
+void AssetManager::updateAssetPath(Asset *asset, const QString &path)
+{
+    if (asset->path == path) return;
+
+    auto it = pathIndex.find(asset->path);
+    if (it != pathIndex.end()) {
+        it.value().removeOne(asset);
+        if (it.value().isEmpty()) pathIndex.erase(it);
+    }
+
+    asset->path = path;
+    if (!path.isEmpty()) pathIndex[path].append(asset);
+}
+
+void AssetManager::indexAsset(Asset *asset)
+{
+    guidIndex[asset->assetGuid].append(asset);
+    if (!asset->path.isEmpty()) pathIndex[asset->path].append(asset);
+    typeIndex[static_cast<int>(asset->type)].append(asset);
+}
+
+void AssetManager::unindexAsset(Asset *asset)
+{
+    auto guidIt = guidIndex.find(asset->assetGuid);
+    if (guidIt != guidIndex.end()) {
+        guidIt.value().removeOne(asset);
+        if (guidIt.value().isEmpty()) guidIndex.erase(guidIt);
+    }
+
+    auto pathIt = pathIndex.find(asset->path);
+    if (pathIt != pathIndex.end()) {
+        pathIt.value().removeOne(asset);
+        if (pathIt.value().isEmpty()) pathIndex.erase(pathIt);
+    }
+
+    typeIndex[static_cast<int>(asset->type)].removeOne(asset);
+}
@@ -12,6 +12,7 @@ For more information see the LICENSE file
 #ifndef ASSETMANAGER_H
 #define ASSETMANAGER_H
 
+#include <QHash>
 #include <QList>
 #include <QImage>
 #include <QPixmap>
@@ -23,6 +24,8 @@ For more information see the LICENSE file
 class aiScene;
 
 struct Asset {
+    virtual ~Asset() {}
+
     ModelTypes          type;
     QString             path;
     QString             fileName;
@@ -205,15 +208,34 @@ struct AssetMusic : public Asset
 	}
 };
 
+// The manager owns every asset added to it, assets are deleted when removed or when the list is cleared
+// Lookups by guid, type and path are hashed, use updateAssetGuid and updateAssetPath when
+// changing either of those on an asset that was already added so the indices stay valid
 class AssetManager
 {
 public:
-    static QVector<Asset*> assets;
-    static QVector<Asset*>& getAssets();
+    static const QVector<Asset*>& getAssets();
+    static const QVector<Asset*>& getAssetsByType(ModelTypes type);
+    static QVector<Asset*> getAssetsByGuid(const QString &guid);
+    static QVector<Asset*> getAssetsByPath(const QString &path);
     static void addAsset(Asset* asset);
 	static void replaceAssets(QString oldAssetGuid, Asset* asset);
+    static void replaceAsset(Asset *oldAsset, Asset *newAsset);
+    static void removeAsset(const QString &guid);
 	static void clearAssetList();
 	static Asset* getAssedByGuid(QString guid);
+    static Asset* getAssetByGuid(const QString &guid, ModelTypes type);
+    static void updateAssetGuid(Asset *asset, const QString &guid);
+    static void updateAssetPath(Asset *asset, const QString &path);
+
+private:
+    static void indexAsset(Asset *asset);
+    static void unindexAsset(Asset *asset);
+
+    static QVector<Asset*> assets;
+    static QHash<QString, QVector<Asset*>> guidIndex;
+    static QHash<QString, QVector<Asset*>> pathIndex;
+    static QHash<int, QVector<Asset*>> typeIndex;
 };
 
 #endif // ASSETMANAGER_H
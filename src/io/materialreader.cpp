@@ -12,7 +12,11 @@ For more information see the LICENSE file
 #include "materialreader.hpp"
 #include "irisgl.h"
 #include "irisgl/Graphics.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
 #include <QMap>
+#include <QThread>
 #include "../constants.h"
 #include "../io/assetmanager.h"
 #include "../core/database/database.h"
@@ -20,6 +24,7 @@ For more information see the LICENSE file
 #include "../core/thumbnailmanager.h"
 #include "../core/project.h"
 #include "../core/settingsmanager.h"
+#include "../core/shadercache.h"
 
 // iris includes
 #include "irisgl/src/materials/custommaterial.h"
@@ -87,7 +92,7 @@ iris::CustomMaterialPtr MaterialReader::createMaterialFromShaderGuid(QString sha
 	auto shaderObject = getShaderObjectFromId(shaderGuid, db);
 
 	ShaderHandler handler(textureSource, globalSourceFolder);
-	auto material = handler.loadMaterialFromShader(shaderObject, nullptr);
+	auto material = handler.loadMaterialFromShader(shaderObject, db);
 	material->setGuid(shaderGuid);
 
 	return material;
@@ -111,9 +116,7 @@ iris::CustomMaterialPtr MaterialReader::parseMaterial(QJsonObject matObject, Dat
 	auto version = getMaterialVersion(matObject);
 	if (version == 1) matObject = convertV1MaterialToV2(matObject);
 
-	// get shader object
 	auto shaderGuid = matObject["shaderGuid"].toString();
-	auto shaderObject = getShaderObjectFromId(shaderGuid, db);
 	auto material = createMaterialFromShaderGuid(shaderGuid, db);
 
 	// apply values
@@ -137,16 +140,9 @@ iris::CustomMaterialPtr MaterialReader::parseMaterial(QJsonObject matObject, Dat
 			auto vec = readVector4(valuesObj[prop->name].toObject());
 			material->setValue(prop->name, vec);
 		}
-		else if (prop->type == iris::PropertyType::Texture && loadTextures) {
-			if (db != nullptr) {
-				auto texGuid = valuesObj.value(prop->name).toString();
-				QString materialName = db->fetchAsset(texGuid).name;
-				QString textureStr;
-
-				if (textureSource == TextureSource::Project) textureStr = IrisUtils::join(Globals::project->getProjectFolder(), materialName);
-				else textureStr = IrisUtils::join(globalSourceFolder, materialName);
-
-				material->setValue(prop->name, !materialName.isEmpty() ? textureStr : QString());
+		else if (prop->type == iris::PropertyType::Texture) {
+			if (db != nullptr && loadTextures) {
+				material->setValue(prop->name, getTexturePath(valuesObj.value(prop->name).toString(), db));
 			}
 			else {
 				// todo: resolve textures from assets instead
@@ -163,6 +159,35 @@ iris::CustomMaterialPtr MaterialReader::parseMaterial(QJsonObject matObject, Dat
 	return material;
 }
 
+QVector<QPair<QString, QString>> MaterialReader::getTexturePaths(QJsonObject matObject,
+																const iris::CustomMaterialPtr &material,
+																Database* db)
+{
+	QVector<QPair<QString, QString>> textures;
+	if (db == nullptr) return textures;
+
+	if (getMaterialVersion(matObject) == 1) matObject = convertV1MaterialToV2(matObject);
+	auto valuesObj = matObject["values"].toObject();
+
+	for (const auto prop : material->properties) {
+		if (prop->type != iris::PropertyType::Texture) continue;
+
+		auto texturePath = getTexturePath(valuesObj.value(prop->name).toString(), db);
+		if (!texturePath.isEmpty()) textures.append(qMakePair(prop->name, texturePath));
+	}
+
+	return textures;
+}
+
+QString MaterialReader::getTexturePath(const QString &textureGuid, Database* db)
+{
+	QString materialName = db->fetchAsset(textureGuid).name;
+	if (materialName.isEmpty()) return QString();
+
+	if (textureSource == TextureSource::Project) return IrisUtils::join(getProjectFolder(), materialName);
+	return IrisUtils::join(globalSourceFolder, materialName);
+}
+
 //todo : use db when possible
 QJsonObject MaterialReader::getShaderObjectFromId(QString shaderGuid, Database* db)
 {
@@ -173,19 +198,33 @@ QJsonObject MaterialReader::getShaderObjectFromId(QString shaderGuid, Database*
 		shaderFile = QFileInfo(shaderPath);
 	}
 
+	QJsonObject shaderDefinition;
+
 	if (shaderFile.exists()) {
+		// edited builtin files simply miss
+		auto fileKey = QString("%1|%2")
+			.arg(shaderFile.absoluteFilePath())
+			.arg(shaderFile.lastModified().toMSecsSinceEpoch());
+		if (ShaderCache::find(shaderGuid, fileKey, shaderDefinition)) return shaderDefinition;
+
 		QFile file(shaderFile.absoluteFilePath());
 		file.open(QIODevice::ReadOnly);
 		auto data = file.readAll();
-		return QJsonDocument::fromJson(data).object();
+		shaderDefinition = QJsonDocument::fromJson(data).object();
+
+		ShaderCache::insert(shaderGuid, fileKey, shaderDefinition);
+		return shaderDefinition;
 	}
 	else {
+		if (textureSource == TextureSource::Project) globalSourceFolder = getProjectFolder();
+
+		// the vertex and fragment paths are resolved against the source folder so it's part of the key
+		if (ShaderCache::find(shaderGuid, globalSourceFolder, shaderDefinition)) return shaderDefinition;
+
 		// Stop using asset manager... (iKlsR)
 		// TODO remove all usage of such
 		auto shader = db->fetchAssetData(shaderGuid);
-		QJsonObject shaderDefinition = QJsonDocument::fromBinaryData(shader).object();
-
-		if (textureSource == TextureSource::Project) globalSourceFolder = Globals::project->getProjectFolder();
+		shaderDefinition = QJsonDocument::fromBinaryData(shader).object();
 
 		if (!shaderDefinition.isEmpty()) {
 			auto vAsset = db->fetchAsset(shaderDefinition["vertex_shader"].toString());
@@ -194,6 +233,7 @@ QJsonObject MaterialReader::getShaderObjectFromId(QString shaderGuid, Database*
 			if (!vAsset.name.isEmpty()) shaderDefinition["vertex_shader"] = QDir(globalSourceFolder).filePath(vAsset.name);
 			if (!fAsset.name.isEmpty()) shaderDefinition["fragment_shader"] = QDir(globalSourceFolder).filePath(fAsset.name);
 
+			ShaderCache::insert(shaderGuid, globalSourceFolder, shaderDefinition);
 			return shaderDefinition;
 		}
 	}
@@ -201,6 +241,13 @@ QJsonObject MaterialReader::getShaderObjectFromId(QString shaderGuid, Database*
 	return QJsonObject();
 }
 
+QString MaterialReader::getProjectFolder() const
+{
+	// Readers on worker threads are handed the folder, only the GUI thread may look at the open project
+	if (textureSource == TextureSource::Project && !globalSourceFolder.isEmpty()) return globalSourceFolder;
+	return Globals::project->getProjectFolder();
+}
+
 QJsonObject MaterialReader::convertV1MaterialToV2(QJsonObject oldMatObj)
 {
 	QJsonObject newMatObj;
@@ -263,13 +310,18 @@ iris::CustomMaterialPtr ShaderHandler::loadMaterialFromShaderV1(QJsonObject shad
 		if (!vAsset.name.isEmpty()) shaderObject["vertex_shader"] = QDir(assetPath).filePath(vAsset.name);
 		if (!fAsset.name.isEmpty()) shaderObject["fragment_shader"] = QDir(assetPath).filePath(fAsset.name);
 	}
+	else if (db != nullptr && QThread::currentThread() != qApp->thread()) {
+		// The AssetManager belongs to the GUI thread, workers resolve the files through their own connection
+		// Project files sit in the project folder under their asset name, same as getShaderObjectFromId resolves them
+		auto vAsset = db->fetchAsset(vertexShader);
+		auto fAsset = db->fetchAsset(fragmentShader);
+
+		if (!vAsset.name.isEmpty()) shaderObject["vertex_shader"] = QDir(globalSourceFolder).filePath(vAsset.name);
+		if (!fAsset.name.isEmpty()) shaderObject["fragment_shader"] = QDir(globalSourceFolder).filePath(fAsset.name);
+	}
 	else {
-		for (auto asset : AssetManager::getAssets()) {
-			if (asset->type == ModelTypes::File) {
-				if (vertexShader == asset->assetGuid) vertexShader = asset->path;
-				if (fragmentShader == asset->assetGuid) fragmentShader = asset->path;
-			}
-		}
+		if (auto vertexAsset = AssetManager::getAssetByGuid(vertexShader, ModelTypes::File)) vertexShader = vertexAsset->path;
+		if (auto fragmentAsset = AssetManager::getAssetByGuid(fragmentShader, ModelTypes::File)) fragmentShader = fragmentAsset->path;
 
 		shaderObject["vertex_shader"] = vertexShader;
 		shaderObject["fragment_shader"] = fragmentShader;
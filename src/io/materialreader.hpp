@@ -20,6 +20,8 @@ For more information see the LICENSE file
 #include <QJsonValueRef>
 #include <QJsonDocument>
 #include <QSharedPointer>
+#include <QPair>
+#include <QVector>
 
 #include "../irisgl/src/irisglfwd.h"
 #include "assetiobase.h"
@@ -46,6 +48,10 @@ public:
 	// if handle is null then it will try to fetch the assets
 	// from the asset manager
 	iris::CustomMaterialPtr parseMaterial(QJsonObject matObject, Database* handle, bool loadTextures = true);
+	// The (property, path) pairs parseMaterial would load, for materials parsed with loadTextures off
+	QVector<QPair<QString, QString>> getTexturePaths(QJsonObject matObject,
+													 const iris::CustomMaterialPtr &material,
+													 Database* db);
 	iris::CustomMaterialPtr createMaterialFromShaderGuid(QString shaderGuid, Database* db);
 	iris::CustomMaterialPtr createMaterialFromShaderFile(QString shaderPath, Database* db);
 	QJsonObject getShaderObjectFromId(QString shaderGuid, Database* db);
@@ -56,6 +62,10 @@ public:
 	int getMaterialVersion(QJsonObject oldMatObj);
 
 private:
+	QString getTexturePath(const QString &textureGuid, Database* db);
+	// For TextureSource::Project a non empty globalSourceFolder stands in for the open project's folder
+	QString getProjectFolder() const;
+
     QJsonObject parsedShader;
 };
 
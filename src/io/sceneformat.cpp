@@ -0,0 +1,516 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "sceneformat.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStringList>
+#include <QVector>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+
+#include "irisgl/src/core/logger.h"
+
+const quint16 SceneFormat::formatVersion = 1;
+
+namespace
+{
+    const char formatMagic[] = { 'J', 'S', 'C', 'N' };
+    const int headerSize = 6;   // magic and version
+    const int maxDepth = 512;
+
+    enum Tag : quint8
+    {
+        TagNull,
+        TagFalse,
+        TagTrue,
+        TagInteger,     // zigzag varint
+        TagFloat,       // float32, used when the double survives the round trip
+        TagDouble,
+        TagString,      // string table index
+        TagArray,
+        TagObject,
+        TagVector2,     // {x, y} as packed floats
+        TagVector3,
+        TagVector4,
+        TagColor,       // {r, g, b, a} as four bytes
+        TagKeyArray     // animation keys, one contiguous array per field
+    };
+
+    // The fields of a key written by SceneWriter::writeAnimationData, in the order they're packed
+    const char *keyFloatFields[] = { "time", "value", "leftSlope", "rightSlope" };
+    const char *keyStringFields[] = { "leftTangentType", "rightTangentType", "handleMode" };
+    const int keyFieldCount = 7;
+
+    bool isFloatExact(double value)
+    {
+        return double(float(value)) == value;
+    }
+
+    bool isInteger(double value)
+    {
+        // -0 is left to the float path so its sign survives
+        return std::floor(value) == value &&
+               std::abs(value) < 9007199254740992.0 &&
+               !(value == 0 && std::signbit(value));
+    }
+
+    class Encoder
+    {
+    public:
+        QByteArray body;
+        QStringList strings;
+
+        void writeValue(const QJsonValue &value)
+        {
+            switch (value.type()) {
+                case QJsonValue::Bool:
+                    writeByte(value.toBool() ? TagTrue : TagFalse);
+                    break;
+                case QJsonValue::Double:
+                    writeNumber(value.toDouble());
+                    break;
+                case QJsonValue::String:
+                    writeByte(TagString);
+                    writeString(value.toString());
+                    break;
+                case QJsonValue::Array:
+                    writeArray(value.toArray());
+                    break;
+                case QJsonValue::Object:
+                    writeObject(value.toObject());
+                    break;
+                default:
+                    writeByte(TagNull);
+                    break;
+            }
+        }
+
+        void writeObject(const QJsonObject &obj)
+        {
+            if (writePackedVector(obj) || writePackedColor(obj)) return;
+
+            writeByte(TagObject);
+            writeVarint(obj.size());
+            for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+                writeString(it.key());
+                writeValue(it.value());
+            }
+        }
+
+        void writeArray(const QJsonArray &array)
+        {
+            if (writeKeyArray(array)) return;
+
+            writeByte(TagArray);
+            writeVarint(array.size());
+            for (const auto &item : array) writeValue(item);
+        }
+
+        void writeNumber(double value)
+        {
+            if (isInteger(value)) {
+                const qint64 integer = qint64(value);
+                writeByte(TagInteger);
+                writeVarint((quint64(integer) << 1) ^ quint64(integer >> 63));
+            }
+            else if (isFloatExact(value)) {
+                writeByte(TagFloat);
+                writeFloat(float(value));
+            }
+            else {
+                writeByte(TagDouble);
+                quint64 bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                bits = qToLittleEndian(bits);
+                body.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+            }
+        }
+
+        void writeString(const QString &string)
+        {
+            auto it = stringIndex.constFind(string);
+            if (it == stringIndex.constEnd()) {
+                it = stringIndex.insert(string, strings.size());
+                strings.append(string);
+            }
+
+            writeVarint(it.value());
+        }
+
+        void writeByte(quint8 byte)
+        {
+            body.append(char(byte));
+        }
+
+        void writeVarint(quint64 value)
+        {
+            while (value >= 0x80) {
+                body.append(char((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            body.append(char(value));
+        }
+
+        void writeFloat(float value)
+        {
+            quint32 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = qToLittleEndian(bits);
+            body.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+        }
+
+    private:
+        bool writePackedVector(const QJsonObject &obj)
+        {
+            static const char *components[] = { "x", "y", "z", "w" };
+            const int size = obj.size();
+            if (size < 2 || size > 4) return false;
+
+            float values[4];
+            for (int i = 0; i < size; i++) {
+                const QJsonValue value = obj.value(components[i]);
+                if (!value.isDouble() || !isFloatExact(value.toDouble())) return false;
+                values[i] = float(value.toDouble());
+            }
+
+            writeByte(size == 2 ? TagVector2 : size == 3 ? TagVector3 : TagVector4);
+            for (int i = 0; i < size; i++) writeFloat(values[i]);
+            return true;
+        }
+
+        bool writePackedColor(const QJsonObject &obj)
+        {
+            static const char *channels[] = { "r", "g", "b", "a" };
+            if (obj.size() != 4) return false;
+
+            char values[4];
+            for (int i = 0; i < 4; i++) {
+                const QJsonValue value = obj.value(channels[i]);
+                if (!value.isDouble()) return false;
+
+                const double channel = value.toDouble();
+                if (!isInteger(channel) || channel < 0 || channel > 255) return false;
+                values[i] = char(quint8(channel));
+            }
+
+            writeByte(TagColor);
+            body.append(values, 4);
+            return true;
+        }
+
+        bool writeKeyArray(const QJsonArray &array)
+        {
+            if (array.isEmpty()) return false;
+
+            for (const auto &item : array) {
+                if (!item.isObject()) return false;
+
+                const QJsonObject key = item.toObject();
+                if (key.size() != keyFieldCount) return false;
+
+                for (auto field : keyFloatFields) {
+                    const QJsonValue value = key.value(field);
+                    if (!value.isDouble() || !isFloatExact(value.toDouble())) return false;
+                }
+
+                for (auto field : keyStringFields) {
+                    if (!key.value(field).isString()) return false;
+                }
+            }
+
+            writeByte(TagKeyArray);
+            writeVarint(array.size());
+
+            for (auto field : keyFloatFields) {
+                for (const auto &item : array) writeFloat(float(item.toObject().value(field).toDouble()));
+            }
+
+            for (auto field : keyStringFields) {
+                for (const auto &item : array) writeString(item.toObject().value(field).toString());
+            }
+
+            return true;
+        }
+
+        QHash<QString, quint32> stringIndex;
+    };
+
+    class Decoder
+    {
+    public:
+        Decoder(const char *data, int size) : pos(data), end(data + size), ok(true) {}
+
+        const char *pos;
+        const char *end;
+        bool ok;
+        QStringList strings;
+
+        bool readStrings()
+        {
+            const quint64 count = readVarint();
+            if (!ok || count > quint64(end - pos)) return fail();
+
+            strings.reserve(int(count));
+            for (quint64 i = 0; i < count; i++) {
+                const quint64 length = readVarint();
+                if (!ok || length > quint64(end - pos)) return fail();
+
+                strings.append(QString::fromUtf8(pos, int(length)));
+                pos += length;
+            }
+
+            return true;
+        }
+
+        QJsonValue readValue(int depth = 0)
+        {
+            if (depth > maxDepth) {
+                fail();
+                return QJsonValue();
+            }
+
+            switch (readByte()) {
+                case TagNull:       return QJsonValue();
+                case TagFalse:      return false;
+                case TagTrue:       return true;
+                case TagInteger: {
+                    const quint64 zigzag = readVarint();
+                    return double(qint64(zigzag >> 1) ^ -qint64(zigzag & 1));
+                }
+                case TagFloat:      return double(readFloat());
+                case TagDouble:     return readDouble();
+                case TagString:     return readString();
+                case TagArray:      return readArray(depth);
+                case TagObject:     return readObject(depth);
+                case TagVector2:    return readVector(2);
+                case TagVector3:    return readVector(3);
+                case TagVector4:    return readVector(4);
+                case TagColor:      return readColor();
+                case TagKeyArray:   return readKeyArray();
+                default:
+                    fail();
+                    return QJsonValue();
+            }
+        }
+
+    private:
+        bool fail()
+        {
+            ok = false;
+            pos = end;
+            return false;
+        }
+
+        // Every encoded value takes at least one byte, larger counts can only come from a corrupt blob
+        bool checkCount(quint64 count, quint64 bytesPerItem)
+        {
+            return ok && count <= quint64(end - pos) / bytesPerItem ? true : fail();
+        }
+
+        QJsonArray readArray(int depth)
+        {
+            QJsonArray array;
+            const quint64 count = readVarint();
+            if (!checkCount(count, 1)) return array;
+
+            for (quint64 i = 0; i < count && ok; i++) array.append(readValue(depth + 1));
+            return array;
+        }
+
+        QJsonObject readObject(int depth)
+        {
+            QJsonObject obj;
+            const quint64 count = readVarint();
+            if (!checkCount(count, 2)) return obj;
+
+            for (quint64 i = 0; i < count && ok; i++) {
+                const QString key = readString();
+                obj.insert(key, readValue(depth + 1));
+            }
+
+            return obj;
+        }
+
+        QJsonObject readVector(int size)
+        {
+            static const char *components[] = { "x", "y", "z", "w" };
+            QJsonObject obj;
+            for (int i = 0; i < size; i++) obj.insert(components[i], double(readFloat()));
+            return obj;
+        }
+
+        QJsonObject readColor()
+        {
+            static const char *channels[] = { "r", "g", "b", "a" };
+            QJsonObject obj;
+            for (int i = 0; i < 4; i++) obj.insert(channels[i], int(readByte()));
+            return obj;
+        }
+
+        QJsonArray readKeyArray()
+        {
+            QJsonArray array;
+            const quint64 count = readVarint();
+            if (!checkCount(count, sizeof(float) * 4 + 3)) return array;
+
+            QVector<QJsonObject> keys(int(count));
+            for (auto field : keyFloatFields) {
+                for (auto &key : keys) key.insert(field, double(readFloat()));
+            }
+
+            for (auto field : keyStringFields) {
+                for (auto &key : keys) key.insert(field, readString());
+            }
+
+            for (const auto &key : keys) array.append(key);
+            return array;
+        }
+
+        QString readString()
+        {
+            const quint64 index = readVarint();
+            if (!ok || index >= quint64(strings.size())) {
+                fail();
+                return QString();
+            }
+
+            return strings[int(index)];
+        }
+
+        quint8 readByte()
+        {
+            if (pos >= end) {
+                fail();
+                return 0;
+            }
+
+            return quint8(*pos++);
+        }
+
+        quint64 readVarint()
+        {
+            quint64 value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const quint8 byte = readByte();
+                value |= quint64(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+
+            fail();
+            return 0;
+        }
+
+        float readFloat()
+        {
+            if (end - pos < 4) {
+                fail();
+                return 0;
+            }
+
+            const quint32 bits = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(pos));
+            pos += 4;
+
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        double readDouble()
+        {
+            if (end - pos < 8) {
+                fail();
+                return 0;
+            }
+
+            const quint64 bits = qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(pos));
+            pos += 8;
+
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+}
+
+QByteArray SceneFormat::encode(const QJsonObject &projectObj)
+{
+    Encoder encoder;
+    encoder.writeObject(projectObj);
+
+    Encoder table;
+    table.writeVarint(encoder.strings.size());
+    for (const auto &string : encoder.strings) {
+        const QByteArray utf8 = string.toUtf8();
+        table.writeVarint(utf8.size());
+        table.body.append(utf8);
+    }
+
+    const quint16 version = qToLittleEndian(formatVersion);
+
+    QByteArray blob;
+    blob.reserve(headerSize + table.body.size() + encoder.body.size());
+    blob.append(formatMagic, sizeof(formatMagic));
+    blob.append(reinterpret_cast<const char*>(&version), sizeof(version));
+    blob.append(table.body);
+    blob.append(encoder.body);
+
+    return blob;
+}
+
+bool SceneFormat::decode(const QByteArray &blob, QJsonObject &projectObj)
+{
+    if (!isSceneFormat(blob)) {
+        const QJsonDocument doc = QJsonDocument::fromBinaryData(blob);
+        if (!doc.isObject()) return false;
+
+        projectObj = doc.object();
+        return true;
+    }
+
+    const quint16 version = qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(blob.constData()) + 4);
+    if (version > formatVersion) {
+        irisLog(QString("Scene was saved with a newer format (version %1)!").arg(version));
+        return false;
+    }
+
+    Decoder decoder(blob.constData() + headerSize, blob.size() - headerSize);
+    decoder.readStrings();
+
+    // Nothing may follow the root object
+    const QJsonValue root = decoder.readValue();
+    if (!decoder.ok || !root.isObject() || decoder.pos != decoder.end) {
+        irisLog("Couldn't decode the scene, the data is corrupt!");
+        return false;
+    }
+
+    projectObj = root.toObject();
+    return true;
+}
+
+bool SceneFormat::isSceneFormat(const QByteArray &blob)
+{
+    return blob.size() > headerSize && std::memcmp(blob.constData(), formatMagic, sizeof(formatMagic)) == 0;
+}
+
+QByteArray SceneFormat::toBinaryJson(const QByteArray &blob)
+{
+    if (!isSceneFormat(blob)) return blob;
+
+    QJsonObject projectObj;
+    if (!decode(blob, projectObj)) return QByteArray();
+
+    return QJsonDocument(projectObj).toBinaryData();
+}
@@ -0,0 +1,42 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef SCENEFORMAT_H
+#define SCENEFORMAT_H
+
+#include <QByteArray>
+#include <QJsonObject>
+
+/**
+ * Compact binary encoding of the project object SceneWriter builds and SceneReader reads
+ * It's a lossless encoding of the same JSON tree so the reader and writer keep working on QJsonObjects:
+ *  - every key and string is stored once in a string table and referenced by index
+ *  - vectors and colours ({x, y, z}, {r, g, b, a}, ...) are packed as plain floats and bytes
+ *  - animation key lists are stored as contiguous arrays, one per field
+ * Numbers that don't fit the packed forms fall back to full doubles so nothing is ever rounded
+ * Qt's binary JSON stays the interchange format (exports, imports), SceneFormat::toBinaryJson converts to it
+ */
+class SceneFormat
+{
+public:
+    static QByteArray encode(const QJsonObject &projectObj);
+
+    // Accepts both this format and scenes saved as Qt binary JSON by older versions
+    static bool decode(const QByteArray &blob, QJsonObject &projectObj);
+
+    static bool isSceneFormat(const QByteArray &blob);
+    static QByteArray toBinaryJson(const QByteArray &blob);
+
+    // Bump when the encoding changes, older versions are still decoded
+    static const quint16 formatVersion;
+};
+
+#endif // SCENEFORMAT_H
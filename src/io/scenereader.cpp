@@ -21,6 +21,8 @@ For more information see the LICENSE file
 
 #include "materialreader.hpp"
 #include "scenereader.h"
+#include "sceneformat.h"
+#include "scenestreamer.h"
 #include "assetmanager.h"
 #include "core/guidmanager.h"
 
@@ -37,6 +39,7 @@ For more information see the LICENSE file
 
 #include "irisgl/src/graphics/postprocess.h"
 #include "irisgl/src/graphics/postprocessmanager.h"
+#include "irisgl/src/core/logger.h"
 
 #include "../irisgl/src/postprocesses/bloompostprocess.h"
 #include "../irisgl/src/postprocesses/coloroverlaypostprocess.h"
@@ -51,6 +54,7 @@ For more information see the LICENSE file
 
 #include "materialreader.hpp"
 #include "../core/guidmanager.h"
+#include "../core/texturecache.h"
 
 iris::ScenePtr SceneReader::readScene(const QString &projectPath,
                                       const QByteArray &sceneBlob,
@@ -59,8 +63,10 @@ iris::ScenePtr SceneReader::readScene(const QString &projectPath,
 {
     dir = projectPath;
 	useAlternativeLocation = false;
-    auto doc = QJsonDocument::fromBinaryData(sceneBlob);
-    auto projectObj = doc.object();
+    QJsonObject projectObj;
+    if (!SceneFormat::decode(sceneBlob, projectObj)) {
+        irisLog("Couldn't read the project scene!");
+    }
 
     auto scene = readScene(projectObj);
 
@@ -196,7 +202,7 @@ iris::ScenePtr SceneReader::readScene(QJsonObject& projectObj)
 		case iris::SkyType::EQUIRECTANGULAR: {
 			QString textureGuid = scene->skyData.value("Equirectangular").value("equiSkyGuid").toString();
 			auto image = IrisUtils::join(Globals::project->getProjectFolder(), handle->fetchAsset(textureGuid).name);
-			if (QFileInfo(image).isFile()) scene->setSkyTexture(iris::Texture2D::load(image, false));
+			if (QFileInfo(image).isFile()) scene->setSkyTexture(TextureCache::loadAsset(textureGuid, image, false));
 			break;
 		}
 
@@ -215,20 +221,8 @@ iris::ScenePtr SceneReader::readScene(QJsonObject& projectObj)
 				sides[i] = QFileInfo(path).isFile() ? path : QString();
 			}
 
-			// We need at least one valid image to get some metadata from
-			QImage* info;
-			bool useTex = false;
-			for (const auto image : sides) {
-				if (!image.isEmpty()) {
-					info = new QImage(image);
-					useTex = true;
-					break;
-				}
-			}
-
-			if (useTex) {
-				scene->setSkyTexture(iris::Texture2D::createCubeMap(sides[0], sides[1], sides[2], sides[3], sides[4], sides[5], info));
-			}
+			auto cubeMap = TextureCache::loadCubeMap(sides[0], sides[1], sides[2], sides[3], sides[4], sides[5]);
+			if (!!cubeMap) scene->setSkyTexture(cubeMap);
 
 			break;
 		}
@@ -469,13 +463,20 @@ iris::MeshNodePtr SceneReader::createMesh(QJsonObject& nodeObj)
     QString meshGUID = nodeObj["guid"].toString();
 
     if (!source.isEmpty()) {
-        auto mesh = getMesh(source, meshIndex);
-
         if (source.startsWith(":")) {
             meshNode->setMesh(source);
 			meshNode->meshPath = source;
+        } else if (streamer) {
+            auto bounds = nodeObj["bounds"].toObject();
+            streamer->addMesh(meshNode,
+                              source,
+                              meshIndex,
+                              !bounds.isEmpty(),
+                              readVector3(bounds["min"].toObject()),
+                              readVector3(bounds["max"].toObject()));
+			meshNode->meshPath = nodeObj["mesh"].toString();
         } else {
-            meshNode->setMesh(mesh);
+            meshNode->setMesh(getMesh(source, meshIndex));
 			meshNode->meshPath = nodeObj["mesh"].toString();
         }
 
@@ -484,7 +485,7 @@ iris::MeshNodePtr SceneReader::createMesh(QJsonObject& nodeObj)
         meshNode->meshIndex = meshIndex;
     }
 
-    auto material = readMaterial(nodeObj);
+    auto material = readMaterial(nodeObj, meshNode);
     meshNode->setMaterial(material);
 
     QString faceCullingMode = nodeObj["faceCullingMode"].toString("back");
@@ -545,9 +546,9 @@ iris::LightNodePtr SceneReader::createLight(QJsonObject& nodeObj)
 
     //TODO: move this to the sceneview widget or somewhere more appropriate
     if (lightNode->lightType == iris::LightType::Directional) {
-        lightNode->icon = iris::Texture2D::load(":/icons/light.png");
+        lightNode->icon = TextureCache::load(":/icons/light.png");
     } else {
-        lightNode->icon = iris::Texture2D::load(":/icons/bulb.png");
+        lightNode->icon = TextureCache::load(":/icons/bulb.png");
     }
 
     lightNode->iconSize = 0.5f;
@@ -583,7 +584,7 @@ iris::ParticleSystemNodePtr SceneReader::createParticleSystem(QJsonObject& nodeO
 
     QString textureStr = QDir(assetDirectory).filePath(handle->fetchAsset(nodeObj["texture"].toString()).name);
 
-    particleNode->setTexture(iris::Texture2D::load(getAbsolutePath(textureStr)));
+    particleNode->setTexture(TextureCache::load(getAbsolutePath(textureStr)));
 	particleNode->setVisible(nodeObj["visible"].toBool(true));
 
     return particleNode;
@@ -643,13 +644,20 @@ iris::HandleMode SceneReader::getHandleModeFromName(QString handleMode)
  * @param nodeObj
  * @return
  */
-iris::MaterialPtr SceneReader::readMaterial(QJsonObject& nodeObj)
+iris::MaterialPtr SceneReader::readMaterial(QJsonObject& nodeObj, const iris::SceneNodePtr &owner)
 {
 	MaterialReader reader;
 	if (useAlternativeLocation) reader.setSource(TextureSource::GlobalAssets, assetDirectory);
     if (nodeObj["material"].isNull()) return iris::CustomMaterial::create();
 
 	auto mat = nodeObj["material"].toObject();
+
+	if (streamer && !!owner) {
+		auto material = reader.parseMaterial(mat, handle, false);
+		streamer->addTextures(owner, material, reader.getTexturePaths(mat, material, handle));
+		return material;
+	}
+
 	return reader.parseMaterial(mat, handle, true);
    
 /*
@@ -740,7 +748,8 @@ void SceneReader::extractAssetsFromAssimpScene(QString filePath)
 		    iris::GraphicsHelper::loadAllMeshesAndAnimationsFromFile(filePath, meshList, animationss);
         }
         else {
-            iris::GraphicsHelper::loadAllMeshesAndAnimationsFromStore<Asset*>(AssetManager::getAssets(),
+            // Only hand over the assets backed by this file instead of the whole store
+            iris::GraphicsHelper::loadAllMeshesAndAnimationsFromStore<Asset*>(AssetManager::getAssetsByPath(filePath),
                 filePath,
                 meshList,
                 animationss);
@@ -35,6 +35,7 @@ class EditorData;
 class aiScene;
 
 class Database;	// this is a temp way to get this working, remove later
+class SceneStreamer;
 
 class SceneReader : public AssetIOBase
 {
@@ -43,6 +44,7 @@ class SceneReader : public AssetIOBase
     QHash<QString,QMap<QString, iris::SkeletalAnimationPtr>> animations;
 
 	Database *handle;
+    SceneStreamer *streamer = nullptr;
     // We can choose to load assets from a flat file or from those already cached
     // TODO - also cache assets in the viewer
 public:
@@ -50,6 +52,11 @@ public:
 		this->handle = db;
 	}
 
+    // Meshes and material textures are handed to the streamer instead of being loaded while reading
+    void setStreamer(SceneStreamer *streamer) {
+        this->streamer = streamer;
+    }
+
     QString assetDirectory = Globals::project->getProjectFolder();
     bool useAlternativeLocation;
     void setBaseDirectory(const QString &location) {
@@ -112,7 +119,7 @@ public:
      * @param nodeObj
      * @return
      */
-    iris::MaterialPtr readMaterial(QJsonObject &nodeObj);
+    iris::MaterialPtr readMaterial(QJsonObject &nodeObj, const iris::SceneNodePtr &owner = iris::SceneNodePtr());
 
     // extracts meshes and animations from model file
     void extractAssetsFromAssimpScene(QString filePath);
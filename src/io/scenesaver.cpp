@@ -0,0 +1,154 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "scenesaver.h"
+#include "sceneformat.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QtConcurrent>
+
+#include "irisgl/src/core/logger.h"
+#include "../core/database/database.h"
+
+SceneSaver::SceneSaver(Database *db, QObject *parent) :
+    QObject(parent),
+    db(db),
+    pending(false),
+    hasQueued(false)
+{
+    connect(&watcher, SIGNAL(finished()), this, SLOT(finishSave()));
+}
+
+SceneSaver::~SceneSaver()
+{
+    waitForFinished();
+}
+
+void SceneSaver::save(const SceneSnapshot &snapshot)
+{
+    if (pending) {
+        queued = snapshot;
+        hasQueued = true;
+        return;
+    }
+
+    start(snapshot);
+}
+
+void SceneSaver::waitForFinished()
+{
+    while (pending) {
+        watcher.waitForFinished();
+        finishSave();
+    }
+}
+
+bool SceneSaver::isSaving() const
+{
+    return pending;
+}
+
+void SceneSaver::start(const SceneSnapshot &snapshot)
+{
+    pending = true;
+    watcher.setFuture(QtConcurrent::run(this, &SceneSaver::write, snapshot));
+}
+
+void SceneSaver::finishSave()
+{
+    // Called by the watcher and by waitForFinished, whichever gets to a finished save first handles it
+    if (!pending || !watcher.isFinished()) return;
+    pending = false;
+
+    const SceneSaveResult result = watcher.result();
+    if (result.written) {
+        irisLog(QString("Project saved in %1 ms, %2 of %3 top level nodes changed")
+                .arg(result.elapsed).arg(result.changedSubtrees).arg(result.totalSubtrees));
+    }
+
+    emit sceneSaved(result);
+
+    if (hasQueued) {
+        hasQueued = false;
+        start(queued);
+        queued = SceneSnapshot();
+    }
+}
+
+SceneSaveResult SceneSaver::write(const SceneSnapshot &snapshot)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    SceneSaveResult result;
+    result.projectGuid = snapshot.projectGuid;
+    result.written = false;
+    result.changedSubtrees = 0;
+
+    // Split the top level nodes off so each one can be compared with what the last save wrote
+    QJsonObject project = snapshot.projectObj;
+    QJsonObject sceneObj = project["scene"].toObject();
+    QJsonObject rootNodeObj = sceneObj["rootNode"].toObject();
+    const QJsonArray children = rootNodeObj["children"].toArray();
+    rootNodeObj.remove("children");
+    sceneObj["rootNode"] = rootNodeObj;
+    project["scene"] = sceneObj;
+
+    const bool sameProject = savedProjectGuid == snapshot.projectGuid;
+
+    QHash<QString, QJsonObject> subtrees;
+    QStringList order;
+    subtrees.reserve(children.size());
+    order.reserve(children.size());
+    for (const auto &child : children) {
+        const QJsonObject childObj = child.toObject();
+        const QString guid = childObj["guid"].toString();
+        if (!sameProject || savedSubtrees.value(guid) != childObj) result.changedSubtrees++;
+        subtrees.insert(guid, childObj);
+        order.append(guid);
+    }
+
+    result.totalSubtrees = children.size();
+
+    // Nothing to write when nothing was edited
+    // The order catches nodes that were only moved, added or removed, which the hash by guid can't tell apart
+    if (sameProject &&
+        result.changedSubtrees == 0 &&
+        order == savedOrder &&
+        project == savedProject)
+    {
+        result.elapsed = timer.elapsed();
+        return result;
+    }
+
+    const QByteArray sceneBlob = SceneFormat::encode(snapshot.projectObj);
+
+    QBuffer buffer(&result.thumbnail);
+    buffer.open(QIODevice::WriteOnly);
+    snapshot.screenshot.save(&buffer, "PNG");
+
+    if (db->updateProjectConcurrent(snapshot.projectGuid, sceneBlob, result.thumbnail)) {
+        savedProjectGuid = snapshot.projectGuid;
+        savedProject = project;
+        savedSubtrees = subtrees;
+        savedOrder = order;
+        result.written = true;
+    }
+    else {
+        // Whatever is in the database now is unknown, make sure the next save writes everything
+        savedProjectGuid.clear();
+    }
+
+    result.elapsed = timer.elapsed();
+    return result;
+}
@@ -0,0 +1,86 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef SCENESAVER_H
+#define SCENESAVER_H
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QJsonObject>
+#include <QObject>
+#include <QStringList>
+
+class Database;
+
+// Everything a project save writes, taken on the GUI thread
+// QJsonObject and QImage are implicitly shared so handing the snapshot to the worker copies nothing
+struct SceneSnapshot
+{
+    QString projectGuid;
+    QJsonObject projectObj;
+    QImage screenshot;
+};
+
+struct SceneSaveResult
+{
+    QString projectGuid;
+    QByteArray thumbnail;
+    bool written;           // false when the write failed or nothing changed since the last save
+    int changedSubtrees;    // top level nodes that differ from the last save of this project
+    int totalSubtrees;
+    qint64 elapsed;
+};
+
+// Writes project saves on a worker thread
+// Encoding, PNG compression and the database write happen off the GUI thread. Only one save runs at a time,
+// a save requested while another is running waits behind it and replaces any save already waiting
+// A save identical to the last one is skipped, anything else encodes the whole project again since the
+// SceneFormat string table is shared by the whole document and encoded subtrees can't be spliced in
+class SceneSaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SceneSaver(Database *db, QObject *parent = Q_NULLPTR);
+    ~SceneSaver();
+
+    void save(const SceneSnapshot &snapshot);
+
+    // Blocks until the running save and the one waiting behind it are written
+    // Used before anything that reads the project back from the database or closes it
+    void waitForFinished();
+    bool isSaving() const;
+
+signals:
+    void sceneSaved(const SceneSaveResult &result);
+
+private slots:
+    void finishSave();
+
+private:
+    void start(const SceneSnapshot &snapshot);
+    SceneSaveResult write(const SceneSnapshot &snapshot);
+
+    Database *db;
+    QFutureWatcher<SceneSaveResult> watcher;
+    bool pending;
+    bool hasQueued;
+    SceneSnapshot queued;
+
+    // What the last successful save wrote, only touched by the worker since saves never overlap
+    QString savedProjectGuid;
+    QJsonObject savedProject;                   // the project object with the root node's children left out
+    QHash<QString, QJsonObject> savedSubtrees;  // top level nodes by guid
+    QStringList savedOrder;                     // their guids in scene order
+};
+
+#endif // SCENESAVER_H
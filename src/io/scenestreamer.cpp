@@ -0,0 +1,294 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "scenestreamer.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#include "scenereader.h"
+#include "irisgl/src/materials/custommaterial.h"
+#include "irisgl/src/scenegraph/meshnode.h"
+#include "irisgl/src/scenegraph/scenenode.h"
+
+namespace
+{
+    // Pending resources are only reordered once the camera has moved this far since the last sort
+    const float resortDistance = 2.0f;
+    const qint64 prefetchChunkSize = 1 << 20;
+
+    // Textures are only streamed into properties nothing else has set since the scene was read
+    bool isTextureUnset(const iris::CustomMaterialPtr &material, const QString &property)
+    {
+        for (auto prop : material->properties) {
+            if (prop->name == property) return prop->getValue().toString().isEmpty();
+        }
+
+        return false;
+    }
+
+    // Pairs each node under original with its counterpart under duplicate, duplicates keep the child order
+    void mapDuplicate(const iris::SceneNodePtr &original,
+                      const iris::SceneNodePtr &duplicate,
+                      QHash<const iris::SceneNode*, iris::SceneNodePtr> &nodes)
+    {
+        nodes.insert(original.data(), duplicate);
+
+        const int count = qMin(original->children.size(), duplicate->children.size());
+        for (int i = 0; i < count; i++) {
+            mapDuplicate(original->children[i], duplicate->children[i], nodes);
+        }
+    }
+}
+
+SceneStreamer::SceneStreamer() :
+    sorted(false),
+    cancelPrefetch(false)
+{
+}
+
+SceneStreamer::~SceneStreamer()
+{
+    stopPrefetch();
+}
+
+void SceneStreamer::addMesh(const iris::MeshNodePtr &node,
+                            const QString &source,
+                            int meshIndex,
+                            bool hasBounds,
+                            const QVector3D &boundsMin,
+                            const QVector3D &boundsMax)
+{
+    PendingResource resource;
+    resource.type = ResourceType::Mesh;
+    resource.node = node;
+    resource.path = source;
+    resource.meshIndex = meshIndex;
+    resource.hasBounds = hasBounds;
+    resource.boundsMin = boundsMin;
+    resource.boundsMax = boundsMax;
+    resource.distance = 0;
+
+    pending.append(resource);
+    sorted = false;
+}
+
+void SceneStreamer::addTextures(const iris::SceneNodePtr &node,
+                                const iris::CustomMaterialPtr &material,
+                                const QVector<QPair<QString, QString>> &textures)
+{
+    for (const auto &texture : textures) {
+        PendingResource resource;
+        resource.type = ResourceType::Texture;
+        resource.node = node;
+        resource.material = material;
+        resource.property = texture.first;
+        resource.path = texture.second;
+        resource.meshIndex = 0;
+        resource.hasBounds = false;
+        resource.distance = 0;
+
+        pending.append(resource);
+    }
+
+    sorted = false;
+}
+
+void SceneStreamer::addDuplicate(const iris::SceneNodePtr &original, const iris::SceneNodePtr &duplicate)
+{
+    QHash<const iris::SceneNode*, iris::SceneNodePtr> nodes;
+    mapDuplicate(original, duplicate, nodes);
+
+    const int count = pending.size();
+    for (int i = 0; i < count; i++) {
+        PendingResource resource = pending[i];
+
+        auto node = resource.node.toStrongRef();
+        if (!node || !nodes.contains(node.data())) continue;
+
+        auto copy = nodes.value(node.data());
+        if (resource.type == ResourceType::Texture) {
+            if (copy->sceneNodeType != iris::SceneNodeType::Mesh) continue;
+            resource.material = copy.staticCast<iris::MeshNode>()->getMaterial().staticCast<iris::CustomMaterial>();
+        }
+
+        resource.node = copy;
+        pending.append(resource);
+    }
+
+    sorted = false;
+}
+
+void SceneStreamer::start(SceneReader *reader, const QVector3D &cameraPos)
+{
+    this->reader.reset(reader);
+    sortPending(cameraPos);
+
+    QStringList texturePaths;
+    QSet<QString> seen;
+    for (auto it = pending.crbegin(); it != pending.crend(); ++it) {
+        if (it->type == ResourceType::Texture && !seen.contains(it->path)) {
+            seen.insert(it->path);
+            texturePaths.append(it->path);
+        }
+    }
+
+    if (!texturePaths.isEmpty()) {
+        prefetchFuture = QtConcurrent::run(this, &SceneStreamer::prefetch, texturePaths);
+    }
+}
+
+bool SceneStreamer::update(const QVector3D &cameraPos, int budgetMs)
+{
+    if (pending.isEmpty()) return true;
+
+    if (!sorted || (cameraPos - sortedFrom).lengthSquared() > resortDistance * resortDistance) {
+        sortPending(cameraPos);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // At least one load per frame, a single large mesh can take longer than the whole budget
+    do {
+        load(pending.takeLast());
+    } while (!pending.isEmpty() && timer.elapsed() < budgetMs);
+
+    if (pending.isEmpty()) {
+        stopPrefetch();
+        reader.reset();
+    }
+
+    return pending.isEmpty();
+}
+
+SceneStreamer::PendingValues SceneStreamer::getPendingValues() const
+{
+    PendingValues values;
+
+    for (const auto &resource : pending) {
+        auto node = resource.node.toStrongRef();
+        if (!node) continue;
+
+        if (resource.type == ResourceType::Mesh) {
+            if (resource.hasBounds) {
+                values.bounds.insert(node.data(), qMakePair(resource.boundsMin, resource.boundsMax));
+            }
+        }
+        else if (auto material = resource.material.toStrongRef()) {
+            if (isTextureUnset(material, resource.property)) {
+                values.textures[material.data()].insert(resource.property, resource.path);
+            }
+        }
+    }
+
+    return values;
+}
+
+void SceneStreamer::finish()
+{
+    stopPrefetch();
+
+    while (!pending.isEmpty()) load(pending.takeLast());
+    reader.reset();
+}
+
+bool SceneStreamer::isFinished() const
+{
+    return pending.isEmpty();
+}
+
+int SceneStreamer::getPendingCount() const
+{
+    return pending.size();
+}
+
+QVector<QMatrix4x4> SceneStreamer::getPlaceholders() const
+{
+    QVector<QMatrix4x4> placeholders;
+
+    for (const auto &resource : pending) {
+        if (resource.type != ResourceType::Mesh || !resource.hasBounds) continue;
+
+        auto node = resource.node.toStrongRef();
+        if (!node || !node->isVisible()) continue;
+
+        QMatrix4x4 transform = node->getGlobalTransform();
+        transform.translate((resource.boundsMin + resource.boundsMax) * 0.5f);
+        transform.scale(resource.boundsMax - resource.boundsMin);
+        placeholders.append(transform);
+    }
+
+    return placeholders;
+}
+
+void SceneStreamer::sortPending(const QVector3D &cameraPos)
+{
+    // Resources of deleted nodes are never loaded
+    pending.erase(std::remove_if(pending.begin(), pending.end(), [](const PendingResource &resource) {
+        return resource.node.isNull();
+    }), pending.end());
+
+    for (auto &resource : pending) {
+        auto node = resource.node.toStrongRef();
+        resource.distance = (node->getGlobalPosition() - cameraPos).lengthSquared();
+    }
+
+    std::stable_sort(pending.begin(), pending.end(), [](const PendingResource &a, const PendingResource &b) {
+        return a.distance > b.distance;
+    });
+
+    sortedFrom = cameraPos;
+    sorted = true;
+}
+
+void SceneStreamer::load(const PendingResource &resource)
+{
+    auto node = resource.node.toStrongRef();
+    if (!node) return;
+
+    if (resource.type == ResourceType::Mesh) {
+        // A mesh assigned in the editor meanwhile wins over the one read from the scene
+        auto meshNode = node.staticCast<iris::MeshNode>();
+        if (!!meshNode->getMesh()) return;
+
+        meshNode->setMesh(reader->getMesh(resource.path, resource.meshIndex));
+        meshNode->applyDefaultPose();
+    }
+    else if (auto material = resource.material.toStrongRef()) {
+        if (isTextureUnset(material, resource.property)) material->setValue(resource.property, resource.path);
+    }
+}
+
+void SceneStreamer::prefetch(const QStringList &paths)
+{
+    // Reading the files is enough to have them in the OS cache when the GUI thread loads them
+    QByteArray buffer(prefetchChunkSize, Qt::Uninitialized);
+
+    for (const auto &path : paths) {
+        if (cancelPrefetch) return;
+
+        QFile file(path);
+        if (!file.open(QFile::ReadOnly)) continue;
+
+        while (!cancelPrefetch && file.read(buffer.data(), prefetchChunkSize) > 0) {}
+    }
+}
+
+void SceneStreamer::stopPrefetch()
+{
+    cancelPrefetch = true;
+    prefetchFuture.waitForFinished();
+}
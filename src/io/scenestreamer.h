@@ -0,0 +1,119 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef SCENESTREAMER_H
+#define SCENESTREAMER_H
+
+#include <QFuture>
+#include <QHash>
+#include <QMatrix4x4>
+#include <QPair>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <QVector3D>
+#include <QWeakPointer>
+
+#include <atomic>
+
+#include "irisgl/src/irisglfwd.h"
+
+class SceneReader;
+
+/**
+ * Makes the meshes and textures of a scene resident after the scene is already shown
+ * SceneReader registers what it skipped while building the node hierarchy and the scene view calls update every
+ * frame, which loads the pending resources nearest to the camera first within a small time budget
+ * Texture files are read ahead on a worker so the loads on the GUI thread don't wait on the disk
+ */
+class SceneStreamer
+{
+public:
+    SceneStreamer();
+    ~SceneStreamer();
+
+    void addMesh(const iris::MeshNodePtr &node,
+                 const QString &source,
+                 int meshIndex,
+                 bool hasBounds,
+                 const QVector3D &boundsMin,
+                 const QVector3D &boundsMax);
+    void addTextures(const iris::SceneNodePtr &node,
+                     const iris::CustomMaterialPtr &material,
+                     const QVector<QPair<QString, QString>> &textures);
+
+    // Gives a duplicate of original, and of each of its children, the meshes and textures still pending for them
+    void addDuplicate(const iris::SceneNodePtr &original, const iris::SceneNodePtr &duplicate);
+
+    // Takes over the reader that built the scene, pending meshes are loaded through it
+    // Texture files start being read ahead, nearest to cameraPos first
+    void start(SceneReader *reader, const QVector3D &cameraPos);
+
+    // Loads pending resources nearest to cameraPos first until budgetMs is spent, needs a current GL context
+    // Returns true once nothing is left
+    bool update(const QVector3D &cameraPos, int budgetMs = 8);
+
+    // What the resources still pending will set once they're loaded, textures already set elsewhere are left out
+    struct PendingValues
+    {
+        QHash<const iris::CustomMaterial*, QHash<QString, QString>> textures;  // material -> property -> path
+        QHash<const iris::SceneNode*, QPair<QVector3D, QVector3D>> bounds;     // meshes with known bounds
+    };
+
+    // Lets a save write the scene as it will be without loading anything
+    PendingValues getPendingValues() const;
+
+    // Loads everything that's left, used before the scene is played
+    void finish();
+
+    bool isFinished() const;
+    int getPendingCount() const;
+
+    // World transforms mapping a unit cube centred on the origin onto the bounds of each mesh still pending
+    QVector<QMatrix4x4> getPlaceholders() const;
+
+private:
+    enum class ResourceType
+    {
+        Mesh,
+        Texture
+    };
+
+    struct PendingResource
+    {
+        ResourceType type;
+        QWeakPointer<iris::SceneNode> node;
+        QWeakPointer<iris::CustomMaterial> material;
+        QString path;
+        QString property;       // textures only
+        int meshIndex;
+        bool hasBounds;
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+        float distance;
+    };
+
+    void sortPending(const QVector3D &cameraPos);
+    void load(const PendingResource &resource);
+    void prefetch(const QStringList &paths);
+    void stopPrefetch();
+
+    QScopedPointer<SceneReader> reader;
+    QVector<PendingResource> pending;   // farthest first, loads are taken from the back
+    QVector3D sortedFrom;
+    bool sorted;
+
+    QFuture<void> prefetchFuture;
+    std::atomic<bool> cancelPrefetch;
+};
+
+#endif // SCENESTREAMER_H
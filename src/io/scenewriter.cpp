@@ -28,11 +28,13 @@ For more information see the LICENSE file
 #include "irisgl/src/graphics/postprocessmanager.h"
 
 #include "assetiobase.h"
+#include "sceneformat.h"
 #include "constants.h"
 #include "core/database/database.h"
 #include "editor/editordata.h"
 
 Database *SceneWriter::handle = 0;
+const SceneStreamer::PendingValues *SceneWriter::pendingValues = nullptr;
 
 void SceneWriter::writeScene(QString filePath,
                              iris::ScenePtr scene,
@@ -62,12 +64,23 @@ QByteArray SceneWriter::getSceneObject(QString projectPath,
                                        iris::ScenePtr scene,
                                        iris::PostProcessManagerPtr postMan,
                                        EditorData *editorData)
+{
+    return SceneFormat::encode(getSceneSnapshot(projectPath, scene, postMan, editorData));
+}
+
+QJsonObject SceneWriter::getSceneSnapshot(QString projectPath,
+                                          iris::ScenePtr scene,
+                                          iris::PostProcessManagerPtr postMan,
+                                          EditorData *editorData,
+                                          const SceneStreamer::PendingValues *pending)
 {
     dir = projectPath;
     QJsonObject projectObj;
     projectObj["version"] = Constants::CONTENT_VERSION;
 
+    pendingValues = pending;
     writeScene(projectObj, scene);
+    pendingValues = nullptr;
 
     if (editorData != nullptr) {
         writeEditorData(projectObj, editorData);
@@ -79,7 +92,7 @@ QByteArray SceneWriter::getSceneObject(QString projectPath,
 
     //qDebug() << projectObj;
 
-    return QJsonDocument(projectObj).toBinaryData();
+    return projectObj;
 }
 
 void SceneWriter::writeScene(QJsonObject& projectObj, iris::ScenePtr scene)
@@ -324,6 +337,22 @@ void SceneWriter::writeMeshData(QJsonObject& sceneNodeObject, iris::MeshNodePtr
 	sceneNodeObject["guid"]          = meshNode->getGUID();
     sceneNodeObject["meshIndex"]     = meshNode->meshIndex;
 
+    // Lets a streamed load show where the mesh is before the mesh itself is loaded
+    if (!!meshNode->getMesh()) {
+        auto bounds = meshNode->getMesh()->getAABB();
+        QJsonObject boundsObj;
+        boundsObj["min"] = jsonVector3(bounds.getMin());
+        boundsObj["max"] = jsonVector3(bounds.getMax());
+        sceneNodeObject["bounds"] = boundsObj;
+    }
+    else if (pendingValues && pendingValues->bounds.contains(meshNode.data())) {
+        auto bounds = pendingValues->bounds.value(meshNode.data());
+        QJsonObject boundsObj;
+        boundsObj["min"] = jsonVector3(bounds.first);
+        boundsObj["max"] = jsonVector3(bounds.second);
+        sceneNodeObject["bounds"] = boundsObj;
+    }
+
     auto cullMode = meshNode->getFaceCullingMode();
     switch (cullMode) {
         case iris::FaceCullingMode::Back:
@@ -397,6 +426,10 @@ void SceneWriter::writeSceneNodeMaterial(QJsonObject& matObj, iris::CustomMateri
 	matObj["shaderGuid"] = mat->getGuid();
 	matObj["version"] = 2;
 
+	// Textures still streaming in have no value on the material yet
+	QHash<QString, QString> pendingTextures;
+	if (pendingValues) pendingTextures = pendingValues->textures.value(mat.data());
+
 	QJsonObject valuesObj;
     for (auto prop : mat->properties) {
         if (prop->type == iris::PropertyType::Bool) {
@@ -413,9 +446,11 @@ void SceneWriter::writeSceneNodeMaterial(QJsonObject& matObj, iris::CustomMateri
 
         if (prop->type == iris::PropertyType::Texture) {
 			//matObj[prop->name] = relative ? getRelativePath(prop->getValue().toString()) : QFileInfo(prop->getValue().toString()).fileName();
+			auto path = prop->getValue().toString();
+			if (path.isEmpty()) path = pendingTextures.value(prop->name);
 			auto id = relative
-				? handle->fetchAssetGUIDByName(QFileInfo(prop->getValue().toString()).fileName())
-				: getRelativePath(prop->getValue().toString());
+				? handle->fetchAssetGUIDByName(QFileInfo(path).fileName())
+				: getRelativePath(path);
 			valuesObj[prop->name] = id;
         }
 
@@ -23,6 +23,7 @@ For more information see the LICENSE file
 #include "../irisgl/src/scenegraph/lightnode.h"
 #include "../irisgl/src/animation/keyframeanimation.h"
 #include "../irisgl/src/irisglfwd.h"
+#include "scenestreamer.h"
 
 class EditorData;
 class Database;	// this is a temp way to get this working, remove later
@@ -30,6 +31,8 @@ class Database;	// this is a temp way to get this working, remove later
 class SceneWriter : public AssetIOBase
 {
 	static Database *handle;
+	// Set while a snapshot is taken, values of resources that haven't streamed in yet
+	static const SceneStreamer::PendingValues *pendingValues;
 public:
 	void setDatabaseHandle(Database *db) {
 		this->handle = db;
@@ -39,6 +42,13 @@ public:
                               iris::ScenePtr scene,
                               iris::PostProcessManagerPtr postMan,
                               EditorData *editorData);
+    // The project object getSceneObject encodes, for saves that encode it elsewhere
+    // Meshes and textures the streamer hasn't loaded yet are written from its pending values
+    QJsonObject getSceneSnapshot(QString projectPath,
+                                 iris::ScenePtr scene,
+                                 iris::PostProcessManagerPtr postMan,
+                                 EditorData *editorData,
+                                 const SceneStreamer::PendingValues *pending = nullptr);
 
 public:
     void writeScene(QJsonObject& projectObj, iris::ScenePtr scene);
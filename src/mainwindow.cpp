@@ -63,6 +63,7 @@ For more information see the LICENSE file
 #include <QHashIterator>
 #include <QBuffer>
 #include <QDirIterator>
+#include <QElapsedTimer>
 #include <QDockWidget>
 #include <QFileDialog>
 #include <QTemporaryDir>
@@ -104,6 +105,8 @@ For more information see the LICENSE file
 #include "widgets/projectmanager.h"
 
 #include "io/scenewriter.h"
+#include "io/scenesaver.h"
+#include "io/scenestreamer.h"
 #include "io/scenereader.h"
 
 #include "constants.h"
@@ -140,6 +143,9 @@ For more information see the LICENSE file
 
 #include "shadergraph/shadergraphmainwindow.h"
 #include "../src/player/playerwidget.h"
+#include "core/texturecache.h"
+#include "core/shadercache.h"
+#include "core/programcache.h"
 
 enum class VRButtonMode : int
 {
@@ -374,7 +380,7 @@ iris::ScenePtr MainWindow::createDefaultScene()
     dlight->setLocalPos(QVector3D(4, 4, 0));
     dlight->setLocalRot(QQuaternion::fromEulerAngles(15, 0, 0));
     dlight->intensity = 1;
-    dlight->icon = iris::Texture2D::load(":/icons/light.png");
+    dlight->icon = TextureCache::load(":/icons/light.png");
 
     auto plight = iris::LightNode::create();
     plight->setLightType(iris::LightType::Point);
@@ -382,7 +388,7 @@ iris::ScenePtr MainWindow::createDefaultScene()
     plight->setName("Point Light");
     plight->setLocalPos(QVector3D(-4, 4, 0));
     plight->intensity = 1;
-    plight->icon = iris::Texture2D::load(":/icons/bulb.png");
+    plight->icon = TextureCache::load(":/icons/bulb.png");
 	plight->setShadowMapType(iris::ShadowMapType::None);
 
     // fog params
@@ -478,8 +484,12 @@ void MainWindow::closeEvent(QCloseEvent *event)
     bool closing = false;
 	bool autoSave = settings->getValue("auto_save", true).toBool();
 
+	// an import still running would otherwise be cut off halfway
+	assetWidget->waitForImport();
+
 	if (autoSave && UiManager::isSceneOpen) {
 		saveScene();
+		sceneSaver->waitForFinished();
 		closing = true;
 		event->accept();
 	}
@@ -492,6 +502,7 @@ void MainWindow::closeEvent(QCloseEvent *event)
 				QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
 			if (reply == QMessageBox::Yes) {
 				saveScene();
+				sceneSaver->waitForFinished();
 				event->accept();
 				closing = true;
 			}
@@ -568,6 +579,11 @@ void MainWindow::setupProjectDB()
 		db->createAllTables();
 	}
 	Globals::db = db;
+
+    sceneSaver = new SceneSaver(db, this);
+    connect(sceneSaver, &SceneSaver::sceneSaved, [this](const SceneSaveResult &result) {
+        if (result.written) pmContainer->updateTile(result.projectGuid, result.thumbnail);
+    });
 }
 
 void MainWindow::setupUndoRedo()
@@ -680,6 +696,8 @@ void MainWindow::switchSpace(WindowSpaces space)
             toolBar->setVisible(false);
 
 			this->sceneView->setWindowSpace(space);
+            // the player doesn't draw placeholders, everything has to be resident before it starts
+            this->sceneView->finishStreaming();
             UiManager::sceneMode = SceneMode::PlayMode;
             playSceneBtn->hide();
             this->enterPlayMode();
@@ -784,20 +802,22 @@ void MainWindow::saveScene()
 	if (!sceneView->isInitialized())
 		return;
 
-	SceneWriter writer;
-    auto blob = writer.getSceneObject(Globals::project->getProjectFolder(),
-                                      scene,
-                                      sceneView->getRenderer()->getPostProcessManager(),
-                                      sceneView->getEditorData());
+	// Meshes and textures that haven't streamed in yet are saved from what the streamer will load
+	SceneStreamer::PendingValues pending;
+	if (auto streamer = sceneView->getSceneStreamer()) pending = streamer->getPendingValues();
 
-    auto img = sceneView->takeScreenshot(Constants::TILE_SIZE * 2);
-    QByteArray thumb;
-    QBuffer buffer(&thumb);
-    buffer.open(QIODevice::WriteOnly);
-    img.save(&buffer, "PNG");
+	// Only the snapshot is taken here, encoding and writing it happens on the saver's worker
+	SceneWriter writer;
+    SceneSnapshot snapshot;
+    snapshot.projectGuid = Globals::project->getProjectGuid();
+    snapshot.projectObj = writer.getSceneSnapshot(Globals::project->getProjectFolder(),
+                                                  scene,
+                                                  sceneView->getRenderer()->getPostProcessManager(),
+                                                  sceneView->getEditorData(),
+                                                  &pending);
+    snapshot.screenshot = sceneView->takeScreenshot(Constants::TILE_SIZE * 2);
 
-    db->updateProject(blob, thumb);
-	pmContainer->updateTile(Globals::project->getProjectGuid(), thumb);
+    sceneSaver->save(snapshot);
 
 	undoStackCount = UiManager::getUndoStackCount();
 }
@@ -818,10 +838,28 @@ void MainWindow::openProject(bool playMode)
     //postMan->clearPostProcesses();
 
 	auto postMan = iris::PostProcessManagerPtr();
+
+    // In the editor the scene shows up as soon as the nodes exist, meshes and textures are loaded after
+    QSharedPointer<SceneStreamer> streamer;
+    if (!playMode) {
+        streamer = QSharedPointer<SceneStreamer>::create();
+        reader->setStreamer(streamer.data());
+    }
+
+    // Last stage of the project open, the asset stages are timed by the ProjectManager
+    QElapsedTimer sceneTimer;
+    sceneTimer.start();
     auto scene = reader->readScene(Globals::project->getProjectFolder(),
                                    db->getSceneBlobGlobal(),
                                    postMan,
                                    &editorData);
+    irisLog(QString("Project scene read in %1 ms").arg(sceneTimer.elapsed()));
+
+    if (!!streamer) {
+        irisLog(QString("Streaming %1 scene resources").arg(streamer->getPendingCount()));
+        streamer->start(reader.release(),
+                        editorData ? editorData->editorCamera->getLocalPos() : QVector3D());
+    }
 
     UiManager::playMode = playMode;
     UiManager::isSceneOpen = true;
@@ -833,6 +871,8 @@ void MainWindow::openProject(bool playMode)
     postProcessWidget->setPostProcessMgr(postMan);
     this->sceneView->doneCurrent();
 
+    if (!!streamer && !streamer->isFinished()) sceneView->setSceneStreamer(streamer);
+
     if (editorData != Q_NULLPTR) {
         sceneView->setEditorData(editorData);
 		// needs to be done so controllers can have the correct
@@ -885,8 +925,11 @@ void MainWindow::closeProject()
             }
         }
 
+        assetWidget->waitForImport();
+
         if (UiManager::isSceneOpen) {
             if (settings->getValue("auto_save", true).toBool()) saveScene();
+            sceneSaver->waitForFinished();
         }
 
         scene->getPhysicsEnvironment()->destroyPhysicsWorld();
@@ -901,6 +944,10 @@ void MainWindow::closeProject()
         playSimBtn->setIcon(fontIcons->icon(fa::play, options));
     }
 
+    // Anything still queued belongs to this project and would be written into the next one
+    ThumbnailGenerator::getSingleton()->cancelAllRequests();
+    sceneView->setSceneStreamer(QSharedPointer<SceneStreamer>());
+
     UiManager::isSceneOpen = false;
     UiManager::isScenePlaying = false;
     ui->actionClose->setDisabled(false);
@@ -913,6 +960,15 @@ void MainWindow::closeProject()
     scene->cleanup();
     scene.clear();
 
+    // Textures only kept around for reuse are let go of and the counters start over for the next project
+    TextureCache::clear();
+    TextureCache::resetStatistics();
+    // Thumbnails of this project's images, the disk cache still has them if they're needed again
+    ThumbnailManager::clearMemoryCache();
+    ShaderCache::clear();
+    ShaderCache::resetStatistics();
+    ProgramCache::resetStatistics();
+
 	undoStackCount = 0;
 
 	if (currentSpace == WindowSpaces::DESKTOP) {
@@ -1001,7 +1057,8 @@ void MainWindow::applyMaterialPreset(MaterialPreset preset)
     );
 
     ThumbnailGenerator::getSingleton()->requestThumbnail(
-        ThumbnailRequestType::Material, QDir(Globals::project->getProjectFolder()).filePath("matgen.material"), guid
+        ThumbnailRequestType::Material, QDir(Globals::project->getProjectFolder()).filePath("matgen.material"), guid,
+        false, ThumbnailPriority::Visible
     );
 
     assetWidget->updateAssetView(assetWidget->assetItem.selectedGuid);
@@ -1069,7 +1126,9 @@ void MainWindow::refreshThumbnail(const QString &guid)
     ThumbnailGenerator::getSingleton()->requestThumbnail(
         ThumbnailRequestType::ImportedMesh,
         QDir(Globals::project->getProjectFolder()).filePath(assetName),
-        guid
+        guid,
+        false,
+        ThumbnailPriority::Visible
     );
 }
 
@@ -1084,7 +1143,9 @@ void MainWindow::refreshThumbnail(QListWidgetItem *item)
         ThumbnailGenerator::getSingleton()->requestThumbnail(
             ThumbnailRequestType::ImportedMesh,
             QDir(Globals::project->getProjectFolder()).filePath(assetName),
-            item->data(MODEL_GUID_ROLE).toString()
+            item->data(MODEL_GUID_ROLE).toString(),
+            false,
+            ThumbnailPriority::Visible
         );
     }
 }
@@ -1478,7 +1539,7 @@ void MainWindow::addPointLight()
     this->sceneView->makeCurrent();
     auto node = iris::LightNode::create();
     node->setLightType(iris::LightType::Point);
-    node->icon = iris::Texture2D::load(":/icons/bulb.png");
+    node->icon = TextureCache::load(":/icons/bulb.png");
     node->setName("Point Light");
     node->intensity = 1.0f;
     node->distance = 40.0f;
@@ -1490,7 +1551,7 @@ void MainWindow::addSpotLight()
     this->sceneView->makeCurrent();
     auto node = iris::LightNode::create();
     node->setLightType(iris::LightType::Spot);
-    node->icon = iris::Texture2D::load(":/icons/bulb.png");
+    node->icon = TextureCache::load(":/icons/bulb.png");
     node->setName("Spot Light");
     addNodeToScene(node);
 }
@@ -1502,7 +1563,7 @@ void MainWindow::addDirectionalLight()
     auto node = iris::LightNode::create();
     node->shadowMap->shadowType = iris::ShadowMapType::Soft;
     node->setLightType(iris::LightType::Directional);
-    node->icon = iris::Texture2D::load(":/icons/bulb.png");
+    node->icon = TextureCache::load(":/icons/bulb.png");
     node->setName("Directional Light");
     addNodeToScene(node);
 }
@@ -1598,7 +1659,7 @@ void MainWindow::addParticleSystem()
 
     {
         QString texPath = QDir(Globals::project->getProjectFolder()).filePath("Glowing Particle.jpg");
-        node->setTexture(iris::Texture2D::load(texPath));
+        node->setTexture(TextureCache::load(texPath));
     }
 
     auto assetTexture = new AssetTexture;
@@ -1704,10 +1765,8 @@ void MainWindow::addAssetParticleSystem(bool ignore, QVector3D position, QString
     this->sceneView->makeCurrent();
 
     QJsonObject pDefs;
-    QVector<Asset*>::const_iterator iterator = AssetManager::getAssets().constBegin();
-    while (iterator != AssetManager::getAssets().constEnd()) {
-        if ((*iterator)->assetGuid == guid) pDefs = (*iterator)->getValue().toJsonObject();
-        ++iterator;
+    if (auto asset = AssetManager::getAssetByGuid(guid, ModelTypes::ParticleSystem)) {
+        pDefs = asset->getValue().toJsonObject();
     }
 
     //if (!node) return; 
@@ -1731,7 +1790,7 @@ void MainWindow::addAssetParticleSystem(bool ignore, QVector3D position, QString
             Globals::project->getProjectFolder(),
             db->fetchAsset(textureGuid).name
         );
-        particleNode->setTexture(iris::Texture2D::load(texPath));
+        particleNode->setTexture(TextureCache::load(texPath));
     }
     particleNode->setVisible(pDefs["visible"].toBool(true));
 
@@ -1835,6 +1894,9 @@ void MainWindow::duplicateNode()
     auto node = activeSceneNode->duplicate();
     activeSceneNode->parent->addChild(node, false);
 
+    // Meshes and textures that haven't streamed in yet have to reach the copies as well
+    if (auto streamer = sceneView->getSceneStreamer()) streamer->addDuplicate(activeSceneNode, node);
+
     this->sceneHierarchyWidget->repopulateTree();
     sceneNodeSelected(node);
 	sceneView->doneCurrent();
@@ -1899,7 +1961,7 @@ void MainWindow::createMaterial()
 		);
 
 		ThumbnailGenerator::getSingleton()->requestThumbnail(
-			ThumbnailRequestType::Material, fileName, assetGuid
+			ThumbnailRequestType::Material, fileName, assetGuid, false, ThumbnailPriority::Visible
 		);
 
 		assetWidget->updateAssetView(assetWidget->assetItem.selectedGuid);
@@ -2129,6 +2191,8 @@ void MainWindow::exportSceneAsZip()
 
     if (filePath.isEmpty() || filePath.isNull()) return;
     if (!!scene) saveScene();
+    // The export reads the scene back out of the database
+    sceneSaver->waitForFinished();
 
     // Maybe in the future one could add a way to using an in memory database
     // and saving that as a blob which can be put into the zip as bytes (iKlsR)
@@ -2474,6 +2538,11 @@ void MainWindow::setupViewPort()
     connect(physicsCheckAction, SIGNAL(toggled(bool)), this, SLOT(toggleDebugDrawer(bool)));
     wireFramesMenu->addAction(physicsCheckAction);
 
+    wireFramesMenu->addSeparator();
+    auto cacheStatsAction = new QAction(QIcon(), "Cache Statistics...");
+    connect(cacheStatsAction, SIGNAL(triggered()), this, SLOT(showCacheStatistics()));
+    wireFramesMenu->addAction(cacheStatsAction);
+
     wireFramesButton->setMenu(wireFramesMenu);
     wireFramesButton->setText("View Options ");
     wireFramesButton->setPopupMode(QToolButton::InstantPopup);
@@ -3133,6 +3202,7 @@ void MainWindow::showProjectManagerInternal()
 
         if (option == QMessageBox::Yes) {
             saveScene();
+            sceneSaver->waitForFinished();
         } else if (option == QMessageBox::Cancel) {
             return;
         }
@@ -3175,10 +3245,42 @@ void MainWindow::newProject(const QString &filename, const QString &projectPath)
 
 MainWindow::~MainWindow()
 {
+    sceneSaver->waitForFinished();
     this->db->closeDatabase();
     delete ui;
 }
 
+void MainWindow::showCacheStatistics()
+{
+    auto stats = TextureCache::getStatistics();
+    auto toMegabytes = [](qint64 bytes) {
+        return QString::number(bytes / (1024.0 * 1024.0), 'f', 1);
+    };
+
+    QMessageBox::information(this,
+                             "Cache Statistics",
+                             QString("Textures loaded: %1\n"
+                                     "Estimated GPU memory: %2 MB\n"
+                                     "Kept for reuse: %3 MB\n\n"
+                                     "Cache hits: %4\n"
+                                     "Cache misses: %5\n"
+                                     "Evictions: %6\n\n"
+                                     "Shader definitions reused: %7\n"
+                                     "Shader definitions resolved: %8\n"
+                                     "Programs reused: %9\n"
+                                     "Programs linked: %10")
+                                 .arg(stats.textureCount)
+                                 .arg(toMegabytes(stats.memoryUsage))
+                                 .arg(toMegabytes(stats.retainedMemory))
+                                 .arg(stats.hits)
+                                 .arg(stats.misses)
+                                 .arg(stats.evictions)
+                                 .arg(ShaderCache::getHits())
+                                 .arg(ShaderCache::getMisses())
+                                 .arg(ProgramCache::getHits())
+                                 .arg(ProgramCache::getMisses()));
+}
+
 void MainWindow::useFreeCamera()
 {
     sceneView->setFreeCameraMode();
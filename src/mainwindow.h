@@ -80,6 +80,7 @@ class AboutDialog;
 class JahRenderer;
 
 class ProjectManager;
+class SceneSaver;
 
 class GizmoHitData;
 class AdvancedGizmoHandle;
@@ -119,6 +120,7 @@ enum class Widget
 #include "irisgl/src/graphics/shadowmap.h"
 #include "irisgl/src/core/irisutils.h"
 #include "irisgl/src/graphics/texture2d.h"
+#include "core/texturecache.h"
 
 class Database;
 class MainWindow : public QMainWindow
@@ -225,10 +227,10 @@ public:
 
         //TODO: move this to the sceneview widget or somewhere more appropriate
         if (lightNode->lightType == iris::LightType::Directional) {
-            lightNode->icon = iris::Texture2D::load(":/icons/light.png");
+            lightNode->icon = TextureCache::load(":/icons/light.png");
         }
         else {
-            lightNode->icon = iris::Texture2D::load(":/icons/bulb.png");
+            lightNode->icon = TextureCache::load(":/icons/bulb.png");
         }
 
         lightNode->iconSize = 0.5f;
@@ -347,6 +349,7 @@ public slots:
 
     void useFreeCamera();
     void useArcballCam();
+    void showCacheStatistics();
 
     void useLocalTransform();
     void useGlobalTransform();
@@ -425,6 +428,7 @@ private:
     QActionGroup* cameraGroup;
 
     Database *db;
+    SceneSaver *sceneSaver;
     ProjectManager *pmContainer;
 
     QUndoStack* undoStack;
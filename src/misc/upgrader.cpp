@@ -166,6 +166,9 @@ void Upgrader::checkIfSchemaNeedsUpdating()
 
 		if (majorGreater || minorGreater || patchGreater) updateSchema = true;
 
+		// Schema additions that don't warrant a version bump (indexes etc) are detected directly
+		if (db.schemaNeedsUpdating()) updateSchema = true;
+
 		if (updateSchema) {
 			db.updateSchema();
 			db.updateMetadataVersion(Constants::CONTENT_VERSION); // Use the struct in the future
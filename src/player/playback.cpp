@@ -35,6 +35,7 @@ void PlayBack::init(iris::ForwardRendererPtr renderer)
 void PlayBack::setScene(iris::ScenePtr scene)
 {
 	this->scene = scene;
+	animationSampler.clear();
 	if (renderer)
 		renderer->setScene(scene);
 
@@ -88,7 +89,7 @@ void PlayBack::renderScene(iris::Viewport& viewport, float dt)
 		irisLog("Controller mismatch!");
 
 	animTime += dt;
-	scene->updateSceneAnimation(animTime);
+	updateAnimation(animTime);
 	scene->update(dt);
 
 	auto activeViewer = scene->getActiveVrViewer();
@@ -184,14 +185,33 @@ void PlayBack::playScene()
 		camController->start();
 	}
 
+	animationSampler.compile(scene);
 	animTime = 0;
 }
 
+void PlayBack::updateAnimation(float time)
+{
+	if (!_isPlaying) {
+		scene->updateSceneAnimation(time);
+		return;
+	}
+
+	if (!animationSampler.isCompiled())
+		animationSampler.compile(scene);
+	animationSampler.update(time);
+}
+
+void PlayBack::invalidateAnimation()
+{
+	animationSampler.clear();
+}
+
 
 void PlayBack::pause() {}
 void PlayBack::stopScene()
 {
 	_isPlaying = false;
+	animationSampler.clear();
 	vrController->setPlayState(_isPlaying);
 	mouseController->setPlayState(_isPlaying);
 	scene->getPhysicsEnvironment()->restartPhysics();
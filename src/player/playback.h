@@ -10,6 +10,7 @@
 #include <QMatrix4x4>
 
 #include "irisgl/src/irisglfwd.h"
+#include "core/animationsampler.h"
 
 namespace iris
 {
@@ -63,6 +64,7 @@ class PlayBack
 	QTimer* updateTimer;
 	QElapsedTimer* fpsTimer;
 	float animTime;
+	AnimationSampler animationSampler;
 	QPointF prevMousePos;
 
 	bool _isPlaying = false;
@@ -87,6 +89,11 @@ public:
 	void pause();
 	void stopScene();
 
+	// Uses the compiled tracks while playing, compiling them again if they were invalidated
+	void updateAnimation(float time);
+	// Drops the compiled tracks, call after the scene's animations were edited
+	void invalidateAnimation();
+
 	iris::ForwardRendererPtr getRenderer() { return renderer; }
 	PlayerMouseController* getMouseController() const;
 	PlayerVrController* getVrController() const;
@@ -12,6 +12,7 @@ For more information see the LICENSE file
 #include "playermousecontroller.h"
 #include "../editor/animationpath.h"
 #include "../core/keyboardstate.h"
+#include "../core/scenepicker.h"
 #include "../widgets/sceneviewwidget.h"
 #include <irisgl/SceneGraph.h>
 #include <irisgl/Vr.h>
@@ -182,75 +183,24 @@ void PlayerMouseController::doObjectPicking(
     auto segStart = screenSpaceToWoldSpace(point, -1.0f);
     auto segEnd = screenSpaceToWoldSpace(point, 1.0f);
 
-    QList<PickingResult> hitList;
-    doScenePicking(scene->getRootNode(), segStart, segEnd, hitList);
-
-    // sort by distance to camera then return the closest hit node
-    qSort(hitList.begin(), hitList.end(), [](const PickingResult& a, const PickingResult& b) {
-        return a.distanceFromCameraSqrd > b.distanceFromCameraSqrd;
-    });
-
-    if (hitList.size() == 0) {
+    // only the closest hit is used so the picker can prune everything behind it
+    iris::PickingResult hit;
+    if (!ScenePicker::pickMesh(scene->getRootNode(), segStart, segEnd, hit)) {
         this->pickedNode.clear();
         return;
     }
-    auto pickedNode = hitList.last().hitNode;
-    iris::SceneNodePtr lastSelectedRoot;
-
-    auto pickedRoot = hitList.last().hitNode;
-    while (pickedRoot->isAttached())
-        pickedRoot = pickedRoot->parent;
+    auto pickedNode = hit.hitNode;
 
     if (pickedNode->isPhysicsBody) {
         scene->getPhysicsEnvironment()->createPickingConstraint(iris::PickingHandleType::MouseButton,
                                                                 pickedNode->getGUID(),
-                                                                iris::PhysicsHelper::btVector3FromQVector3D(hitList.last().hitPoint),
+                                                                iris::PhysicsHelper::btVector3FromQVector3D(hit.hitPoint),
                                                                 segStart,
                                                                 segEnd);
         this->pickedNode = pickedNode;
     }
 }
 
-void PlayerMouseController::doScenePicking(const QSharedPointer<iris::SceneNode>& sceneNode,
-                                     const QVector3D& segStart,
-                                     const QVector3D& segEnd,
-                                     QList<PickingResult>& hitList)
-{
-    if ((sceneNode->getSceneNodeType() == iris::SceneNodeType::Mesh) &&
-         sceneNode->isPickable())
-    {
-        auto meshNode = sceneNode.staticCast<iris::MeshNode>();
-        auto mesh = meshNode->getMesh();
-        if (mesh != nullptr) {
-            auto triMesh = meshNode->getMesh()->getTriMesh();
-
-            // transform segment to local space
-            auto invTransform = meshNode->globalTransform.inverted();
-            auto a = invTransform * segStart;
-            auto b = invTransform * segEnd;
-
-            QList<iris::TriangleIntersectionResult> results;
-            if (int resultCount = triMesh->getSegmentIntersections(a, b, results)) {
-                for (auto triResult : results) {
-                    // convert hit to world space
-                    auto hitPoint = meshNode->globalTransform * triResult.hitPoint;
-
-                    PickingResult pick;
-                    pick.hitNode = sceneNode;
-                    pick.hitPoint = hitPoint;
-                    pick.distanceFromCameraSqrd = (hitPoint - camera->getGlobalPosition()).lengthSquared();
-
-                    hitList.append(pick);
-                }
-            }
-        }
-    }
-
-    for (auto child : sceneNode->children) {
-        doScenePicking(child, segStart, segEnd, hitList);
-    }
-}
-
 QVector3D PlayerMouseController::screenSpaceToWoldSpace(const QPointF& pos, float depth)
 {
     float x = pos.x();
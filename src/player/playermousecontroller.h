@@ -59,10 +59,6 @@ public:
     void doObjectPicking(
         const QPointF& point);
     QVector3D screenSpaceToWoldSpace(const QPointF& pos, float depth);
-    void doScenePicking(const iris::SceneNodePtr& sceneNode,
-                        const QVector3D& segStart,
-                        const QVector3D& segEnd,
-                        QList<PickingResult>& hitList);
     void setViewport(const iris::Viewport& viewport);
 
     void updateCameraTransform();
@@ -34,6 +34,8 @@ For more information see the LICENSE file
 #include "animationwidgetdata.h"
 #include "createanimationwidget.h"
 #include "../dialogs/getnamedialog.h"
+#include "../uimanager.h"
+#include "sceneviewwidget.h"
 
 
 AnimationWidget::AnimationWidget(QWidget *parent) :
@@ -278,6 +280,11 @@ void AnimationWidget::fixLayout()
 
 void AnimationWidget::repaintViews()
 {
+    // every edit made from this panel ends up here
+    if (UiManager::sceneViewWidget != nullptr)
+        UiManager::sceneViewWidget->invalidateAnimation();
+
+
     keyFrameWidget->repaint();
     //curveWidget->repaint();
     ui->keylabelView->repaint();
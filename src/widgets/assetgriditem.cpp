@@ -9,144 +9,103 @@ and/or modify it under the terms of the GPLv3 License
 For more information see the LICENSE file
 *************************************************************************/
 
-#include <QMenu>
+#include <QFileInfo>
+#include <QPixmapCache>
 
 #include "assetgriditem.h"
 
 // local
-AssetGridItem::AssetGridItem(QJsonObject details, QImage image, QJsonObject properties, QJsonObject tags, QWidget *parent) : QWidget(parent) {
+AssetGridItem::AssetGridItem(QJsonObject details, QJsonObject properties, QJsonObject tags, QObject *parent) : QObject(parent) {
+	init(details, properties, tags);
+}
+
+AssetGridItem::AssetGridItem(QJsonObject details, QImage image, QJsonObject properties, QJsonObject tags, QObject *parent) : QObject(parent) {
+	init(details, properties, tags);
+	// snapshots can be full size, only the tile sized copy is kept
+	if (!image.isNull()) this->image = image.scaledToHeight(imageHeight, Qt::SmoothTransformation);
+}
+
+AssetGridItem::~AssetGridItem()
+{
+	QPixmapCache::remove(getCacheKey());
+}
+
+void AssetGridItem::init(const QJsonObject &details, const QJsonObject &properties, const QJsonObject &tags)
+{
 	this->metadata = details;
 	this->sceneProperties = properties;
 	this->tags = tags;
 	url = details["icon_url"].toString();
+	name = QFileInfo(details["name"].toString()).baseName();
 	selected = false;
-	auto layout = new QGridLayout;
-	layout->setMargin(0);
-	layout->setSpacing(0);
-	pixmap = QPixmap::fromImage(image);
-	gridImageLabel = new QLabel;
-	gridImageLabel->setPixmap(pixmap.scaledToHeight(116, Qt::SmoothTransformation));
-	gridImageLabel->setAlignment(Qt::AlignCenter);
-
-	layout->addWidget(gridImageLabel, 0, 0);
-	textLabel = new QLabel(QFileInfo(details["name"].toString()).baseName());
-
-	textLabel->setWordWrap(true);
-	textLabel->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-	layout->addWidget(textLabel, 1, 0);
-
-	setMinimumWidth(128);
-	setMaximumWidth(128);
-	setMinimumHeight(142);
-	setMaximumHeight(142);
-
-	textLabel->setStyleSheet("color: #ddd; font-size: 12px; background: #1e1e1e;"
-		"border-left: 3px solid rgba(0, 0, 0, 3%); border-bottom: 3px solid rgba(0, 0, 0, 3%); border-right: 3px solid rgba(0, 0, 0, 3%)");
-	gridImageLabel->setStyleSheet("border-left: 3px solid rgba(0, 0, 0, 3%); border-top: 3px solid rgba(0, 0, 0, 3%); border-right: 3px solid rgba(0, 0, 0, 3%)");
-
-	setStyleSheet("background: #272727");
-	setLayout(layout);
-	setCursor(Qt::PointingHandCursor);
-	setContextMenuPolicy(Qt::CustomContextMenu);
-
-	connect(this, SIGNAL(hovered()), SLOT(dimHighlight()));
-	connect(this, SIGNAL(left()), SLOT(noHighlight()));
-
-	connect(this, SIGNAL(customContextMenuRequested(const QPoint&)), SLOT(projectContextMenu(QPoint)));
+	generation = 0;
+	missingThumbnail = false;
 }
 
-void AssetGridItem::projectContextMenu(const QPoint &pos)
+QString AssetGridItem::getCacheKey() const
 {
-	QMenu menu("Context Menu", this);
-	menu.setStyleSheet(
-		"QMenu { background-color: #1A1A1A; color: #EEE; padding: 0; margin: 0; }"
-		"QMenu::item { background-color: #1A1A1A; padding: 6px 8px; margin: 0; }"
-		"QMenu::item:selected { background-color: #3498db; color: #EEE; padding: 6px 8px; margin: 0; }"
-		"QMenu::item : disabled { color: #555; }"
-	);
-
-	QAction add("Add to Project", this);
-	connect(&add, &QAction::triggered, this, [this]() {
-		emit addAssetItemToProject(this);
-	});
-	menu.addAction(&add);
-
-	QAction change("Change Collections", this);
-	connect(&change, &QAction::triggered, this, [this]() {
-		emit changeAssetCollection(this);
-	});
-	menu.addAction(&change);
-
-	QAction remove("Delete", this);
-	connect(&remove, &QAction::triggered, this, [this]() {
-		emit removeAssetFromProject(this);
-	});
-	menu.addAction(&remove);
-
-	menu.exec(mapToGlobal(pos));
+	return QString("assetgrid_%1_%2").arg(reinterpret_cast<quintptr>(this)).arg(generation);
 }
 
-void AssetGridItem::setTile(QPixmap pix) {
-	pixmap = pix;
-	gridImageLabel->setPixmap(pixmap.scaledToHeight(116, Qt::SmoothTransformation));
-	gridImageLabel->setAlignment(Qt::AlignCenter);
+QString AssetGridItem::getGuid() const
+{
+	return metadata["guid"].toString();
 }
 
-void AssetGridItem::enterEvent(QEvent *event) {
-	QWidget::enterEvent(event);
-	emit hovered();
-}
+bool AssetGridItem::findTile(QPixmap *pixmap) const
+{
+	if (QPixmapCache::find(getCacheKey(), pixmap)) return true;
 
-void AssetGridItem::leaveEvent(QEvent *event) {
-	QWidget::leaveEvent(event);
-	emit left();
+	// Items with their own image never need the thumbnail
+	if (!image.isNull() || missingThumbnail) {
+		*pixmap = loadTile(QByteArray());
+		return true;
+	}
+
+	return false;
 }
 
-void AssetGridItem::mousePressEvent(QMouseEvent *event) {
-	if (event->button() == Qt::LeftButton && !event->modifiers().testFlag(Qt::ShiftModifier)) {
-		emit singleClicked(this);
+QPixmap AssetGridItem::loadTile(const QByteArray &thumbnail) const
+{
+	QImage tile = image;
+	if (tile.isNull() && !thumbnail.isEmpty()) {
+		tile.loadFromData(thumbnail, "PNG");
+		if (!tile.isNull() && tile.height() != imageHeight) tile = tile.scaledToHeight(imageHeight, Qt::SmoothTransformation);
 	}
 
-	if (event->button() == Qt::LeftButton && event->modifiers().testFlag(Qt::ShiftModifier)) {
-		emit specialClicked(this);
+	if (tile.isNull() && !fallbackIcon.isEmpty()) {
+		tile = QImage(fallbackIcon);
 	}
 
-	if (event->button() == Qt::RightButton) {
-		emit contextClicked(this);
-	}
-}
+	missingThumbnail = tile.isNull();
+
+	QPixmap pixmap = QPixmap::fromImage(tile);
+	if (!pixmap.isNull()) QPixmapCache::insert(getCacheKey(), pixmap);
 
-void AssetGridItem::dimHighlight() {
-    if (!selected) {
-        textLabel->setStyleSheet("color: #ddd; font-size: 12px; background: #1e1e1e;"
-            "border-left: 3px solid rgba(0, 0, 0, 10%); border-bottom: 3px solid rgba(0, 0, 0, 10%); border-right: 3px solid rgba(0, 0, 0, 10%)");
-        gridImageLabel->setStyleSheet("border-left: 3px solid rgba(0, 0, 0, 10%); border-top: 3px solid rgba(0, 0, 0, 10%); border-right: 3px solid rgba(0, 0, 0, 10%)");
-    }
+	return pixmap;
 }
 
-void AssetGridItem::noHighlight() {
-    if (!selected) {
-        textLabel->setStyleSheet("color: #ddd; font-size: 12px; background: #1e1e1e;"
-            "border-left: 3px solid rgba(0, 0, 0, 3%); border-bottom: 3px solid rgba(0, 0, 0, 3%); border-right: 3px solid rgba(0, 0, 0, 3%)");
-        gridImageLabel->setStyleSheet("border-left: 3px solid rgba(0, 0, 0, 3%); border-top: 3px solid rgba(0, 0, 0, 3%); border-right: 3px solid rgba(0, 0, 0, 3%)");
-    }
+
+void AssetGridItem::setTile(QPixmap pix) {
+	QPixmapCache::remove(getCacheKey());
+	generation++;
+
+	missingThumbnail = false;
+	image = pix.isNull() ? QImage() : pix.toImage().scaledToHeight(imageHeight, Qt::SmoothTransformation);
+
+	emit changed(this);
 }
 
 void AssetGridItem::highlight(bool highlight) {
+	if (selected == highlight) return;
 	selected = highlight;
-	if (selected) {
-		textLabel->setStyleSheet("color: #ddd; font-size: 12px; background: #1e1e1e;"
-			"border-left: 3px solid #3498db; border-bottom: 3px solid #3498db; border-right: 3px solid #3498db");
-		gridImageLabel->setStyleSheet("border-left: 3px solid #3498db; border-top: 3px solid #3498db; border-right: 3px solid #3498db");
-	}
-	else {
-		dimHighlight();
-	}
+	emit changed(this);
 }
 
 void AssetGridItem::updateMetadata(QJsonObject details, QJsonObject tags)
 {
 	this->metadata = details;
 	this->tags = tags;
-	textLabel->setText(details["name"].toString());
+	name = details["name"].toString();
+	emit changed(this);
 }
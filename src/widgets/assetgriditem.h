@@ -12,60 +12,68 @@ For more information see the LICENSE file
 #ifndef ASSETGRIDITEM_HPP
 #define ASSETGRIDITEM_HPP
 
-#include <QPushButton>
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QImage>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QApplication>
-#include <QResizeEvent>
-#include <QGridLayout>
-#include <QScrollArea>
-#include <qdebug.h>
-#include <QLabel>
-#include <QButtonGroup>
-
-#include <QWidget>
+#include <QPixmap>
 
 #include "irisgl/src/core/irisutils.h"
 
-class AssetGridItem : public QWidget
+// A single asset in the AssetViewGrid, this is only the data behind a tile
+// Tiles are painted by AssetGridDelegate so there is no widget per asset
+// Library items don't hold their thumbnail, the model fetches it once the tile is painted and only the
+// decoded tile is kept, in QPixmapCache, so it can be let go of again
+class AssetGridItem : public QObject
 {
 	Q_OBJECT
 
 public:
+	static const int tileWidth = 128;
+	static const int tileHeight = 142;
+	static const int imageHeight = 116;
+
 	QString url;
-	QPixmap pixmap;
-	QLabel *gridImageLabel;
-	QLabel *textLabel;
+	QString name;
 	bool selected;
 	QJsonObject metadata;
 	QJsonObject sceneProperties;
 	QJsonObject tags;
 
-	AssetGridItem() = default;
-	AssetGridItem(QJsonObject details, QImage image, QJsonObject properties, QJsonObject tags, QWidget *parent = Q_NULLPTR);
+	// shown when there is no thumbnail or it can't be decoded
+	QString fallbackIcon;
+
+	AssetGridItem(QJsonObject details, QJsonObject properties, QJsonObject tags, QObject *parent = Q_NULLPTR);
+	// Snapshots of assets added this session, the tile sized copy is kept with the item
+	AssetGridItem(QJsonObject details, QImage image, QJsonObject properties, QJsonObject tags, QObject *parent = Q_NULLPTR);
+	~AssetGridItem();
+
+	QString getGuid() const;
+	// False when the tile isn't cached and its thumbnail has to be fetched first
+	bool findTile(QPixmap *pixmap) const;
+	// Decodes the thumbnail into a cached tile, the encoded bytes aren't kept
+	QPixmap loadTile(const QByteArray &thumbnail) const;
+
 	void setTile(QPixmap pix);
 	void highlight(bool);
 	void updateMetadata(QJsonObject details, QJsonObject tags);
-	
-	void enterEvent(QEvent *event);
-	void leaveEvent(QEvent *event);
-	void mousePressEvent(QMouseEvent *event);
-
-public slots:
-	void projectContextMenu(const QPoint &pos);
-	void dimHighlight();
-	void noHighlight();
 
 signals:
-	void hovered();
-	void left();
-	void singleClicked(AssetGridItem*);
-	void specialClicked(AssetGridItem*);	// bypass loading asset and add to scene
-	void contextClicked(AssetGridItem*);	// use this exclusively for right clicks
+	void changed(AssetGridItem*);
 
 	void addAssetItemToProject(AssetGridItem*);
 	void changeAssetCollection(AssetGridItem*);
 	void removeAssetFromProject(AssetGridItem*);
+
+private:
+	void init(const QJsonObject &details, const QJsonObject &properties, const QJsonObject &tags);
+	QString getCacheKey() const;
+
+	QImage image;
+	int generation;
+	mutable bool missingThumbnail;  // nothing to decode, don't fetch again until the tile changes
 };
 
-#endif // ASSETGRIDITEM_HPP
\ No newline at end of file
+#endif // ASSETGRIDITEM_HPP
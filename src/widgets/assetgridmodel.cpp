@@ -0,0 +1,207 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include "assetgridmodel.h"
+#include "assetgriditem.h"
+
+#include <QPainter>
+#include <QSet>
+
+namespace
+{
+	const int borderWidth = 3;
+	const int tilesPerFetch = 48;   // about a screenful, tiles are mostly painted row by row
+}
+
+AssetGridModel::AssetGridModel(QObject *parent) : QAbstractListModel(parent)
+{
+
+}
+
+void AssetGridModel::addItem(AssetGridItem *item)
+{
+	items.append(item);
+
+	if (!filter || filter(item)) {
+		beginInsertRows(QModelIndex(), visibleItems.size(), visibleItems.size());
+		visibleItems.append(item);
+		endInsertRows();
+	}
+}
+
+void AssetGridModel::removeItem(AssetGridItem *item)
+{
+	items.removeOne(item);
+
+	const int row = visibleItems.indexOf(item);
+	if (row != -1) {
+		beginRemoveRows(QModelIndex(), row, row);
+		visibleItems.remove(row);
+		endRemoveRows();
+	}
+}
+
+void AssetGridModel::setFilter(const Filter &filter)
+{
+	beginResetModel();
+
+	this->filter = filter;
+	visibleItems.clear();
+	visibleItems.reserve(items.size());
+	for (auto item : items) {
+		if (!filter || filter(item)) visibleItems.append(item);
+	}
+
+	endResetModel();
+}
+
+void AssetGridModel::showItems(const QVector<AssetGridItem*> &rankedItems)
+{
+	beginResetModel();
+
+	// items added while the results are up only show if they were part of them
+	QSet<const AssetGridItem*> shown;
+	shown.reserve(rankedItems.size());
+	for (auto item : rankedItems) shown.insert(item);
+
+	filter = [shown](const AssetGridItem *item) {
+		return shown.contains(item);
+	};
+	visibleItems = rankedItems;
+
+	endResetModel();
+}
+
+void AssetGridModel::refresh(AssetGridItem *item)
+{
+	const QModelIndex index = indexOf(item);
+	if (index.isValid()) emit dataChanged(index, index);
+}
+
+void AssetGridModel::setThumbnailSource(const ThumbnailSource &source)
+{
+	thumbnailSource = source;
+}
+
+void AssetGridModel::fetchTiles(int firstRow) const
+{
+	QVector<AssetGridItem*> missing;
+	QStringList guids;
+
+	const int lastRow = qMin(firstRow + tilesPerFetch, visibleItems.size());
+	for (int row = firstRow; row < lastRow; ++row) {
+		QPixmap pixmap;
+		if (visibleItems[row]->findTile(&pixmap)) continue;
+
+		missing.append(visibleItems[row]);
+		guids.append(visibleItems[row]->getGuid());
+	}
+
+	if (missing.isEmpty()) return;
+
+	const QHash<QString, QByteArray> thumbnails = thumbnailSource ? thumbnailSource(guids) : QHash<QString, QByteArray>();
+	for (auto item : missing) item->loadTile(thumbnails.value(item->getGuid()));
+}
+
+AssetGridItem *AssetGridModel::itemAt(const QModelIndex &index) const
+{
+	if (!index.isValid() || index.row() >= visibleItems.size()) return Q_NULLPTR;
+	return visibleItems[index.row()];
+}
+
+QModelIndex AssetGridModel::indexOf(AssetGridItem *item) const
+{
+	const int row = visibleItems.indexOf(item);
+	return row != -1 ? index(row) : QModelIndex();
+}
+
+int AssetGridModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : visibleItems.size();
+}
+
+QVariant AssetGridModel::data(const QModelIndex &index, int role) const
+{
+	auto item = itemAt(index);
+	if (!item) return QVariant();
+
+	switch (role) {
+		case Qt::DisplayRole:
+		case Qt::ToolTipRole:
+			return item->name;
+		case Qt::DecorationRole: {
+			QPixmap pixmap;
+			if (!item->findTile(&pixmap)) {
+				fetchTiles(index.row());
+				item->findTile(&pixmap);
+			}
+
+			return pixmap;
+		}
+		default:
+			return QVariant();
+	}
+}
+
+AssetGridDelegate::AssetGridDelegate(QObject *parent) : QStyledItemDelegate(parent)
+{
+
+}
+
+void AssetGridDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	auto model = qobject_cast<const AssetGridModel*>(index.model());
+	auto item = model ? model->itemAt(index) : Q_NULLPTR;
+	if (!item) return;
+
+	painter->save();
+
+	const QRect tile = option.rect;
+	const QRect imageRect(tile.left(), tile.top(), tile.width(), AssetGridItem::imageHeight);
+	const QRect textRect(tile.left(), imageRect.bottom() + 1, tile.width(), tile.height() - AssetGridItem::imageHeight);
+
+	painter->fillRect(tile, QColor("#272727"));
+	painter->fillRect(textRect, QColor("#1e1e1e"));
+
+	const QPixmap pixmap = index.data(Qt::DecorationRole).value<QPixmap>();
+	if (!pixmap.isNull()) {
+		QRect target = pixmap.rect();
+		target.moveCenter(imageRect.center());
+		painter->setClipRect(imageRect);
+		painter->drawPixmap(target.topLeft(), pixmap);
+		painter->setClipping(false);
+	}
+
+	QFont font = option.font;
+	font.setPixelSize(12);
+	painter->setFont(font);
+	painter->setPen(QColor("#ddd"));
+	painter->drawText(textRect.adjusted(borderWidth, 0, -borderWidth, -borderWidth),
+					  Qt::AlignCenter | Qt::TextWordWrap, item->name);
+
+	QColor border(0, 0, 0, 8);
+	if (item->selected) border = QColor("#3498db");
+	else if (option.state & QStyle::State_MouseOver) border = QColor(0, 0, 0, 26);
+
+	painter->fillRect(QRect(tile.left(), tile.top(), tile.width(), borderWidth), border);
+	painter->fillRect(QRect(tile.left(), tile.bottom() - borderWidth + 1, tile.width(), borderWidth), border);
+	painter->fillRect(QRect(tile.left(), tile.top(), borderWidth, tile.height()), border);
+	painter->fillRect(QRect(tile.right() - borderWidth + 1, tile.top(), borderWidth, tile.height()), border);
+
+	painter->restore();
+}
+
+QSize AssetGridDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	Q_UNUSED(option);
+	Q_UNUSED(index);
+	return QSize(AssetGridItem::tileWidth, AssetGridItem::tileHeight);
+}
@@ -0,0 +1,75 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#ifndef ASSETGRIDMODEL_H
+#define ASSETGRIDMODEL_H
+
+#include <functional>
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+#include <QStyledItemDelegate>
+#include <QVector>
+
+class AssetGridItem;
+
+// Flat list of every asset in the library, only the rows that pass the filter are exposed
+// Filtering rebuilds a vector of pointers, nothing is created or laid out per asset
+// Thumbnails are fetched when a tile without a cached image is painted, together with the rows after it
+class AssetGridModel : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	typedef std::function<bool(const AssetGridItem*)> Filter;
+	// Encoded thumbnails by asset guid
+	typedef std::function<QHash<QString, QByteArray>(const QStringList&)> ThumbnailSource;
+
+	explicit AssetGridModel(QObject *parent = Q_NULLPTR);
+
+	void addItem(AssetGridItem *item);
+	void removeItem(AssetGridItem *item);
+	void setFilter(const Filter &filter);
+	// Shows exactly these items in this order, used for ranked search results
+	void showItems(const QVector<AssetGridItem*> &rankedItems);
+	void refresh(AssetGridItem *item);
+	void setThumbnailSource(const ThumbnailSource &source);
+
+	AssetGridItem *itemAt(const QModelIndex &index) const;
+	QModelIndex indexOf(AssetGridItem *item) const;
+	const QVector<AssetGridItem*> &getItems() const { return items; }
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+	void fetchTiles(int firstRow) const;
+
+	QVector<AssetGridItem*> items;
+	QVector<AssetGridItem*> visibleItems;
+	Filter filter;
+	ThumbnailSource thumbnailSource;
+};
+
+// Paints a tile the way the old AssetGridItem widget looked, the thumbnail is
+// requested through the model so only the tiles in view are ever decoded
+class AssetGridDelegate : public QStyledItemDelegate
+{
+public:
+	explicit AssetGridDelegate(QObject *parent = Q_NULLPTR);
+
+	void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+	QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // ASSETGRIDMODEL_H
@@ -49,28 +49,25 @@ AssetPickerWidget::~AssetPickerWidget()
 
 void AssetPickerWidget::populateWidget(QString filter)
 {
-    for (auto asset : AssetManager::getAssets()) {
+    for (auto asset : AssetManager::getAssetsByType(ModelTypes::Texture)) {
         QPixmap pixmap;
+        QFileInfo file(asset->fileName);
+        auto item = new QListWidgetItem(asset->fileName);
 
-        if (asset->type == ModelTypes::Texture) {
-            QFileInfo file(asset->fileName);
-            auto item = new QListWidgetItem(asset->fileName);
-
-            if (Constants::IMAGE_EXTS.contains(file.suffix())) {
-                auto thumb = ThumbnailManager::createThumbnail(asset->path, 128, 128);
-                pixmap = QPixmap::fromImage(*thumb->thumb);
-                item->setIcon(QIcon(pixmap));
-            }
+        if (Constants::IMAGE_EXTS.contains(file.suffix())) {
+            auto thumb = ThumbnailManager::createThumbnail(asset->path, 128, 128);
+            pixmap = QPixmap::fromImage(*thumb->thumb);
+            item->setIcon(QIcon(pixmap));
+        }
 
-            item->setData(Qt::UserRole, asset->path);
-            item->setData(MODEL_GUID_ROLE, asset->assetGuid);
+        item->setData(Qt::UserRole, asset->path);
+        item->setData(MODEL_GUID_ROLE, asset->assetGuid);
 
-            if (filter.isEmpty()) {
+        if (filter.isEmpty()) {
+            ui->assetView->addItem(item);
+        } else {
+            if (asset->fileName.contains(filter)) {
                 ui->assetView->addItem(item);
-            } else {
-                if (asset->fileName.contains(filter)) {
-                    ui->assetView->addItem(item);
-                }
             }
         }
     }
@@ -16,6 +16,7 @@ For more information see the LICENSE file
 #include "dialogs/preferences/worldsettingswidget.h"
 
 #include "irisgl/src/core/irisutils.h"
+#include "irisgl/src/core/logger.h"
 #include "irisgl/src/graphics/mesh.h"
 #include "zip.h"
 
@@ -443,7 +444,15 @@ AssetView::AssetView(Database *handle, QWidget *parent) : db(handle), QWidget(pa
 	searchTimer->setSingleShot(true);   // timer can only fire once after started
 
 	connect(searchTimer, &QTimer::timeout, this, [this]() {
-		fastGrid->searchTiles(searchTerm.toLower());
+		if (searchTerm.isEmpty()) {
+			fastGrid->filterAssets(-1);
+			return;
+		}
+
+		// the search index ranks the matches, the grid only reorders its tiles to suit
+		QStringList guids;
+		for (const auto &record : db->searchLibraryAssets(searchTerm)) guids.append(record.guid);
+		fastGrid->searchTiles(guids);
 	});
 
 	filterPane = new QWidget;
@@ -541,6 +550,13 @@ AssetView::AssetView(Database *handle, QWidget *parent) : db(handle), QWidget(pa
 		}
 	});
 
+	// Tiles fetch their thumbnails once they're painted
+	fastGrid->setThumbnailSource([this](const QStringList &guids) {
+		QHash<QString, QByteArray> thumbnails;
+		for (const auto &record : db->fetchAssetThumbnails(guids)) thumbnails.insert(record.guid, record.thumbnail);
+		return thumbnails;
+	});
+
 	// show assets
 	int i = 0;
 	foreach(const AssetRecord &record, db->fetchAssetsForAssetView()) {
@@ -555,18 +571,14 @@ AssetView::AssetView(Database *handle, QWidget *parent) : db(handle), QWidget(pa
 		object["license"] = record.license;
 
 		auto tags = QJsonDocument::fromBinaryData(record.tags);
+		auto sceneProperties = QJsonDocument::fromBinaryData(record.properties);
 
-		QImage image;
-		image.loadFromData(record.thumbnail, "PNG");
+		auto gridItem = new AssetGridItem(object, sceneProperties.object(), tags.object());
 
-        if (image.isNull() && record.type == static_cast<int>(ModelTypes::Shader)) {
-            image = QImage(IrisUtils::getAbsoluteAssetPath("app/icons/icons8-file-72.png"));
+        if (record.type == static_cast<int>(ModelTypes::Shader)) {
+            gridItem->fallbackIcon = IrisUtils::getAbsoluteAssetPath("app/icons/icons8-file-72.png");
         }
 
-		auto sceneProperties = QJsonDocument::fromBinaryData(record.properties);
-
-		auto gridItem = new AssetGridItem(object, image, sceneProperties.object(), tags.object());
-
 		connect(gridItem, &AssetGridItem::addAssetItemToProject, [this](AssetGridItem *item) {
 			addAssetItemToProject(item);
 		});
@@ -583,9 +595,6 @@ AssetView::AssetView(Database *handle, QWidget *parent) : db(handle), QWidget(pa
 		i++;
 	}
 
-	//QApplication::processEvents();
-	fastGrid->updateGridColumns(fastGrid->lastWidth);
-
     _metadataPane = new QWidget; 
 	_metadataPane->setObjectName(QStringLiteral("MetadataPane"));
     _metadataPane->setStyleSheet("background: #202020");
@@ -1102,6 +1111,9 @@ void AssetView::importJahModel(const QString &fileName, bool addToLibrary)
                             records,
 							AssetViewFilter::AssetsView);
 
+        // The import is rolled back as a whole on failure so there is nothing to clean up
+        if (guid.isEmpty()) return;
+
         const QString assetFolder = QDir(assetPath).filePath(guid);
         QDir().mkpath(assetFolder);
 
@@ -1239,6 +1251,11 @@ void AssetView::importJahBundle(const QString &fileName)
             records
         );
 
+        if (guid.isEmpty()) {
+            temporaryDir.remove();
+            return;
+        }
+
         QMap<QString, QString> guidsToReplace;
 
         QMap<QString, QString>::const_iterator ptIter;
@@ -1337,7 +1354,6 @@ void AssetView::addToJahLibrary(const QString fileName, const QString guid, bool
 
     fastGrid->addTo(gridItem, 0, true);
     QApplication::processEvents();
-    fastGrid->updateGridColumns(fastGrid->lastWidth);
 
     renameWidget->setVisible(true);
     tagWidget->setVisible(true);
@@ -1461,7 +1477,6 @@ void AssetView::addToLibrary(bool jfx)
 
 		fastGrid->addTo(gridItem, 0, true);
 		QApplication::processEvents();
-		fastGrid->updateGridColumns(fastGrid->lastWidth);
 
 		renameWidget->setVisible(true);
 		tagWidget->setVisible(true);
@@ -1540,12 +1555,6 @@ void AssetView::addAssetItemToProject(AssetGridItem *item)
 	//auto rh = viewer->rect().height() + 32;
 
 	//auto endRect = QRect(parent->pos().x(), parent->pos().y(), rw, rh);
-	Toast *t = new Toast(this);
-	t->showToast(
-		"Asset Added To Project",
-		QString("%1 has been added successfully to the open project.").arg(item->metadata["name"].toString()),
-		0, parent->pos(), QRect()
-	);
 
 	// get the current project working directory
 	auto pFldr = IrisUtils::join(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation), Constants::PROJECT_FOLDER);
@@ -1679,20 +1688,33 @@ void AssetView::addAssetItemToProject(AssetGridItem *item)
 		AssetViewFilter::Editor
     );
 
-    for (auto &asset : AssetManager::getAssets()) {
-        if (asset->type == ModelTypes::File) {
-            for (const auto &record : oldAssetRecords) {
-                if (record.name == asset->fileName) {
-                    asset->assetGuid = record.guid;
-                }
+    // The copy was rolled back, take out the placeholder assets and the files copied for them as well
+    if (guidReturned.isEmpty()) {
+        AssetManager::removeAsset(placeHolderGuid);
+        for (const auto &file : files) QFile::remove(file.second);
+        irisLog(QString("Couldn't add %1 to the project").arg(item->metadata["name"].toString()));
+        return;
+    }
+
+	Toast *t = new Toast(this);
+	t->showToast(
+		"Asset Added To Project",
+		QString("%1 has been added successfully to the open project.").arg(item->metadata["name"].toString()),
+		0, parent->pos(), QRect()
+	);
+
+    for (auto asset : AssetManager::getAssetsByType(ModelTypes::File)) {
+        for (const auto &record : oldAssetRecords) {
+            if (record.name == asset->fileName) {
+                AssetManager::updateAssetGuid(asset, record.guid);
             }
         }
     }
 
     if (jafType == ModelTypes::Texture) {
-        for (auto &asset : AssetManager::getAssets()) {
-            if (asset->assetGuid == placeHolderGuid && asset->type == ModelTypes::Texture) {
-                asset->assetGuid = guidReturned;
+        for (auto asset : AssetManager::getAssetsByGuid(placeHolderGuid)) {
+            if (asset->type == ModelTypes::Texture) {
+                AssetManager::updateAssetGuid(asset, guidReturned);
             }
         }
     }
@@ -1734,9 +1756,9 @@ void AssetView::addAssetItemToProject(AssetGridItem *item)
     }
 
     if (jafType == ModelTypes::Object) {
-        for (auto &asset : AssetManager::getAssets()) {
-            if (asset->assetGuid == placeHolderGuid && asset->type == ModelTypes::Object) {
-                asset->assetGuid = guidReturned;
+        for (auto asset : AssetManager::getAssetsByGuid(placeHolderGuid)) {
+            if (asset->type == ModelTypes::Object) {
+                AssetManager::updateAssetGuid(asset, guidReturned);
                 auto node = asset->getValue().value<iris::SceneNodePtr>();
                 auto material = db->fetchAssetData(guidReturned);
                 auto materialObj = QJsonDocument::fromBinaryData(material);
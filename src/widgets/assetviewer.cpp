@@ -24,6 +24,7 @@ For more information see the LICENSE file
 #include "io/scenewriter.h"
 #include "io/scenereader.h"
 #include "io/materialreader.hpp"
+#include "core/texturecache.h"
 
 #include <QApplication>
 #include <QFileDialog>
@@ -492,7 +493,7 @@ void AssetViewer::addJafSky(const QString& guid, bool firstAdd, bool cache)
 		QStringList dependency = db->fetchAssetDependeesByType(scene->skyGuid, ModelTypes::Texture);
 		if (!dependency.isEmpty()) {
 			auto image = IrisUtils::join(assetPath, db->fetchAsset(dependency.first()).name);
-			if (QFileInfo(image).isFile()) scene->setSkyTexture(iris::Texture2D::load(image, false));
+			if (QFileInfo(image).isFile()) scene->setSkyTexture(TextureCache::load(image, false));
 		}
 	}
 	else if (scene->skyType == iris::SkyType::CUBEMAP) {
@@ -514,20 +515,8 @@ void AssetViewer::addJafSky(const QString& guid, bool firstAdd, bool cache)
 			}
 		}
 
-		// We need at least one valid image to get some metadata from
-		QImage* info;
-		bool useTex = false;
-		for (const auto image : sides) {
-			if (!image.isEmpty()) {
-				info = new QImage(image);
-				useTex = true;
-				break;
-			}
-		}
-
-		if (useTex) {
-			scene->setSkyTexture(iris::Texture2D::createCubeMap(sides[0], sides[1], sides[2], sides[3], sides[4], sides[5], info));
-		}
+		auto cubeMap = TextureCache::loadCubeMap(sides[0], sides[1], sides[2], sides[3], sides[4], sides[5]);
+		if (!!cubeMap) scene->setSkyTexture(cubeMap);
 	}
 	else if (scene->skyType == iris::SkyType::MATERIAL) {
 		auto vert = skyDataDefinition.value("vertexShader").toString();
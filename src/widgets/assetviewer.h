@@ -48,6 +48,7 @@ For more information see the LICENSE file
 #include "dialogs/progressdialog.h"
 
 #include "irisgl/src/graphics/shadowmap.h"
+#include "core/texturecache.h"
 
 class AssetViewer : public QOpenGLWidget, protected QOpenGLFunctions_3_2_Core, iris::IModelReadProgress
 {
@@ -157,10 +158,10 @@ public:
 
         //TODO: move this to the sceneview widget or somewhere more appropriate
         if (lightNode->lightType == iris::LightType::Directional) {
-            lightNode->icon = iris::Texture2D::load(":/icons/light.png");
+            lightNode->icon = TextureCache::load(":/icons/light.png");
         }
         else {
-            lightNode->icon = iris::Texture2D::load(":/icons/bulb.png");
+            lightNode->icon = TextureCache::load(":/icons/bulb.png");
         }
 
         lightNode->iconSize = 0.5f;
@@ -9,210 +9,170 @@ and/or modify it under the terms of the GPLv3 License
 For more information see the LICENSE file
 *************************************************************************/
 
+#include <QContextMenuEvent>
+#include <QHash>
+#include <QMenu>
+#include <QMouseEvent>
+
 #include "assetviewgrid.h"
 #include "assetgriditem.h"
-#include "assetview.h"
-
-AssetViewGrid::AssetViewGrid(QWidget *parent) : QScrollArea(parent) {
-	this->parent = parent;
-	gridWidget = new QWidget(this);
-	_layout = new QGridLayout;
-	_layout->setMargin(0);
-	_layout->setSpacing(12);
-	gridCounter = 0;
-	gridWidget->setLayout(_layout);
-	setAlignment(Qt::AlignHCenter);
-	//setWidgetResizable(true);
-	setWidget(gridWidget);
-    setStyleSheet("background: #202020; border: 0");
+#include "assetgridmodel.h"
+
+AssetViewGrid::AssetViewGrid(QWidget *parent) : QListView(parent) {
+	model = new AssetGridModel(this);
+	emptyItem = new AssetGridItem(QJsonObject(), QJsonObject(), QJsonObject(), this);
+
+	setModel(model);
+	setItemDelegate(new AssetGridDelegate(this));
+
+	// every tile is the same size so the layout never has to measure them
+	setViewMode(QListView::IconMode);
+	setMovement(QListView::Static);
+	setResizeMode(QListView::Adjust);
+	setLayoutMode(QListView::Batched);
+	setUniformItemSizes(true);
+	setSpacing(6);
+	setSelectionMode(QAbstractItemView::NoSelection);
+	setEditTriggers(QAbstractItemView::NoEditTriggers);
+	setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+
+	setMouseTracking(true);
+	viewport()->setAttribute(Qt::WA_Hover);
+
+	setStyleSheet("background: #202020; border: 0");
 
 	setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 }
 
-void AssetViewGrid::updateImage() {
+void AssetViewGrid::setThumbnailSource(const std::function<QHash<QString, QByteArray>(const QStringList&)> &source)
+{
+	model->setThumbnailSource(source);
+}
 
+bool AssetViewGrid::containsTiles() const
+{
+	return !model->getItems().isEmpty();
 }
 
 // local
 void AssetViewGrid::addTo(AssetGridItem *item, int count, bool select)
 {
-	int columnCount = viewport()->width() / (128 + 10);
-	if (columnCount == 0) columnCount = 1;
+	Q_UNUSED(count);
 
-	originalItems.push_back(item);
+	item->setParent(this);
+	model->addItem(item);
 
-	connect(item, &AssetGridItem::singleClicked, [this](AssetGridItem *item) {
-		emit selectedTile(item);
-	});
+	connect(item, &AssetGridItem::changed, model, &AssetGridModel::refresh);
 
-	connect(item, &AssetGridItem::specialClicked, [this](AssetGridItem *item) {
-		emit selectedTileToAdd(item);
-	});
-
-	if (select) emit selectedTile(item);
-
-	_layout->addWidget(item, count / columnCount + 1, count % columnCount + 1);
-	gridWidget->adjustSize();
+	if (select) {
+		scrollTo(model->indexOf(item));
+		emit selectedTile(item);
+	}
 
-	emit gridCount(_layout->count());
+	emit gridCount(model->getItems().size());
 }
 
 void AssetViewGrid::addTo(QJsonObject details, QImage image, int count, QJsonObject properties, QJsonObject tags, bool select) {
-	auto sampleWidget = new AssetGridItem(details, image, properties, tags);
-
-	int columnCount = viewport()->width() / (128 + 10);
-	if (columnCount == 0) columnCount = 1;
-
-	originalItems.push_back(sampleWidget);
-
-	connect(sampleWidget, &AssetGridItem::singleClicked, [this](AssetGridItem *item) {
-		//qobject_cast<AssetView*>(parent)->fetchMetadata(item);
-        emit selectedTile(item);
-	});
-
-	connect(sampleWidget, &AssetGridItem::specialClicked, [this](AssetGridItem *item) {
-		emit selectedTileToAdd(item);
-	});
-
-	if (select) emit selectedTile(sampleWidget);
-
-	_layout->addWidget(sampleWidget, count / columnCount + 1, count % columnCount + 1);
-	gridWidget->adjustSize();
-
-	emit gridCount(_layout->count());
-}
-
-void AssetViewGrid::resizeEvent(QResizeEvent *event)
-{
-	lastWidth = event->size().width();
-	int check = event->size().width() / (128 + 10);
-	//gridWidget->setMinimumWidth(viewport()->width());
-
-	if (check != 0) {
-		updateGridColumns(event->size().width());
-	}
-	
-	QScrollArea::resizeEvent(event);
+	addTo(new AssetGridItem(details, image, properties, tags), count, select);
 }
 
 void AssetViewGrid::mousePressEvent(QMouseEvent *event)
 {
+	auto item = model->itemAt(indexAt(event->pos()));
+
 	if (event->button() == Qt::LeftButton) {
-		emit selectedTile(new AssetGridItem(QJsonObject(), QImage(), QJsonObject(), QJsonObject()));
+		if (!item) emit selectedTile(emptyItem);
+		else if (event->modifiers().testFlag(Qt::ShiftModifier)) emit selectedTileToAdd(item);
+		else emit selectedTile(item);
 	}
 
-	if (event->button() == Qt::RightButton) {
-		emit contextSelected(new AssetGridItem(QJsonObject(), QImage(), QJsonObject(), QJsonObject()));
+	if (event->button() == Qt::RightButton && !item) {
+		emit contextSelected(emptyItem);
 	}
 }
 
-void AssetViewGrid::deleteTile(AssetGridItem *widget)
+void AssetViewGrid::mouseMoveEvent(QMouseEvent *event)
 {
-    int index = _layout->indexOf(widget);
-    if (index != -1) {
-        int row, col, col_span, row_span;
-        _layout->getItemPosition(index, &row, &col, &col_span, &row_span);
-
-        auto w = _layout->itemAtPosition(row, col)->widget();
-        auto idx = _layout->layout()->indexOf(w);
-        auto item = _layout->takeAt(idx);
-        deleteChildWidgets(item);
-        item->widget()->deleteLater();
-
-        originalItems.removeOne(widget);
-        updateGridColumns(lastWidth);
-
-        emit gridCount(_layout->count());
-    }
+	viewport()->setCursor(indexAt(event->pos()).isValid() ? Qt::PointingHandCursor : Qt::ArrowCursor);
+	QListView::mouseMoveEvent(event);
 }
 
-void AssetViewGrid::deleteChildWidgets(QLayoutItem *item) {
-    if (item->layout()) {
-        // Process all child items recursively.
-        for (int i = 0; i < item->layout()->count(); i++) {
-            deleteChildWidgets(item->layout()->itemAt(i));
-        }
-    }
+void AssetViewGrid::contextMenuEvent(QContextMenuEvent *event)
+{
+	auto item = model->itemAt(indexAt(event->pos()));
+	if (!item) return;
+
+	QMenu menu("Context Menu", this);
+	menu.setStyleSheet(
+		"QMenu { background-color: #1A1A1A; color: #EEE; padding: 0; margin: 0; }"
+		"QMenu::item { background-color: #1A1A1A; padding: 6px 8px; margin: 0; }"
+		"QMenu::item:selected { background-color: #3498db; color: #EEE; padding: 6px 8px; margin: 0; }"
+		"QMenu::item : disabled { color: #555; }"
+	);
+
+	QAction add("Add to Project", this);
+	connect(&add, &QAction::triggered, this, [item]() {
+		emit item->addAssetItemToProject(item);
+	});
+	menu.addAction(&add);
+
+	QAction change("Change Collections", this);
+	connect(&change, &QAction::triggered, this, [item]() {
+		emit item->changeAssetCollection(item);
+	});
+	menu.addAction(&change);
 
-    // delete item->widget();
-    item->widget()->deleteLater();
+	QAction remove("Delete", this);
+	connect(&remove, &QAction::triggered, this, [item]() {
+		emit item->removeAssetFromProject(item);
+	});
+	menu.addAction(&remove);
+
+	menu.exec(event->globalPos());
 }
 
-void AssetViewGrid::searchTiles(QString searchString)
+void AssetViewGrid::deleteTile(AssetGridItem *item)
 {
-	int columnCount = lastWidth / (128 + 10);
-
-	int count = 0;
-	if (!searchString.isEmpty()) {
-		foreach (AssetGridItem *gridItem, originalItems) {
-			if (gridItem->textLabel->text().toLower().contains(searchString)) {
-				gridItem->setVisible(true);
-				_layout->addWidget(gridItem, count / columnCount + 1, count % columnCount + 1);
-				count++;
-			}
-			else {
-				gridItem->setVisible(false);
-			}
-		}
-	}
-	else {
-		foreach(AssetGridItem *gridItem, originalItems) {
-			gridItem->setVisible(true);
-			_layout->addWidget(gridItem, count / columnCount + 1, count % columnCount + 1);
-			count++;
-		}
-	}
+	if (!model->getItems().contains(item)) return;
+
+	model->removeItem(item);
+	item->deleteLater();
 
-	gridWidget->adjustSize();
+	emit gridCount(model->getItems().size());
 }
 
-void AssetViewGrid::filterAssets(int id)
+void AssetViewGrid::searchTiles(const QStringList &rankedGuids)
 {
-	int columnCount = lastWidth / (128 + 10);
-
-	int count = 0;
-	if (id != -1) {
-		foreach(AssetGridItem *gridItem, originalItems) {
-			if (gridItem->metadata["collection"].toInt() == id) {
-				gridItem->setVisible(true);
-				_layout->addWidget(gridItem, count / columnCount + 1, count % columnCount + 1);
-				count++;
-			}
-			else {
-				gridItem->setVisible(false);
-			}
-		}
+	QHash<QString, AssetGridItem*> tiles;
+	tiles.reserve(model->getItems().size());
+	for (auto item : model->getItems()) {
+		tiles.insert(item->metadata["guid"].toString(), item);
 	}
-	else {
-		foreach(AssetGridItem *gridItem, originalItems) {
-			gridItem->setVisible(true);
-			_layout->addWidget(gridItem, count / columnCount + 1, count % columnCount + 1);
-			count++;
-		}
+
+	QVector<AssetGridItem*> results;
+	results.reserve(rankedGuids.size());
+	for (const QString &guid : rankedGuids) {
+		if (auto item = tiles.value(guid)) results.append(item);
 	}
 
-	gridWidget->adjustSize();
+	model->showItems(results);
 }
 
-void AssetViewGrid::updateGridColumns(int width)
+void AssetViewGrid::filterAssets(int id)
 {
-	int columnCount = width / (128 + 10);
-	if (columnCount == 0) columnCount = 1;
-
-	int count = 0;
-	foreach(auto gridItem, originalItems) {
-		_layout->addWidget(gridItem, count / columnCount + 1, count % columnCount + 1);
-		count++;
+	if (id == -1) {
+		model->setFilter(AssetGridModel::Filter());
+		return;
 	}
 
-	// gridWidget->setMinimumWidth(gridCount * (180 + 10));
-	gridWidget->adjustSize();
+	model->setFilter([id](const AssetGridItem *item) {
+		return item->metadata["collection"].toInt() == id;
+	});
 }
 
 void AssetViewGrid::deselectAll()
 {
-	foreach(AssetGridItem *gridItem, originalItems) {
-		gridItem->selected = false;
-		gridItem->highlight(false);
+	for (auto item : model->getItems()) {
+		if (item->selected) item->highlight(false);
 	}
-}
\ No newline at end of file
+}
@@ -12,51 +12,52 @@ For more information see the LICENSE file
 #ifndef ASSETVIEWGRID_HPP
 #define ASSETVIEWGRID_HPP
 
-#include <QScrollArea>
-#include <QGridLayout>
+#include <functional>
+
+#include <QByteArray>
+#include <QHash>
+#include <QListView>
 #include <QJsonObject>
-#include <QResizeEvent>
+#include <QStringList>
 
 class AssetGridItem;
+class AssetGridModel;
 
-class AssetViewGrid : public QScrollArea
+// Library grid, a list view in icon mode so only the tiles in view are painted
+// Items are owned by the grid and handed out to AssetView as before
+class AssetViewGrid : public QListView
 {
 	Q_OBJECT
 
 public:
-	QGridLayout *_layout;
-	int lastWidth;
-	QWidget *parent;
-
 	AssetViewGrid(QWidget *parent);
 
-	void updateImage();
-
-    bool containsTiles() {
-        if (_layout->count()) return true;
-        return false;
-    }
-	void addTo(AssetGridItem *widget, int count, bool select = false);
+	// Where tiles get their encoded thumbnails from when they're first painted
+	void setThumbnailSource(const std::function<QHash<QString, QByteArray>(const QStringList&)> &source);
+	bool containsTiles() const;
+	void addTo(AssetGridItem *item, int count, bool select = false);
 	void addTo(QJsonObject details, QImage image, int count, QJsonObject properties, QJsonObject tags, bool select = false);
-	void resizeEvent(QResizeEvent *event);
-	void mousePressEvent(QMouseEvent*);
-	void updateGridColumns(int width);
 	void deselectAll();
-	void searchTiles(QString);
-    void deleteTile(AssetGridItem *widget);
-    void deleteChildWidgets(QLayoutItem *item);
+	// Shows the tiles of these assets in the given order, guids without a tile are skipped
+	void searchTiles(const QStringList &rankedGuids);
+	void deleteTile(AssetGridItem *item);
 	void filterAssets(int id);
 
+protected:
+	void mousePressEvent(QMouseEvent*) override;
+	void mouseMoveEvent(QMouseEvent*) override;
+	void contextMenuEvent(QContextMenuEvent*) override;
+
 private:
-	int gridCounter;
-	QWidget *gridWidget;
-	QList<AssetGridItem*> originalItems;
+	AssetGridModel *model;
+	// handed out for clicks on empty space, its metadata is always empty
+	AssetGridItem *emptyItem;
 
 signals:
 	void gridCount(int);
-    void selectedTile(AssetGridItem*);
+	void selectedTile(AssetGridItem*);
 	void contextSelected(AssetGridItem*);
 	void selectedTileToAdd(AssetGridItem*);
 };
 
-#endif // ASSETVIEWGRID_HPP
\ No newline at end of file
+#endif // ASSETVIEWGRID_HPP
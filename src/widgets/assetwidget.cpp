@@ -19,6 +19,7 @@ For more information see the LICENSE file
 #include <QDesktopServices>
 #include <QDir>
 #include <QDirIterator>
+#include <QElapsedTimer>
 #include <QDrag>
 #include <QJsonDocument>
 #include <QMenu>
@@ -26,13 +27,16 @@ For more information see the LICENSE file
 #include <QMimeData>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPixmapCache>
 #include <QPointer>
 #include <QProgressDialog>
 #include <QProcess>
+#include <QSet>
 #include <QTemporaryDir>
 #include <QComboBox>
 
 #include "irisgl/src/core/irisutils.h"
+#include "irisgl/src/core/logger.h"
 #include "irisgl/src/materials/custommaterial.h"
 #include "irisgl/src/scenegraph/particlesystemnode.h" 
 #include "irisgl/src/scenegraph/scene.h" 
@@ -51,6 +55,7 @@ For more information see the LICENSE file
 #include "core/thumbnailmanager.h"
 #include "editor/thumbnailgenerator.h"
 #include "core/assethelper.h"
+#include "io/assetimporter.h"
 #include "io/assetmanager.h"
 #include "io/scenewriter.h"
 #include "widgets/sceneviewwidget.h"
@@ -122,8 +127,8 @@ AssetWidget::AssetWidget(Database *handle, QWidget *parent) : QWidget(parent), u
 	connect(ui->importBtn, SIGNAL(pressed()), SLOT(importAssetB()));
 
 	// The signal will be emitted from another thread (Nick)
-	connect(ThumbnailGenerator::getSingleton()->renderThread,   SIGNAL(thumbnailComplete(ThumbnailResult*)),
-		    this,                                               SLOT(onThumbnailResult(ThumbnailResult*)));
+	connect(ThumbnailGenerator::getSingleton(), SIGNAL(thumbnailComplete(ThumbnailResult*)),
+		    this,                               SLOT(onThumbnailResult(ThumbnailResult*)));
 
 	connect(Globals::eventSubscriber,	&Subscriber::updateAssetSkyItemFromSkyPropertyWidget,
 			this,						&AssetWidget::updateAssetSkyItemFromSkyPropertyWidget);
@@ -253,8 +258,22 @@ AssetWidget::AssetWidget(Database *handle, QWidget *parent) : QWidget(parent), u
 
 	ui->searchBar->setPlaceholderText(tr("Type to search for assets..."));
 
+	assetImporter = new AssetImporter(this);
+	connect(assetImporter, &AssetImporter::assetsImported, this, &AssetWidget::onAssetsImported);
+	connect(assetImporter, &AssetImporter::finished, this, &AssetWidget::onImportFinished);
+
+	// Imports run in the background, the editor stays usable while they do
 	progressDialog = new ProgressDialog;
 	progressDialog->setLabelText("Importing assets...");
+	progressDialog->setWindowModality(Qt::NonModal);
+	progressDialog->setWindowFlags(progressDialog->windowFlags() | Qt::Tool);
+	progressDialog->setCancelable(true);
+	connect(progressDialog, &ProgressDialog::canceled, [this]() {
+		pendingJafImports.clear();
+		queuedImports.clear();
+		progressDialog->setLabelText("Canceling import...");
+		assetImporter->cancel();
+	});
 
 	setStyleSheet(
 		"QWidget#headerTEMP { background: #1A1A1A;}"
@@ -336,58 +355,58 @@ void AssetWidget::trigger()
 	populateAssetTree(true);
 
 	sceneView->makeCurrent();
-	for (auto &asset : AssetManager::getAssets()) {
-		if (asset->type == ModelTypes::Object) {
-			auto material = db->fetchAssetData(asset->assetGuid);
-			auto materialObj = QJsonDocument::fromBinaryData(material);
-
-			auto node = iris::MeshNode::loadAsSceneFragment(QString(), asset->getValue().value<AssimpObject*>()->getSceneData(),
-				[&](iris::MeshPtr mesh, iris::MeshMaterialData& data)
-			{
-				auto mat = iris::CustomMaterial::create();
-				mat->generate(IrisUtils::getAbsoluteAssetPath("app/shader_defs/Default.shader"));
-
-				return mat;
-			});
-
-			AssetHelper::updateNodeMaterial(node, materialObj.object());
-
-			//QString meshGuid = db->fetchObjectMesh(asset->assetGuid, static_cast<int>(ModelTypes::Object), static_cast<int>(ModelTypes::Mesh));
-
-			//std::function<void(iris::SceneNodePtr&)> updateNodeValues = [&](iris::SceneNodePtr &node) -> void {
-			//	if (node->getSceneNodeType() == iris::SceneNodeType::Mesh) {
-			//		auto n = node.staticCast<iris::MeshNode>();
-			//		n->meshPath = meshGuid;
-			//		auto mat = n->getMaterial().staticCast<iris::CustomMaterial>();
-			//		for (auto prop : mat->properties) {
-			//			if (prop->type == iris::PropertyType::Texture) {
-			//				if (!prop->getValue().toString().isEmpty()) {
-			//					mat->setValue(prop->name,
-			//						IrisUtils::join(Globals::project->getProjectFolder(), "Textures",
-			//							db->fetchAsset(prop->getValue().toString()).name));
-			//				}
-			//			}
-			//		}
-			//	}
-
-			//	if (node->hasChildren()) {
-			//		for (auto &child : node->children) {
-			//			updateNodeValues(child);
-			//		}
-			//	}
-			//};
-
-			//updateNodeValues(node);
-
-			QVariant variant = QVariant::fromValue(node);
-			auto nodeAsset = new AssetNodeObject;
-			nodeAsset->fileName = asset->fileName;
-			nodeAsset->assetGuid = asset->assetGuid;
-			nodeAsset->setValue(variant);
+	// Copy since the loop swaps the assets in the store
+	const auto objectAssets = AssetManager::getAssetsByType(ModelTypes::Object);
+	for (auto asset : objectAssets) {
+		auto material = db->fetchAssetData(asset->assetGuid);
+		auto materialObj = QJsonDocument::fromBinaryData(material);
+
+		auto node = iris::MeshNode::loadAsSceneFragment(QString(), asset->getValue().value<AssimpObject*>()->getSceneData(),
+			[&](iris::MeshPtr mesh, iris::MeshMaterialData& data)
+		{
+			auto mat = iris::CustomMaterial::create();
+			mat->generate(IrisUtils::getAbsoluteAssetPath("app/shader_defs/Default.shader"));
+
+			return mat;
+		});
 
-			// Replace the raw aiScene with a SceneNode
-			asset = nodeAsset;
-		}
+		AssetHelper::updateNodeMaterial(node, materialObj.object());
+
+		//QString meshGuid = db->fetchObjectMesh(asset->assetGuid, static_cast<int>(ModelTypes::Object), static_cast<int>(ModelTypes::Mesh));
+
+		//std::function<void(iris::SceneNodePtr&)> updateNodeValues = [&](iris::SceneNodePtr &node) -> void {
+		//	if (node->getSceneNodeType() == iris::SceneNodeType::Mesh) {
+		//		auto n = node.staticCast<iris::MeshNode>();
+		//		n->meshPath = meshGuid;
+		//		auto mat = n->getMaterial().staticCast<iris::CustomMaterial>();
+		//		for (auto prop : mat->properties) {
+		//			if (prop->type == iris::PropertyType::Texture) {
+		//				if (!prop->getValue().toString().isEmpty()) {
+		//					mat->setValue(prop->name,
+		//						IrisUtils::join(Globals::project->getProjectFolder(), "Textures",
+		//							db->fetchAsset(prop->getValue().toString()).name));
+		//				}
+		//			}
+		//		}
+		//	}
+
+		//	if (node->hasChildren()) {
+		//		for (auto &child : node->children) {
+		//			updateNodeValues(child);
+		//		}
+		//	}
+		//};
+
+		//updateNodeValues(node);
+
+		QVariant variant = QVariant::fromValue(node);
+		auto nodeAsset = new AssetNodeObject;
+		nodeAsset->fileName = asset->fileName;
+		nodeAsset->assetGuid = asset->assetGuid;
+		nodeAsset->setValue(variant);
+
+		// Replace the raw aiScene with a SceneNode
+		AssetManager::replaceAsset(asset, nodeAsset);
 	}
 	sceneView->doneCurrent();
 }
@@ -521,6 +540,26 @@ void AssetWidget::generateAssetThumbnails()
 	//}
 }
 
+QVariant AssetViewItem::data(int role) const
+{
+	if (role == Qt::DecorationRole) {
+		const QByteArray thumbnail = QListWidgetItem::data(MODEL_THUMBNAIL_ROLE).toByteArray();
+		if (!thumbnail.isEmpty()) {
+			const QString key = QString("assetview_%1_%2")
+				.arg(QListWidgetItem::data(MODEL_GUID_ROLE).toString())
+				.arg(qHash(thumbnail));
+
+			QPixmap pixmap;
+			if (QPixmapCache::find(key, &pixmap) || pixmap.loadFromData(thumbnail, "PNG")) {
+				QPixmapCache::insert(key, pixmap);
+				return QIcon(pixmap);
+			}
+		}
+	}
+
+	return QListWidgetItem::data(role);
+}
+
 void AssetWidget::addItem(const FolderRecord &folderData)
 {
     if (!folderData.visible) return;
@@ -547,7 +586,7 @@ void AssetWidget::addItem(const AssetRecord &assetData)
         return;
     }
 
-	QListWidgetItem *item = new QListWidgetItem;
+	QListWidgetItem *item = new AssetViewItem;
 	item->setData(Qt::DisplayRole, QFileInfo(assetData.name).baseName());
     item->setData(Qt::UserRole, assetData.name);
     item->setData(MODEL_TYPE_ROLE, assetData.type);
@@ -555,13 +594,9 @@ void AssetWidget::addItem(const AssetRecord &assetData)
 	item->setData(MODEL_GUID_ROLE, assetData.guid);
 	item->setData(MODEL_PARENT_ROLE, assetData.parent);
 
-    QPixmap thumbnail;
-    if (thumbnail.loadFromData(assetData.thumbnail, "PNG")) {
-        item->setIcon(QIcon(thumbnail));
-    }
-    else {
-        item->setIcon(QIcon(":/icons/empty_object.png"));
-    }
+    // Used when there's no thumbnail or it doesn't decode, the thumbnail itself is decoded when painted
+    item->setData(MODEL_THUMBNAIL_ROLE, assetData.thumbnail);
+    item->setIcon(QIcon(":/icons/empty_object.png"));
 
 	if (assetData.type == static_cast<int>(ModelTypes::Texture)) {
 
@@ -572,22 +607,24 @@ void AssetWidget::addItem(const AssetRecord &assetData)
 		item->setData(SKY_TYPE_ROLE, skyType);
 		item->setData(MODEL_TYPE_ROLE, assetData.type);
 		item->setIcon(QIcon(":/icons/icons8-file-sky.png"));
+		item->setData(MODEL_THUMBNAIL_ROLE, QVariant());
 	}
 
 	if (assetData.type == static_cast<int>(ModelTypes::Music)) {
 		item->setData(MODEL_TYPE_ROLE, assetData.type);
 		item->setIcon(QIcon(":/icons/icons8-file-music.png"));
+		item->setData(MODEL_THUMBNAIL_ROLE, QVariant());
 	}
 
     if (assetData.type == static_cast<int>(ModelTypes::Shader)) {
         item->setData(MODEL_TYPE_ROLE, assetData.type);
-		if(thumbnail.loadFromData(assetData.thumbnail, "PNG"))   item->setIcon(QIcon(thumbnail));
-		else item->setIcon(QIcon(":/icons/icons8-file-72.png"));
+		item->setIcon(QIcon(":/icons/icons8-file-72.png"));
     }
 
     if (assetData.type == static_cast<int>(ModelTypes::ParticleSystem)) {
         item->setData(MODEL_TYPE_ROLE, assetData.type);
         item->setIcon(QIcon(":/icons/icons8-file-72-ps.png"));
+        item->setData(MODEL_THUMBNAIL_ROLE, QVariant());
     }
 
     if (assetData.type == static_cast<int>(ModelTypes::File)) {
@@ -595,6 +632,7 @@ void AssetWidget::addItem(const AssetRecord &assetData)
         // TODO - make this some generic value all assets can use
         //item->setData(MODEL_MESH_ROLE, shaderAssetName.name);
         item->setIcon(QIcon(":/icons/icons8-file-72-file.png"));
+        item->setData(MODEL_THUMBNAIL_ROLE, QVariant());
     }
 	
     if (assetData.type == static_cast<int>(ModelTypes::Material)) {
@@ -642,8 +680,74 @@ void AssetWidget::addCrumbs(const QVector<FolderRecord> &folderData)
 	}
 }
 
+// Child asset listings don't carry thumbnails, fetch them in one batch for the items that use one
+void AssetWidget::loadAssetViewThumbnails()
+{
+    QMap<QString, QListWidgetItem*> thumbnailItems;
+    for (int i = 0; i < ui->assetView->count(); ++i) {
+        auto item = ui->assetView->item(i);
+        if (item->data(MODEL_ITEM_TYPE).toInt() != MODEL_ASSET) continue;
+
+        const int type = item->data(MODEL_TYPE_ROLE).toInt();
+        if (type == static_cast<int>(ModelTypes::Sky)              ||
+            type == static_cast<int>(ModelTypes::Music)            ||
+            type == static_cast<int>(ModelTypes::ParticleSystem)   ||
+            type == static_cast<int>(ModelTypes::File))
+        {
+            continue;
+        }
+
+        thumbnailItems.insert(item->data(MODEL_GUID_ROLE).toString(), item);
+    }
+
+    if (thumbnailItems.isEmpty()) return;
+
+    QSet<QString> hasThumbnail;
+    for (const auto &record : db->fetchAssetThumbnails(thumbnailItems.keys())) {
+        thumbnailItems.value(record.guid)->setData(MODEL_THUMBNAIL_ROLE, record.thumbnail);
+        if (!record.thumbnail.isEmpty()) hasThumbnail.insert(record.guid);
+    }
+
+    // Thumbnails still queued for these tiles go first, objects that never got one are rendered once
+    auto generator = ThumbnailGenerator::getSingleton();
+    for (auto it = thumbnailItems.constBegin(); it != thumbnailItems.constEnd(); ++it) {
+        if (hasThumbnail.contains(it.key())) continue;
+
+        if (generator->prioritiseRequest(it.key(), ThumbnailPriority::Visible)) {
+            viewThumbnails.append(it.key());
+        }
+        else if (it.value()->data(MODEL_TYPE_ROLE).toInt() == static_cast<int>(ModelTypes::Object) &&
+                 !renderedThumbnails.contains(it.key()))
+        {
+            generator->requestThumbnail(
+                ThumbnailRequestType::ImportedMesh, QString(), it.key(), false, ThumbnailPriority::Visible
+            );
+            renderedThumbnails.insert(it.key());
+            viewThumbnails.append(it.key());
+        }
+    }
+}
+
+void AssetWidget::releaseViewThumbnails()
+{
+    // Renders only wanted for the tiles we're leaving are dropped, import thumbnails still get saved
+    // but go back behind everything else
+    auto generator = ThumbnailGenerator::getSingleton();
+    for (const auto &guid : viewThumbnails) {
+        if (renderedThumbnails.contains(guid)) {
+            if (generator->cancelRequest(guid)) renderedThumbnails.remove(guid);
+        }
+        else {
+            generator->prioritiseRequest(guid, ThumbnailPriority::Background);
+        }
+    }
+
+    viewThumbnails.clear();
+}
+
 void AssetWidget::updateAssetView(const QString &path, int filter, bool showDependencies)
 {
+	releaseViewThumbnails();
 	ui->assetView->clear();
 
     if (filter > 0) {
@@ -655,11 +759,14 @@ void AssetWidget::updateAssetView(const QString &path, int filter, bool showDepe
         addCrumbs(db->fetchCrumbTrail(path));
     }
 
+    loadAssetViewThumbnails();
+
     goUpOneControl->setEnabled(false);
 }
 
 void AssetWidget::updateAssetContentsView(const QString &guid)
 {
+    releaseViewThumbnails();
     ui->assetView->clear();
     for (const auto &asset : db->fetchAssetsFromParent(guid)) addItem(asset);
 }
@@ -1365,7 +1472,7 @@ void AssetWidget::exportMaterialPreview()
     file.close();
 
     ThumbnailGenerator::getSingleton()->requestThumbnail(
-        ThumbnailRequestType::Material, fileName, assetGuid, true
+        ThumbnailRequestType::Material, fileName, assetGuid, true, ThumbnailPriority::Preview
     );
 
     //QFile::remove(fileName);
@@ -1555,7 +1662,14 @@ void AssetWidget::searchAssets(QString searchString)
 	ui->assetView->clear();
 
 	if (!searchString.isEmpty()) {
-		// keep a list of last db fetch in memory OR search entire db...
+		// Only the best matches are listed, the panel refreshes on every keystroke
+		const int searchResultLimit = 250;
+		const auto results = db->searchProjectAssets(
+			searchString, Globals::project->getProjectGuid(), 0, searchResultLimit
+		);
+
+		for (const auto &asset : results) addItem(asset);
+		loadAssetViewThumbnails();
 	}
 	else {
 		updateAssetView(assetItem.selectedGuid, activeFilter, showDependencies);
@@ -1579,23 +1693,19 @@ void AssetWidget::OnLstItemsCommitData(QWidget *listItem)
 					QDir(Globals::project->getProjectFolder()).filePath(oldName).toStdString().c_str(),
 					QDir(Globals::project->getProjectFolder()).filePath(newFileName).toStdString().c_str()
 				)) {
-					for (auto &asset : AssetManager::getAssets()) {
-                        if (asset->assetGuid == guid) {
-                            asset->fileName = newFileName;
-                            if (!asset->path.isEmpty()) {
-                                asset->path = QDir(Globals::project->getProjectFolder()).filePath(newFileName);
-                            }
+					for (auto asset : AssetManager::getAssetsByGuid(guid)) {
+                        asset->fileName = newFileName;
+                        if (!asset->path.isEmpty()) {
+                            AssetManager::updateAssetPath(asset, QDir(Globals::project->getProjectFolder()).filePath(newFileName));
                         }
 					}
 				}
             }
             else {
-                for (auto &asset : AssetManager::getAssets()) {
-                    if (asset->assetGuid == guid) {
-                        asset->fileName = newFileName;
-                        if (!asset->path.isEmpty()) {
-                            asset->path = QDir(Globals::project->getProjectFolder()).filePath(newFileName);
-                        }
+                for (auto asset : AssetManager::getAssetsByGuid(guid)) {
+                    asset->fileName = newFileName;
+                    if (!asset->path.isEmpty()) {
+                        AssetManager::updateAssetPath(asset, QDir(Globals::project->getProjectFolder()).filePath(newFileName));
                     }
                 }
             }
@@ -2170,21 +2280,21 @@ void AssetWidget::importJafAssets(const QList<directory_tuple> &fileNames)
                 assetItem.selectedGuid
             );
 
+            if (guidReturned.isEmpty()) continue;
+
             // The multiple for loops are intentional, don't try to optimize this, each asset type must be updated
-            for (auto &asset : AssetManager::getAssets()) {
-                if (asset->type == ModelTypes::File) {
-                    for (const auto &record : oldAssetRecords) {
-                        if (record.name == asset->fileName) {
-                            asset->assetGuid = record.guid;
-                        }
+            for (auto asset : AssetManager::getAssetsByType(ModelTypes::File)) {
+                for (const auto &record : oldAssetRecords) {
+                    if (record.name == asset->fileName) {
+                        AssetManager::updateAssetGuid(asset, record.guid);
                     }
                 }
             }
 
             if (jafType == ModelTypes::Texture) {
-                for (auto &asset : AssetManager::getAssets()) {
-                    if (asset->assetGuid == placeHolderGuid && asset->type == ModelTypes::Texture) {
-                        asset->assetGuid = guidReturned;
+                for (auto asset : AssetManager::getAssetsByGuid(placeHolderGuid)) {
+                    if (asset->type == ModelTypes::Texture) {
+                        AssetManager::updateAssetGuid(asset, guidReturned);
                     }
                 }
             }
@@ -2242,23 +2352,15 @@ void AssetWidget::importJafAssets(const QList<directory_tuple> &fileNames)
                     material->generate(shaderFile.absoluteFilePath());
                 }
                 else {
-                    for (auto asset : AssetManager::getAssets()) {
-                        if (asset->type == ModelTypes::Shader) {
-                            if (asset->assetGuid == matObject["guid"].toString()) {
-                                auto def = asset->getValue().toJsonObject();
-                                auto vertexShader = def["vertex_shader"].toString();
-                                auto fragmentShader = def["fragment_shader"].toString();
-                                for (auto asset : AssetManager::getAssets()) {
-                                    if (asset->type == ModelTypes::File) {
-                                        if (vertexShader == asset->assetGuid) vertexShader = asset->path;
-                                        if (fragmentShader == asset->assetGuid) fragmentShader = asset->path;
-                                    }
-                                }
-                                def["vertex_shader"] = vertexShader;
-                                def["fragment_shader"] = fragmentShader;
-                                material->generate(def);
-                            }
-                        }
+                    if (auto asset = AssetManager::getAssetByGuid(matObject["guid"].toString(), ModelTypes::Shader)) {
+                        auto def = asset->getValue().toJsonObject();
+                        auto vertexShader = def["vertex_shader"].toString();
+                        auto fragmentShader = def["fragment_shader"].toString();
+                        if (auto vertexAsset = AssetManager::getAssetByGuid(vertexShader, ModelTypes::File)) vertexShader = vertexAsset->path;
+                        if (auto fragmentAsset = AssetManager::getAssetByGuid(fragmentShader, ModelTypes::File)) fragmentShader = fragmentAsset->path;
+                        def["vertex_shader"] = vertexShader;
+                        def["fragment_shader"] = fragmentShader;
+                        material->generate(def);
                     }
                 }
 
@@ -2295,9 +2397,9 @@ void AssetWidget::importJafAssets(const QList<directory_tuple> &fileNames)
             }
 
             if (jafType == ModelTypes::Object) {
-                for (auto &asset : AssetManager::getAssets()) {
-                    if (asset->assetGuid == placeHolderGuid && asset->type == ModelTypes::Object) {
-                        asset->assetGuid = guidReturned;
+                for (auto asset : AssetManager::getAssetsByGuid(placeHolderGuid)) {
+                    if (asset->type == ModelTypes::Object) {
+                        AssetManager::updateAssetGuid(asset, guidReturned);
                         auto node = asset->getValue().value<iris::SceneNodePtr>();
                         
                         auto materialObj = QJsonDocument::fromBinaryData(db->fetchAssetData(asset->assetGuid));
@@ -2314,283 +2416,392 @@ void AssetWidget::importJafAssets(const QList<directory_tuple> &fileNames)
 
 void AssetWidget::importRegularAssets(const QList<directory_tuple> &fileNames)
 {
-	int counter = 0;
 	// If we're loading a single asset, it's likely a single large file, make the progress indeterminate
 	int maxRange = fileNames.size() == 1 ? 0 : fileNames.size();
 
+	progressDialog->setLabelText("Importing assets...");
 	progressDialog->setRange(0, maxRange);
 	progressDialog->setValue(0);
 	progressDialog->show();
-	QApplication::processEvents();
 
-	QList<directory_tuple> imagesInUse;
+	importedImages.clear();
+
+	QVector<AssetImportJob> jobs;
+	QSet<QString> reservedPaths;
+
+	const bool inTransaction = db->beginTransaction("Import folder creation");
 
 	foreach(const auto &entry, fileNames) {
 		QFileInfo entryInfo(entry.path);
 
 		if (entryInfo.isDir()) {
 			db->createFolder(entryInfo.baseName(), entry.parent_guid, entry.guid);
+			continue;
 		}
-		else {
-			QString fileName;
-			QString fileAbsolutePath;
-
-			ModelTypes type;
-			QPixmap thumbnail = QPixmap(":/icons/empty_object.png");
-
-			auto asset = new AssetVariant;
-			asset->type		 = AssetHelper::getAssetTypeFromExtension(entryInfo.suffix().toLower());
-			asset->fileName  = entryInfo.fileName();
-			asset->path		 = entry.path;
-			asset->thumbnail = thumbnail;
-
-			if (asset->type != ModelTypes::Undefined) {
-				QString pathToCopyTo = Globals::project->getProjectFolder();
-				QString fileToCopyTo = IrisUtils::join(pathToCopyTo, asset->fileName);
-
-				int increment = 1;
-				QFileInfo checkFile(fileToCopyTo);
-
-				// If we encounter the same file, make a duplicate...
-				// Maybe ask the user to replace sometime later on (iKlsR)
-				while (checkFile.exists()) {
-                    // Repeatedly test if a file exists by incrementally adding a numeral to the base name
-					QString newName = QString(entryInfo.baseName() + " %1").arg(QString::number(increment++));
-					checkFile = QFileInfo(
-                        IrisUtils::buildFileName(IrisUtils::join(pathToCopyTo, newName), entryInfo.suffix())
-                    );
-					asset->fileName = checkFile.fileName();
-					fileToCopyTo = checkFile.absoluteFilePath();
-				}
 
-                // Accumulate a list of all the images imported so we can use this to update references
-                // If they are used in assets that depend on them such as Materials and Objects
-                {
-                    if (asset->type == ModelTypes::Texture) {
-                        auto thumb = ThumbnailManager::createThumbnail(entryInfo.absoluteFilePath(), 72, 72);
-                        thumbnail = QPixmap::fromImage(*thumb->thumb);
-
-                        directory_tuple dt;
-                        dt.parent_guid = entry.parent_guid;
-                        dt.guid = entry.guid;
-                        dt.path = entryInfo.fileName();
-                        imagesInUse.append(dt);
-                    }
-                }
+		AssetImportJob job;
+		job.sourcePath = entry.path;
+		job.guid	   = entry.guid;
+		job.parentGuid = entry.parent_guid;
+		job.type	   = AssetHelper::getAssetTypeFromExtension(entryInfo.suffix().toLower());
+		job.fileName   = entryInfo.fileName();
+		// Shaders, materials and models get their own records per import, plain files can be shared
+		job.deduplicate = job.type == ModelTypes::Texture ||
+						  job.type == ModelTypes::Music ||
+						  job.type == ModelTypes::File;
+
+		if (job.type == ModelTypes::Undefined) continue;
+
+		QString pathToCopyTo = Globals::project->getProjectFolder();
+		QString fileToCopyTo = IrisUtils::join(pathToCopyTo, job.fileName);
+
+		int increment = 1;
+		QFileInfo checkFile(fileToCopyTo);
+
+		// If we encounter the same file, make a duplicate...
+		// Maybe ask the user to replace sometime later on (iKlsR)
+		// Files are copied concurrently so names already taken by this import count as well
+		while (checkFile.exists() || reservedPaths.contains(checkFile.absoluteFilePath())) {
+			// Repeatedly test if a file exists by incrementally adding a numeral to the base name
+			QString newName = QString(entryInfo.baseName() + " %1").arg(QString::number(increment++));
+			checkFile = QFileInfo(
+				IrisUtils::buildFileName(IrisUtils::join(pathToCopyTo, newName), entryInfo.suffix())
+			);
+			job.fileName = checkFile.fileName();
+			fileToCopyTo = checkFile.absoluteFilePath();
+		}
 
-				const QString assetGuid = db->createAssetEntry(entry.guid,
-															   asset->fileName,
-															   static_cast<int>(asset->type),
-															   entry.parent_guid,
-                                                               QString(),
-                                                               QString(),
-                                                               AssetHelper::makeBlobFromPixmap(thumbnail));
+		reservedPaths.insert(checkFile.absoluteFilePath());
+		job.destination = fileToCopyTo;
+		jobs.append(job);
+	}
 
-                if (asset->type == ModelTypes::File) {
-                    auto assetFile = new AssetFile;
-                    assetFile->assetGuid = assetGuid;
-                    assetFile->fileName = asset->fileName;
-                    assetFile->path = fileToCopyTo;
-                    AssetManager::addAsset(assetFile);
-                }
+	db->endTransaction(inTransaction, true, "Import folder creation");
 
-				if (asset->type == ModelTypes::Music) {
-					auto assetMusic = new AssetMusic;
-					assetMusic->assetGuid = assetGuid;
-					assetMusic->fileName = asset->fileName;
-					assetMusic->path = fileToCopyTo;
-					AssetManager::addAsset(assetMusic);
-				}
+	if (jobs.isEmpty()) {
+		onImportFinished();
+		return;
+	}
 
-                if (asset->type == ModelTypes::Texture) {
-                    auto assetTexture = new AssetTexture;
-                    assetTexture->assetGuid = assetGuid;
-                    assetTexture->fileName = asset->fileName;
-                    assetTexture->path = fileToCopyTo;
-                    AssetManager::addAsset(assetTexture);
-                }
+	importedHashes = db->fetchAssetHashes(Globals::project->getProjectGuid());
 
-                if (asset->type == ModelTypes::Shader) {
-                    QFile *shaderFile = new QFile(asset->path);
-                    shaderFile->open(QIODevice::ReadOnly | QIODevice::Text);
-                    QJsonObject shaderDefinition = QJsonDocument::fromJson(shaderFile->readAll()).object();
-                    shaderFile->close();
+	// Hashing, copying, decoding and parsing happen on the thread pool, results come back in onAssetsImported
+	assetImporter->start(jobs, importedHashes);
+}
 
-                    shaderDefinition["name"] = QFileInfo(asset->fileName).baseName();
-                    shaderDefinition["guid"] = assetGuid;
+void AssetWidget::onAssetsImported(const QVector<AssetImportResult> &results, int done, int total)
+{
+	QElapsedTimer timer;
+	timer.start();
 
-                    db->updateAssetAsset(assetGuid, QJsonDocument(shaderDefinition).toBinaryData());
+	// Everything that arrived together is written in a single transaction
+	const bool inTransaction = db->beginTransaction("Asset import batch");
 
-                    auto assetShader = new AssetShader;
-                    assetShader->assetGuid = assetGuid;
-                    assetShader->fileName = QFileInfo(asset->fileName).baseName();
-                    assetShader->setValue(QVariant::fromValue(shaderDefinition));
-                    AssetManager::addAsset(assetShader);
-                }
+	for (const auto &result : results) {
+		importAssetResult(result);
+	}
 
-				if (asset->type == ModelTypes::Material) {
-					ThumbnailGenerator::getSingleton()->requestThumbnail(
-						ThumbnailRequestType::Material, asset->path, assetGuid
-					);
+	db->endTransaction(inTransaction, true, "Asset import batch");
 
-					QJsonObject jsonMaterial;
-					QStringList texturesToCopy;
-					extractTexturesAndMaterialFromMaterial(asset->path, texturesToCopy, jsonMaterial);
+	// a single file stays indeterminate
+	if (total > 1) {
+		progressDialog->setRange(0, total);
+		progressDialog->setValue(done);
+	}
+	progressDialog->setLabelText("Importing " + results.last().job.fileName);
 
-					QString jsonMaterialString = QJsonDocument(jsonMaterial).toJson();
+	assetImporter->addCommitTime(timer.nsecsElapsed());
+}
 
-					// Update the embedded material to point to image asset guids
-					for (const auto &image : imagesInUse) {
-						if (texturesToCopy.contains(QFileInfo(image.path).fileName())) {
-							jsonMaterialString.replace(QFileInfo(image.path).fileName(), image.guid);
-						}
-					}
+void AssetWidget::importAssetResult(const AssetImportResult &result)
+{
+	const AssetImportJob &job = result.job;
+
+	if (!result.contentHash.isEmpty()) {
+		// Files identical to one earlier in this import are only found here, after they were copied
+		const QString existingGuid = !result.duplicateOf.isEmpty()
+			? result.duplicateOf
+			: importedHashes.value(result.contentHash);
+
+		if (!existingGuid.isEmpty()) {
+			if (result.copied) QFile::remove(job.destination);
+
+			// Materials and models of this import refer to (and depend on) the existing texture instead
+			if (job.type == ModelTypes::Texture) {
+				directory_tuple dt;
+				dt.parent_guid = job.parentGuid;
+				dt.guid = existingGuid;
+				dt.path = QFileInfo(job.sourcePath).fileName();
+				importedImages.append(dt);
+			}
 
-					QJsonDocument jsonMaterialGuids = QJsonDocument::fromJson(jsonMaterialString.toUtf8());
-					db->updateAssetAsset(assetGuid, jsonMaterialGuids.toBinaryData());
+			irisLog(QString("%1 is identical to an asset already in the project, using that instead").arg(job.sourcePath));
+			return;
+		}
+	}
 
-					// Create dependencies to the object for the textures used
-					for (const auto &image : imagesInUse) {
-						if (texturesToCopy.contains(QFileInfo(image.path).fileName())) {
-							db->createDependency(
-                                static_cast<int>(ModelTypes::Material), static_cast<int>(ModelTypes::Texture),
-                                assetGuid, image.guid, Globals::project->getProjectGuid()
-                            );
-						}
-					}
+	QPixmap thumbnail = QPixmap(":/icons/empty_object.png");
+	QByteArray thumbnailBlob;
 
-					QJsonDocument matDoc = QJsonDocument::fromBinaryData(db->fetchAssetData(assetGuid));
-					QJsonObject matObject = matDoc.object();
-					iris::CustomMaterialPtr material = iris::CustomMaterialPtr::create();
-					material->generate(IrisUtils::join(
-						IrisUtils::getAbsoluteAssetPath(Constants::SHADER_DEFS),
-						IrisUtils::buildFileName(matObject.value("name").toString(), "shader"))
-					);
-
-					for (const auto &prop : material->properties) {
-						if (prop->type == iris::PropertyType::Color) {
-							QColor col;
-							col.setNamedColor(matObject.value(prop->name).toString());
-							material->setValue(prop->name, col);
-						}
-						else if (prop->type == iris::PropertyType::Texture) {
-							QString materialName = db->fetchAsset(matObject.value(prop->name).toString()).name;
-							QString textureStr = IrisUtils::join(Globals::project->getProjectFolder(), materialName);
-							material->setValue(prop->name, !materialName.isEmpty() ? textureStr : QString());
-						}
-						else {
-							material->setValue(prop->name, QVariant::fromValue(matObject.value(prop->name)));
-						}
-					}
+	// Accumulate a list of all the images imported so we can use this to update references
+	// If they are used in assets that depend on them such as Materials and Objects
+	if (job.type == ModelTypes::Texture) {
+		thumbnailBlob = result.thumbnail;
 
-					auto assetMat = new AssetMaterial;
-					assetMat->assetGuid = assetGuid;
-					assetMat->setValue(QVariant::fromValue(material));
-					AssetManager::addAsset(assetMat);
-				}
+		directory_tuple dt;
+		dt.parent_guid = job.parentGuid;
+		dt.guid = job.guid;
+		dt.path = QFileInfo(job.sourcePath).fileName();
+		importedImages.append(dt);
+	}
+	else {
+		thumbnailBlob = AssetHelper::makeBlobFromPixmap(thumbnail);
+	}
 
-				if (asset->type == ModelTypes::Mesh) {
-					QStringList texturesToCopy;
-					this->sceneView->makeCurrent();
-					auto scene = AssetHelper::extractTexturesAndMaterialFromMesh(asset->path, texturesToCopy);
-					this->sceneView->doneCurrent();
-
-					QString preObjectGuid = GUIDManager::generateGUID();
-
-					// Replace all path references with GUIDs before storing in the database
-					std::function<void(iris::SceneNodePtr&)> replacePathsWithGUIDs =
-                        [&](iris::SceneNodePtr &node) -> void {
-						if (node->getSceneNodeType() == iris::SceneNodeType::Mesh) {
-							auto meshNode = node.staticCast<iris::MeshNode>();
-							if (QFileInfo(meshNode->meshPath).fileName() == entryInfo.fileName()) {
-                                meshNode->meshPath = assetGuid;
-							}
+	const QList<directory_tuple> &imagesInUse = importedImages;
 
-							meshNode->setGUID(preObjectGuid);
-
-							auto material = meshNode->getMaterial().staticCast<iris::CustomMaterial>();
-							for (auto prop : material->properties) {
-								if (prop->type == iris::PropertyType::Texture) {
-                                    // Cycle through any textures that were selected in the import and use them
-									for (const auto &image : imagesInUse) {
-                                        auto fileName = QFileInfo(prop->getValue().toString()).fileName();
-										if (texturesToCopy.contains(fileName) && image.path == fileName) {
-											material->setValue(prop->name, image.guid);
-										}
-									}
-								}
-							}
-						}
+	const QString assetGuid = db->createAssetEntry(job.guid,
+												   job.fileName,
+												   static_cast<int>(job.type),
+												   job.parentGuid,
+												   QString(),
+												   QString(),
+												   thumbnailBlob);
 
-						if (node->hasChildren()) {
-							for (auto &child : node->children) {
-                                replacePathsWithGUIDs(child);
-							}
-						}
-					};
-
-                    replacePathsWithGUIDs(scene);
-
-					QJsonObject nodeWithGUIDs;
-					SceneWriter::writeSceneNode(nodeWithGUIDs, scene, false);
-
-					// Create an actual object from a mesh, materials are embedded into objects by default
-					const QString objectGuid = db->createAssetEntry(preObjectGuid,
-																	QFileInfo(asset->fileName).baseName(),
-																	static_cast<int>(ModelTypes::Object),
-																	entry.parent_guid,
-                                                                    QString(),
-                                                                    QString(),
-																	QByteArray(),
-																	QByteArray(),
-																	QByteArray(),
-																	QJsonDocument(nodeWithGUIDs).toBinaryData());
-
-                    ThumbnailGenerator::getSingleton()->requestThumbnail(
-                        ThumbnailRequestType::Mesh, asset->path, objectGuid
-                    );
+	if (!result.contentHash.isEmpty()) {
+		db->updateAssetHash(assetGuid, result.contentHash);
+		importedHashes.insert(result.contentHash, assetGuid);
+	}
 
-					{
-						QVariant variant = QVariant::fromValue(scene);
-						auto nodeAsset = new AssetNodeObject;
-						nodeAsset->assetGuid = objectGuid;
-						nodeAsset->setValue(variant);
-						AssetManager::addAsset(nodeAsset);
-					}
+	if (job.type == ModelTypes::File) {
+		auto assetFile = new AssetFile;
+		assetFile->assetGuid = assetGuid;
+		assetFile->fileName = job.fileName;
+		assetFile->path = job.destination;
+		AssetManager::addAsset(assetFile);
+	}
+
+	if (job.type == ModelTypes::Music) {
+		auto assetMusic = new AssetMusic;
+		assetMusic->assetGuid = assetGuid;
+		assetMusic->fileName = job.fileName;
+		assetMusic->path = job.destination;
+		AssetManager::addAsset(assetMusic);
+	}
 
-					// Create dependencies to the object for the textures used
-					for (const auto &image : imagesInUse) {
-						if (texturesToCopy.contains(QFileInfo(image.path).fileName())) {
-							db->createDependency(
-                                static_cast<int>(ModelTypes::Object), static_cast<int>(ModelTypes::Texture),
-                                objectGuid, image.guid, Globals::project->getProjectGuid()
-                            );
+	if (job.type == ModelTypes::Texture) {
+		auto assetTexture = new AssetTexture;
+		assetTexture->assetGuid = assetGuid;
+		assetTexture->fileName = job.fileName;
+		assetTexture->path = job.destination;
+		AssetManager::addAsset(assetTexture);
+	}
+
+	if (job.type == ModelTypes::Shader) {
+		QJsonObject shaderDefinition = result.definition;
+
+		shaderDefinition["name"] = QFileInfo(job.fileName).baseName();
+		shaderDefinition["guid"] = assetGuid;
+
+		db->updateAssetAsset(assetGuid, QJsonDocument(shaderDefinition).toBinaryData());
+
+		auto assetShader = new AssetShader;
+		assetShader->assetGuid = assetGuid;
+		assetShader->fileName = QFileInfo(job.fileName).baseName();
+		assetShader->setValue(QVariant::fromValue(shaderDefinition));
+		AssetManager::addAsset(assetShader);
+	}
+
+	if (job.type == ModelTypes::Material) {
+		ThumbnailGenerator::getSingleton()->requestThumbnail(
+			ThumbnailRequestType::Material, job.sourcePath, assetGuid
+		);
+
+		QJsonObject jsonMaterial;
+		QStringList texturesToCopy;
+		extractTexturesAndMaterialFromMaterial(job.sourcePath, texturesToCopy, jsonMaterial);
+
+		QString jsonMaterialString = QJsonDocument(jsonMaterial).toJson();
+
+		// Update the embedded material to point to image asset guids
+		for (const auto &image : imagesInUse) {
+			if (texturesToCopy.contains(QFileInfo(image.path).fileName())) {
+				jsonMaterialString.replace(QFileInfo(image.path).fileName(), image.guid);
+			}
+		}
+
+		QJsonDocument jsonMaterialGuids = QJsonDocument::fromJson(jsonMaterialString.toUtf8());
+		db->updateAssetAsset(assetGuid, jsonMaterialGuids.toBinaryData());
+
+		// Create dependencies to the object for the textures used
+		for (const auto &image : imagesInUse) {
+			if (texturesToCopy.contains(QFileInfo(image.path).fileName())) {
+				db->createDependency(
+					static_cast<int>(ModelTypes::Material), static_cast<int>(ModelTypes::Texture),
+					assetGuid, image.guid, Globals::project->getProjectGuid()
+				);
+			}
+		}
+
+		QJsonDocument matDoc = QJsonDocument::fromBinaryData(db->fetchAssetData(assetGuid));
+		QJsonObject matObject = matDoc.object();
+		iris::CustomMaterialPtr material = iris::CustomMaterialPtr::create();
+		material->generate(IrisUtils::join(
+			IrisUtils::getAbsoluteAssetPath(Constants::SHADER_DEFS),
+			IrisUtils::buildFileName(matObject.value("name").toString(), "shader"))
+		);
+
+		for (const auto &prop : material->properties) {
+			if (prop->type == iris::PropertyType::Color) {
+				QColor col;
+				col.setNamedColor(matObject.value(prop->name).toString());
+				material->setValue(prop->name, col);
+			}
+			else if (prop->type == iris::PropertyType::Texture) {
+				QString materialName = db->fetchAsset(matObject.value(prop->name).toString()).name;
+				QString textureStr = IrisUtils::join(Globals::project->getProjectFolder(), materialName);
+				material->setValue(prop->name, !materialName.isEmpty() ? textureStr : QString());
+			}
+			else {
+				material->setValue(prop->name, QVariant::fromValue(matObject.value(prop->name)));
+			}
+		}
+
+		auto assetMat = new AssetMaterial;
+		assetMat->assetGuid = assetGuid;
+		assetMat->setValue(QVariant::fromValue(material));
+		AssetManager::addAsset(assetMat);
+	}
+
+	if (job.type == ModelTypes::Mesh) {
+		QStringList texturesToCopy;
+		const QString sourceFileName = QFileInfo(job.sourcePath).fileName();
+
+		// The model was parsed on the pool, only the GL resources are created here
+		this->sceneView->makeCurrent();
+		auto scene = AssetHelper::extractTexturesAndMaterialFromMesh(job.sourcePath, result.sceneSource, texturesToCopy);
+		this->sceneView->doneCurrent();
+
+		if (!scene) {
+			irisLog(QString("Couldn't create an object from %1").arg(job.sourcePath));
+			return;
+		}
+
+		QString preObjectGuid = GUIDManager::generateGUID();
+
+		// Replace all path references with GUIDs before storing in the database
+		std::function<void(iris::SceneNodePtr&)> replacePathsWithGUIDs =
+			[&](iris::SceneNodePtr &node) -> void {
+			if (node->getSceneNodeType() == iris::SceneNodeType::Mesh) {
+				auto meshNode = node.staticCast<iris::MeshNode>();
+				if (QFileInfo(meshNode->meshPath).fileName() == sourceFileName) {
+					meshNode->meshPath = assetGuid;
+				}
+
+				meshNode->setGUID(preObjectGuid);
+
+				auto material = meshNode->getMaterial().staticCast<iris::CustomMaterial>();
+				for (auto prop : material->properties) {
+					if (prop->type == iris::PropertyType::Texture) {
+						// Cycle through any textures that were selected in the import and use them
+						for (const auto &image : imagesInUse) {
+							auto fileName = QFileInfo(prop->getValue().toString()).fileName();
+							if (texturesToCopy.contains(fileName) && image.path == fileName) {
+								material->setValue(prop->name, image.guid);
+							}
 						}
 					}
-
-					// Insert a dependency for the mesh to the object
-					db->createDependency(
-                        static_cast<int>(ModelTypes::Object), static_cast<int>(ModelTypes::Mesh),
-                        objectGuid, assetGuid, Globals::project->getProjectGuid()
-                    );
-					// Remove the thumbnail from the object asset
-					db->updateAssetAsset(assetGuid, QByteArray());
 				}
+			}
 
-				// Copy only models, textures and whitelisted files
-				bool copyFile = QFile::copy(entry.path, fileToCopyTo);
+			if (node->hasChildren()) {
+				for (auto &child : node->children) {
+					replacePathsWithGUIDs(child);
+				}
+			}
+		};
+
+		replacePathsWithGUIDs(scene);
+
+		QJsonObject nodeWithGUIDs;
+		SceneWriter::writeSceneNode(nodeWithGUIDs, scene, false);
+
+		// Create an actual object from a mesh, materials are embedded into objects by default
+		const QString objectGuid = db->createAssetEntry(preObjectGuid,
+														QFileInfo(job.fileName).baseName(),
+														static_cast<int>(ModelTypes::Object),
+														job.parentGuid,
+														QString(),
+														QString(),
+														QByteArray(),
+														QByteArray(),
+														QByteArray(),
+														QJsonDocument(nodeWithGUIDs).toBinaryData());
+
+		// Hand the parsed scene over so the thumbnail doesn't import the file a second time
+		ThumbnailGenerator::getSingleton()->requestMeshThumbnail(job.sourcePath, objectGuid, result.sceneSource);
+
+		{
+			QVariant variant = QVariant::fromValue(scene);
+			auto nodeAsset = new AssetNodeObject;
+			nodeAsset->assetGuid = objectGuid;
+			nodeAsset->setValue(variant);
+			AssetManager::addAsset(nodeAsset);
+		}
 
-				progressDialog->setLabelText("Copying " + asset->fileName);
-				progressDialog->setValue(counter++);
+		// Create dependencies to the object for the textures used
+		for (const auto &image : imagesInUse) {
+			if (texturesToCopy.contains(QFileInfo(image.path).fileName())) {
+				db->createDependency(
+					static_cast<int>(ModelTypes::Object), static_cast<int>(ModelTypes::Texture),
+					objectGuid, image.guid, Globals::project->getProjectGuid()
+				);
 			}
 		}
+
+		// Insert a dependency for the mesh to the object
+		db->createDependency(
+			static_cast<int>(ModelTypes::Object), static_cast<int>(ModelTypes::Mesh),
+			objectGuid, assetGuid, Globals::project->getProjectGuid()
+		);
+		// Remove the thumbnail from the object asset
+		db->updateAssetAsset(assetGuid, QByteArray());
 	}
+}
 
+void AssetWidget::onImportFinished()
+{
 	progressDialog->hide();
+	importedImages.clear();
+	importedHashes.clear();
+
+	importJafAssets(pendingJafImports);
+	pendingJafImports.clear();
+
+	populateAssetTree(false);
+	updateAssetView(assetItem.selectedGuid, activeFilter, showDependencies);
+	//syncTreeAndView(assetItem.selectedGuid);
+
+	// Files dropped while the last import was running
+	if (!queuedImports.isEmpty()) {
+		const QStringList files = queuedImports;
+		queuedImports.clear();
+		importAsset(files);
+	}
+}
+
+void AssetWidget::waitForImport()
+{
+	assetImporter->waitForFinished();
 }
 
 void AssetWidget::importAsset(const QStringList &fileNames)
 {
+	if (assetImporter->isImporting()) {
+		queuedImports.append(fileNames);
+		return;
+	}
+
 	// Get the entire directory listing if there are nested folders
 	std::function<void(QStringList, QString guid, QList<directory_tuple>&)> getImportManifest =
 		[&](QStringList files, QString guid, QList<directory_tuple> &items) -> void
@@ -2686,11 +2897,9 @@ void AssetWidget::importAsset(const QStringList &fileNames)
 		}
 	}
 
+	// The asset archives, the tree and the view are handled once the regular assets are in, see onImportFinished
+    pendingJafImports = finalJafAssetImportList;
 	importRegularAssets(finalImportList);
-    importJafAssets(finalJafAssetImportList);
-	populateAssetTree(false);
-	updateAssetView(assetItem.selectedGuid, activeFilter, showDependencies);
-	//syncTreeAndView(assetItem.selectedGuid);
 }
 
 void AssetWidget::onThumbnailResult(ThumbnailResult *result)
@@ -25,7 +25,9 @@ class Database;
 #include <QLineEdit>
 #include <QHBoxLayout>
 #include <QComboBox>
+#include <QSet>
 
+#include "../io/assetimporter.h"
 #include "../io/assetmanager.h"
 #include "../dialogs/progressdialog.h"
 #include "../editor/thumbnailgenerator.h"
@@ -48,6 +50,14 @@ struct AssetItem {
 
 class MainWindow;
 
+// Keeps the encoded thumbnail in MODEL_THUMBNAIL_ROLE and only decodes it when the view asks for the icon
+// The decoded pixmap lives in QPixmapCache, so folders with thousands of assets don't hold them all
+class AssetViewItem : public QListWidgetItem
+{
+public:
+	QVariant data(int role) const override;
+};
+
 class ListViewDelegate : public QStyledItemDelegate
 {
 protected:
@@ -225,6 +235,8 @@ public:
 	void addItem(const FolderRecord &folderData);
 	void addItem(const AssetRecord &assetData);
 	void addCrumbs(const QVector<FolderRecord> &folderData);
+	void loadAssetViewThumbnails();
+	void releaseViewThumbnails();
     void updateAssetView(const QString &path, int filter = 0, bool showDependencies = false);
     void updateAssetContentsView(const QString &guid);
     void trigger();
@@ -242,6 +254,9 @@ public:
 		QJsonObject &material
 	);
 
+	// Blocks until a running import is written to the project, used before the project closes
+	void waitForImport();
+
     void setMainWindow(MainWindow* mainWindow) {
         this->mainWindow = mainWindow;
     }
@@ -297,6 +312,9 @@ protected slots:
     void importRegularAssets(const QList<directory_tuple>&);
     void importJafAssets(const QList<directory_tuple>&);
 
+    void onAssetsImported(const QVector<AssetImportResult> &results, int done, int total);
+    void onImportFinished();
+
     void onThumbnailResult(ThumbnailResult* result);
 
 private:
@@ -306,6 +324,16 @@ private:
     Database *db;
 	ProgressDialog *progressDialog;
 
+	AssetImporter *assetImporter;
+	QList<directory_tuple> importedImages;      // textures of the running import, materials and models refer to them
+	QHash<QString, QString> importedHashes;     // content hash -> asset guid, the project's and this import's
+	QList<directory_tuple> pendingJafImports;   // imported after the regular assets
+	QStringList queuedImports;                  // dropped while an import was running
+	QStringList viewThumbnails;                 // queued thumbnails of the tiles in view, rendered first
+	QSet<QString> renderedThumbnails;           // objects without a thumbnail that were rendered for the view
+
+	void importAssetResult(const AssetImportResult &result);
+
     QString currentPath;
 
 	QHBoxLayout *breadCrumbLayout;
@@ -34,6 +34,7 @@ For more information see the LICENSE file
 
 #include "irisgl/src/assimp/include/assimp/Importer.hpp"
 #include "irisgl/src/core/irisutils.h"
+#include "irisgl/src/core/logger.h"
 #include "irisgl/src/materials/custommaterial.h"
 #include "zip.h"
 
@@ -46,6 +47,7 @@ For more information see the LICENSE file
 
 #include "core/database/database.h"
 #include "core/guidmanager.h"
+#include "core/meshcache.h"
 #include "core/thumbnailmanager.h"
 #include "core/project.h"
 #include "core/settingsmanager.h"
@@ -70,107 +72,14 @@ ProjectManager::ProjectManager(Database *handle, QWidget *parent) : QWidget(pare
 	progressDialog = QPointer<ProgressDialog>(new ProgressDialog());
 
 	QObject::connect(futureWatcher, &QFutureWatcher<QVector<ModelData>>::finished, [&]() {
-		progressDialog->setRange(0, 100);
-		progressDialog->setLabelText(tr("Caching assets..."));
-
-        mainWindow->makeLoadingGLContextCurrent();
-		// Meshes
-		// Note - this would be the perfect place to attach materials as well but we can't access the opengl context
-		for (const auto &item : futureWatcher->result()) {
-			AssetObject *model = new AssetObject(
-				new AssimpObject(item.data, item.path), item.path, QFileInfo(item.path).fileName()
-			);
-			model->assetGuid = item.guid;
-			AssetManager::addAsset(model);
-		}
-
-		progressDialog->setValue(40);
-
-        for (const auto &asset : db->fetchAssetsByType(static_cast<int>(ModelTypes::File))) {
-            auto assetFile = new AssetFile;
-            assetFile->fileName = asset.name;
-            assetFile->assetGuid = asset.guid;
-            assetFile->path = IrisUtils::join(Globals::project->getProjectFolder(), asset.name);
-            AssetManager::addAsset(assetFile);
-        }
-
-        //for (const auto &asset : db->fetchAssetsByType(static_cast<int>(ModelTypes::CubeMap))) {
-        //    QJsonDocument mapDefinition = QJsonDocument::fromBinaryData(db->fetchAssetData(asset.guid));
-        //    QJsonObject mapObject = mapDefinition.object();
-
-        //    auto assetCubeMap = new AssetCubeMap;
-        //    assetCubeMap->fileName = asset.name;
-        //    assetCubeMap->assetGuid = asset.guid;
-        //    // assetFile->path = IrisUtils::join(Globals::project->getProjectFolder(), asset.name);
-        //    assetCubeMap->setValue(mapObject);
-        //    AssetManager::addAsset(assetCubeMap);
-        //}
-
-        for (const auto &asset : db->fetchAssetsByType(static_cast<int>(ModelTypes::Texture))) {
-            auto assetTexture = new AssetTexture;
-            assetTexture->fileName = asset.name;
-            assetTexture->assetGuid = asset.guid;
-            assetTexture->path = IrisUtils::join(Globals::project->getProjectFolder(), asset.name);
-            AssetManager::addAsset(assetTexture);
-        }
-
-		progressDialog->setValue(60);
-
-        for (const auto &asset : db->fetchAssetsByType(static_cast<int>(ModelTypes::Shader))) {
-            QJsonDocument shaderDefinition = QJsonDocument::fromBinaryData(db->fetchAssetData(asset.guid));
-            QJsonObject shaderObject = shaderDefinition.object();
-
-            auto assetShader = new AssetShader;
-            assetShader->assetGuid = asset.guid;
-            assetShader->fileName = QFileInfo(asset.name).baseName();
-            assetShader->setValue(QVariant::fromValue(shaderObject));
-            AssetManager::addAsset(assetShader);
-        }
-
-		progressDialog->setValue(70);
-
-        for (const auto &asset : db->fetchAssetsByType(static_cast<int>(ModelTypes::ParticleSystem))) {
-            QJsonDocument particleDefinition = QJsonDocument::fromBinaryData(db->fetchAssetData(asset.guid));
-            QJsonObject particleObject = particleDefinition.object();
-
-            auto assetPS = new AssetParticleSystem;
-            assetPS->assetGuid = asset.guid;
-            assetPS->fileName = QFileInfo(asset.name).baseName();
-            assetPS->setValue(QVariant::fromValue(particleObject));
-            AssetManager::addAsset(assetPS);
-        }
-
-		progressDialog->setValue(80);
-
-		// Materials
-		for (const auto &asset :
-			db->fetchFilteredAssets(Globals::project->getProjectGuid(), static_cast<int>(ModelTypes::Material)))
-		{
-			QJsonDocument matDoc = QJsonDocument::fromBinaryData(db->fetchAssetData(asset.guid));
-			QJsonObject matObject = matDoc.object();
-
-			MaterialReader reader;
-			iris::CustomMaterialPtr material = reader.parseMaterial(matObject, db);
-			//qDebug() << matObject;
-			//iris::CustomMaterialPtr material = iris::CustomMaterialPtr::create();
-
-			auto assetMat = new AssetMaterial;
-			assetMat->assetGuid = asset.guid;
-			assetMat->setValue(QVariant::fromValue(material));
-			AssetManager::addAsset(assetMat);
-		}
-
-		progressDialog->setLabelText(tr("Opening scene..."));
-		progressDialog->setValue(100);
-		emit fileToOpen(openInPlayMode);
-		progressDialog->close();
+		registerProjectAssets();
 	});
 
-
-	//QObject::connect(futureWatcher, &QFutureWatcher<QVector<ModelData>>::progressRangeChanged,
-	//	progressDialog.data(), &ProgressDialog::setRange);
-	//QObject::connect(futureWatcher, &QFutureWatcher<QVector<ModelData>>::progressValueChanged,
-	//	progressDialog.data(), &ProgressDialog::setValue);
+	// Model loading is the only stage with a known item count, the dialog follows it directly
+	QObject::connect(futureWatcher, &QFutureWatcher<QVector<ModelData>>::progressRangeChanged,
+		progressDialog.data(), &ProgressDialog::setRange);
+	QObject::connect(futureWatcher, &QFutureWatcher<QVector<ModelData>>::progressValueChanged,
+		progressDialog.data(), &ProgressDialog::setValue);
 
     dynamicGrid = new DynamicGrid(this);
 
@@ -337,6 +246,13 @@ void ProjectManager::importProjectFromFile(const QString& file, bool shouldOpen)
         assetGuids
     );
 
+    // Nothing was written to the database when the import fails, remove the extracted files as well
+    if (!canOpen) {
+        QDir(pDir).removeRecursively();
+        temporaryDir.remove();
+        return;
+    }
+
     // Update files that reference guids
 
     if (shouldOpen) {
@@ -471,7 +387,7 @@ bool ProjectManager::checkForEmptyState()
 
 void ProjectManager::cleanupOnClose()
 {
-    AssetManager::getAssets().clear();
+    AssetManager::clearAssetList();
 }
 
 void ProjectManager::openSampleProject(QListWidgetItem *item)
@@ -524,10 +440,134 @@ ModelData ProjectManager::loadAiSceneFromModel(const QPair<QString, QString> ass
 	//const aiScene *scene = sceneSource->importer.ReadFileFromMemory((void*)data.data(),
 	//																data.length(),
 	//																aiProcessPreset_TargetRealtime_Fast);
-	ModelData d = { asset.first, asset.second, importer->ReadFile(asset.first.toStdString().c_str(), aiProcessPreset_TargetRealtime_Fast) };
+	// Reads the processed scene from the mesh cache when possible, Assimp only runs on new or changed files
+	ModelData d = { asset.first, asset.second, MeshCache::loadScene(importer, asset.first) };
 	return d;
 }
 
+ProjectAssetData ProjectManager::fetchProjectAssetData(Database *db, const QString &projectGuid)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	const QVector<int> payloadTypes = {
+		static_cast<int>(ModelTypes::Shader),
+		static_cast<int>(ModelTypes::ParticleSystem),
+		static_cast<int>(ModelTypes::Material)
+	};
+
+	const QVector<int> types = QVector<int>({
+		static_cast<int>(ModelTypes::File),
+		static_cast<int>(ModelTypes::Texture)
+	}) + payloadTypes;
+
+	ProjectAssetData data;
+	for (const auto &record : db->fetchProjectAssetsConcurrent(projectGuid, types, payloadTypes)) {
+		ProjectAssetEntry entry;
+		entry.record = record;
+		if (!record.asset.isEmpty()) {
+			entry.definition = QJsonDocument::fromBinaryData(record.asset).object();
+			entry.record.asset.clear();
+		}
+
+		data.assetsByType[record.type].append(entry);
+	}
+
+	data.elapsed = timer.elapsed();
+	return data;
+}
+
+void ProjectManager::registerProjectAssets()
+{
+	QElapsedTimer stageTimer;
+	stageTimer.start();
+
+	openTimings.append(QString("models %1 ms").arg(openTimer.elapsed()));
+
+	progressDialog->setRange(0, 100);
+	progressDialog->setValueAndText(0, tr("Registering models..."));
+
+	mainWindow->makeLoadingGLContextCurrent();
+
+	// Meshes
+	for (const auto &item : futureWatcher->result()) {
+		AssetObject *model = new AssetObject(
+			new AssimpObject(item.data, item.path), item.path, QFileInfo(item.path).fileName()
+		);
+		model->assetGuid = item.guid;
+		AssetManager::addAsset(model);
+	}
+
+	openTimings.append(QString("model registration %1 ms").arg(stageTimer.restart()));
+
+	// Normally finished while the models were loading, only waits on projects without many meshes
+	progressDialog->setValueAndText(20, tr("Reading asset records..."));
+	const ProjectAssetData assetData = assetDataFuture.result();
+	openTimings.append(QString("asset records %1 ms (waited %2 ms)").arg(assetData.elapsed).arg(stageTimer.restart()));
+
+	progressDialog->setValueAndText(40, tr("Caching assets..."));
+
+	const QString projectFolder = Globals::project->getProjectFolder();
+
+	for (const auto &entry : assetData.assetsByType.value(static_cast<int>(ModelTypes::File))) {
+		auto assetFile = new AssetFile;
+		assetFile->fileName = entry.record.name;
+		assetFile->assetGuid = entry.record.guid;
+		assetFile->path = IrisUtils::join(projectFolder, entry.record.name);
+		AssetManager::addAsset(assetFile);
+	}
+
+	for (const auto &entry : assetData.assetsByType.value(static_cast<int>(ModelTypes::Texture))) {
+		auto assetTexture = new AssetTexture;
+		assetTexture->fileName = entry.record.name;
+		assetTexture->assetGuid = entry.record.guid;
+		assetTexture->path = IrisUtils::join(projectFolder, entry.record.name);
+		AssetManager::addAsset(assetTexture);
+	}
+
+	for (const auto &entry : assetData.assetsByType.value(static_cast<int>(ModelTypes::Shader))) {
+		auto assetShader = new AssetShader;
+		assetShader->assetGuid = entry.record.guid;
+		assetShader->fileName = QFileInfo(entry.record.name).baseName();
+		assetShader->setValue(QVariant::fromValue(entry.definition));
+		AssetManager::addAsset(assetShader);
+	}
+
+	for (const auto &entry : assetData.assetsByType.value(static_cast<int>(ModelTypes::ParticleSystem))) {
+		auto assetPS = new AssetParticleSystem;
+		assetPS->assetGuid = entry.record.guid;
+		assetPS->fileName = QFileInfo(entry.record.name).baseName();
+		assetPS->setValue(QVariant::fromValue(entry.definition));
+		AssetManager::addAsset(assetPS);
+	}
+
+	openTimings.append(QString("asset registration %1 ms").arg(stageTimer.restart()));
+
+	// Materials compile their shaders so they're batched here on the loading context
+	// Shaders have to be registered first since materials resolve them through the AssetManager
+	const auto &materials = assetData.assetsByType.value(static_cast<int>(ModelTypes::Material));
+	progressDialog->setValueAndText(60, tr("Building materials..."));
+
+	MaterialReader reader;
+	for (int i = 0; i < materials.size(); ++i) {
+		iris::CustomMaterialPtr material = reader.parseMaterial(materials[i].definition, db);
+
+		auto assetMat = new AssetMaterial;
+		assetMat->assetGuid = materials[i].record.guid;
+		assetMat->setValue(QVariant::fromValue(material));
+		AssetManager::addAsset(assetMat);
+
+		progressDialog->setValue(60 + (i + 1) * 40 / materials.size());
+	}
+
+	openTimings.append(QString("materials %1 ms").arg(stageTimer.restart()));
+	irisLog(QString("Project assets loaded in %1 ms: %2").arg(openTimer.elapsed()).arg(openTimings.join(", ")));
+
+	progressDialog->setValueAndText(100, tr("Opening scene..."));
+	emit fileToOpen(openInPlayMode);
+	progressDialog->close();
+}
+
 void ProjectManager::finalizeProjectAssetLoad()
 {
 	
@@ -641,6 +681,13 @@ void ProjectManager::loadProjectAssets()
 
 	progressDialog->setLabelText(tr("Collecting assets..."));
 
+	openTimer.start();
+	openTimings.clear();
+
+	// Everything that only needs the database runs on a worker alongside the model loads
+	// Only steps that need the GL context are left for the GUI thread once both are done
+	assetDataFuture = QtConcurrent::run(&ProjectManager::fetchProjectAssetData, db, Globals::project->getProjectGuid());
+
 	// TODO - if we are only loading a couple assets, just do it sequentially
 	for (const auto &asset : db->fetchFilteredAssets(Globals::project->getProjectGuid(), static_cast<int>(ModelTypes::Mesh))) {
 		assetsToLoad.append(
@@ -649,7 +696,7 @@ void ProjectManager::loadProjectAssets()
 		);
 	}
 
-    progressDialog->setLabelText(tr("Loading assets..."));
+    progressDialog->setLabelText(tr("Loading models..."));
 
     AssetWidgetConcurrentWrapper aiSceneFromModelMapper(this);
     auto aiSceneFromModelReducer = [](QVector<ModelData> &accum, const ModelData &interm) {
@@ -13,7 +13,10 @@ For more information see the LICENSE file
 #define PROJECTMANAGER_H
 
 #include <QDialog>
+#include <QElapsedTimer>
 #include <QFutureWatcher>
+#include <QHash>
+#include <QJsonObject>
 #include <QListWidgetItem>
 #include <QPointer>
 #include <QWidget>
@@ -22,6 +25,8 @@ For more information see the LICENSE file
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 
+#include "core/project.h"
+
 class aiScene;
 
 class Database;
@@ -42,6 +47,17 @@ struct ModelData {
     const aiScene  *data;
 };
 
+// Database side of a project's assets, read and decoded on a worker thread while models load
+struct ProjectAssetEntry {
+	AssetRecord		record;
+	QJsonObject		definition;		// decoded payload, only set for json backed assets
+};
+
+struct ProjectAssetData {
+	QHash<int, QVector<ProjectAssetEntry>> assetsByType;
+	qint64 elapsed = 0;
+};
+
 class SettingsManager;
 class MainWindow;
 
@@ -97,6 +113,8 @@ signals:
 
 private:
     void loadProjectAssets();
+    void registerProjectAssets();
+    static ProjectAssetData fetchProjectAssetData(Database *db, const QString &projectGuid);
 
     Ui::ProjectManager *ui;
     SettingsManager* settings;
@@ -109,6 +127,11 @@ private:
     QPointer<QFutureWatcher<QVector<ModelData>>> futureWatcher;
 	QPointer<ProgressDialog> progressDialog;
 
+	// Project open runs in stages, these are timed so slow opens can be broken down
+	QFuture<ProjectAssetData> assetDataFuture;
+	QElapsedTimer openTimer;
+	QStringList openTimings;
+
     bool isNewProject;
     bool isMainWindowActive;
 
@@ -28,6 +28,7 @@ For more information see the LICENSE file
 
 #include "globals.h" 
 #include "io/scenewriter.h" 
+#include "core/texturecache.h" 
 
 EmitterPropertyWidget::EmitterPropertyWidget()
 {
@@ -86,7 +87,7 @@ EmitterPropertyWidget::~EmitterPropertyWidget()
 void EmitterPropertyWidget::onBillboardImageChanged(QString image)
 {
     if (!image.isEmpty() || !image.isNull()) {
-        ps->texture = iris::Texture2D::load(image);
+        ps->texture = TextureCache::load(image);
 
         QJsonObject particleDef;
         SceneWriter::writeParticleData(particleDef, ps);
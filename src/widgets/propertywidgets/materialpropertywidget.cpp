@@ -187,10 +187,8 @@ void MaterialPropertyWidget::setupShaderSelector()
         materialSelector->addItem(QFileInfo(it.value()).baseName(), it.key());
     }
 
-    for (auto asset : AssetManager::getAssets()) {
-        if (asset->type == ModelTypes::Shader) {
-            materialSelector->addItem(QFileInfo(asset->fileName).baseName(), asset->assetGuid);
-        }
+    for (auto asset : AssetManager::getAssetsByType(ModelTypes::Shader)) {
+        materialSelector->addItem(QFileInfo(asset->fileName).baseName(), asset->assetGuid);
     }
 
     materialSelector->setCurrentItemData(material->getGuid());
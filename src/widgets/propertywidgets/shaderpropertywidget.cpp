@@ -56,62 +56,17 @@ void ShaderPropertyWidget::onShaderFileChanged(int index)
     auto vertexShader = vertexShaderCombo->getCurrentItemData();
     auto fragmentShader = fragmentShaderCombo->getCurrentItemData();
 
-    for (auto asset : AssetManager::getAssets()) {
-        if (asset->type == ModelTypes::Shader && asset->assetGuid == shaderGuid) {
-            auto shaderObject = asset->getValue().toJsonObject();
-            shaderObject["vertex_shader"] = vertexShader;
-            shaderObject["fragment_shader"] = fragmentShader;
-
-            asset->setValue(QVariant::fromValue(shaderObject));
-
-            if (!vertexShader.isEmpty() || !fragmentShader.isEmpty()) {
-                db->removeDependenciesByType(asset->assetGuid, ModelTypes::File);
-
-                if (!vertexShader.startsWith(":")) {
-                    db->createDependency(
-                        static_cast<int>(ModelTypes::Shader),
-                        static_cast<int>(ModelTypes::File),
-                        asset->assetGuid,
-                        vertexShader,
-                        Globals::project->getProjectGuid()
-                    );
-
-                    db->updateAssetAsset(asset->assetGuid, QJsonDocument(shaderObject).toBinaryData());
-                }
-
-                if (!fragmentShader.startsWith(":")) {
-                    db->createDependency(
-                        static_cast<int>(ModelTypes::Shader),
-                        static_cast<int>(ModelTypes::File),
-                        asset->assetGuid,
-                        fragmentShader,
-                        Globals::project->getProjectGuid()
-                    );
-
-                    db->updateAssetAsset(asset->assetGuid, QJsonDocument(shaderObject).toBinaryData());
-                }
-            }
-        }
-    }
-}
+    if (auto asset = AssetManager::getAssetByGuid(shaderGuid, ModelTypes::Shader)) {
+        auto shaderObject = asset->getValue().toJsonObject();
+        shaderObject["vertex_shader"] = vertexShader;
+        shaderObject["fragment_shader"] = fragmentShader;
 
-void ShaderPropertyWidget::onVertexShaderFileChanged(int index)
-{
-    auto vertexShader = vertexShaderCombo->getCurrentItemData();
-    auto fragmentShader = fragmentShaderCombo->getCurrentItemData();
-    
-    for (auto asset : AssetManager::getAssets()) {
-        if (asset->type == ModelTypes::Shader && asset->assetGuid == shaderGuid) {
-            auto shaderObject = asset->getValue().toJsonObject();
-            shaderObject["vertex_shader"] = vertexShader;
-            shaderObject["fragment_shader"] = fragmentShader;
-            asset->setValue(QVariant::fromValue(shaderObject));
-
-            QFile jsonFile(asset->path);
-            jsonFile.open(QIODevice::Truncate | QFile::WriteOnly);
-            jsonFile.write(QJsonDocument(shaderObject).toJson());
-
-            if (db->checkIfRecordExists("depender", asset->assetGuid, "dependencies")) {
+        asset->setValue(QVariant::fromValue(shaderObject));
+
+        if (!vertexShader.isEmpty() || !fragmentShader.isEmpty()) {
+            db->removeDependenciesByType(asset->assetGuid, ModelTypes::File);
+
+            if (!vertexShader.startsWith(":")) {
                 db->createDependency(
                     static_cast<int>(ModelTypes::Shader),
                     static_cast<int>(ModelTypes::File),
@@ -119,50 +74,89 @@ void ShaderPropertyWidget::onVertexShaderFileChanged(int index)
                     vertexShader,
                     Globals::project->getProjectGuid()
                 );
+
+                db->updateAssetAsset(asset->assetGuid, QJsonDocument(shaderObject).toBinaryData());
             }
-            else {
-                db->updateGlobalDependencyDependee(
+
+            if (!fragmentShader.startsWith(":")) {
+                db->createDependency(
+                    static_cast<int>(ModelTypes::Shader),
                     static_cast<int>(ModelTypes::File),
                     asset->assetGuid,
-                    vertexShader
+                    fragmentShader,
+                    Globals::project->getProjectGuid()
                 );
+
+                db->updateAssetAsset(asset->assetGuid, QJsonDocument(shaderObject).toBinaryData());
             }
         }
     }
 }
 
-void ShaderPropertyWidget::onFragmentShaderFileChanged(int index)
+void ShaderPropertyWidget::onVertexShaderFileChanged(int index)
 {
     auto vertexShader = vertexShaderCombo->getCurrentItemData();
     auto fragmentShader = fragmentShaderCombo->getCurrentItemData();
+    
+    if (auto asset = AssetManager::getAssetByGuid(shaderGuid, ModelTypes::Shader)) {
+        auto shaderObject = asset->getValue().toJsonObject();
+        shaderObject["vertex_shader"] = vertexShader;
+        shaderObject["fragment_shader"] = fragmentShader;
+        asset->setValue(QVariant::fromValue(shaderObject));
+
+        QFile jsonFile(asset->path);
+        jsonFile.open(QIODevice::Truncate | QFile::WriteOnly);
+        jsonFile.write(QJsonDocument(shaderObject).toJson());
+
+        if (db->checkIfRecordExists("depender", asset->assetGuid, "dependencies")) {
+            db->createDependency(
+                static_cast<int>(ModelTypes::Shader),
+                static_cast<int>(ModelTypes::File),
+                asset->assetGuid,
+                vertexShader,
+                Globals::project->getProjectGuid()
+            );
+        }
+        else {
+            db->updateGlobalDependencyDependee(
+                static_cast<int>(ModelTypes::File),
+                asset->assetGuid,
+                vertexShader
+            );
+        }
+    }
+}
 
-    for (auto asset : AssetManager::getAssets()) {
-        if (asset->type == ModelTypes::Shader && asset->assetGuid == shaderGuid) {
-            auto shaderObject = asset->getValue().toJsonObject();
-            shaderObject["vertex_shader"] = vertexShader;
-            shaderObject["fragment_shader"] = fragmentShader;
-            asset->setValue(QVariant::fromValue(shaderObject));
-
-            QFile jsonFile(asset->path);
-            jsonFile.open(QIODevice::Truncate | QFile::WriteOnly);
-            jsonFile.write(QJsonDocument(shaderObject).toJson());
+void ShaderPropertyWidget::onFragmentShaderFileChanged(int index)
+{
+    auto vertexShader = vertexShaderCombo->getCurrentItemData();
+    auto fragmentShader = fragmentShaderCombo->getCurrentItemData();
 
-            if (db->checkIfRecordExists("depender", asset->assetGuid, "dependencies")) {
-                db->createDependency(
-                    static_cast<int>(ModelTypes::Shader),
-                    static_cast<int>(ModelTypes::File),
-                    asset->assetGuid,
-                    fragmentShader,
-                    Globals::project->getProjectGuid()
-                );
-            }
-            else {
-                db->updateGlobalDependencyDependee(
-                    static_cast<int>(ModelTypes::File),
-                    asset->assetGuid,
-                    fragmentShader
-                );
-            }
+    if (auto asset = AssetManager::getAssetByGuid(shaderGuid, ModelTypes::Shader)) {
+        auto shaderObject = asset->getValue().toJsonObject();
+        shaderObject["vertex_shader"] = vertexShader;
+        shaderObject["fragment_shader"] = fragmentShader;
+        asset->setValue(QVariant::fromValue(shaderObject));
+
+        QFile jsonFile(asset->path);
+        jsonFile.open(QIODevice::Truncate | QFile::WriteOnly);
+        jsonFile.write(QJsonDocument(shaderObject).toJson());
+
+        if (db->checkIfRecordExists("depender", asset->assetGuid, "dependencies")) {
+            db->createDependency(
+                static_cast<int>(ModelTypes::Shader),
+                static_cast<int>(ModelTypes::File),
+                asset->assetGuid,
+                fragmentShader,
+                Globals::project->getProjectGuid()
+            );
+        }
+        else {
+            db->updateGlobalDependencyDependee(
+                static_cast<int>(ModelTypes::File),
+                asset->assetGuid,
+                fragmentShader
+            );
         }
     }
 }
@@ -183,46 +177,42 @@ void ShaderPropertyWidget::setShaderGuid(const QString &guid)
         if (shaderInfo.suffix() == "frag") fragmentShaderCombo->addItem(shaderInfo.baseName(), shader);
     }
 
-    for (auto asset : AssetManager::getAssets()) {
-        if (asset->type == ModelTypes::File) {
-            auto shaderInfo = QFileInfo(asset->fileName);
-            if (shaderInfo.suffix() == "vert") vertexShaderCombo->addItem(shaderInfo.baseName(), asset->assetGuid);
-            if (shaderInfo.suffix() == "frag") fragmentShaderCombo->addItem(shaderInfo.baseName(), asset->assetGuid);
-        }
+    for (auto asset : AssetManager::getAssetsByType(ModelTypes::File)) {
+        auto shaderInfo = QFileInfo(asset->fileName);
+        if (shaderInfo.suffix() == "vert") vertexShaderCombo->addItem(shaderInfo.baseName(), asset->assetGuid);
+        if (shaderInfo.suffix() == "frag") fragmentShaderCombo->addItem(shaderInfo.baseName(), asset->assetGuid);
     }
 
     vertexShaderCombo->getWidget()->blockSignals(false);
     fragmentShaderCombo->getWidget()->blockSignals(false);
 
-    for (auto asset : AssetManager::getAssets()) {
-        if (asset->assetGuid == guid && asset->type == ModelTypes::Shader) {
-            auto shaderObject = asset->getValue().toJsonObject();
-            auto vShader = shaderObject["vertex_shader"].toString();
-            auto fShader = shaderObject["fragment_shader"].toString();
-
-            //bool usesBuiltinAsset = false;
-            //for (const auto &asset : builtinShaders) {
-            //    if (vShader == asset || fShader == asset) {
-            //        usesBuiltinAsset = true;
-            //        break;
-            //    }
-            //}
-
-            //if (usesBuiltinAsset) {
-            //    allowBuiltinShaders->setValue(true);
-            //    for (const auto &shader : builtinShaders) {
-            //        auto shaderInfo = QFileInfo(shader);
-            //        if (shaderInfo.suffix() == "vert") vertexShaderCombo->addItem(shaderInfo.baseName(), shader);
-            //        if (shaderInfo.suffix() == "frag") fragmentShaderCombo->addItem(shaderInfo.baseName(), shader);
-            //    }
-            //}
-
-            int vindex = vertexShaderCombo->findData(vShader);
-            if (vindex) vertexShaderCombo->setCurrentIndex(vindex);
-
-            int findex = fragmentShaderCombo->findData(fShader);
-            if (findex) fragmentShaderCombo->setCurrentIndex(findex);
-        }
+    if (auto asset = AssetManager::getAssetByGuid(guid, ModelTypes::Shader)) {
+        auto shaderObject = asset->getValue().toJsonObject();
+        auto vShader = shaderObject["vertex_shader"].toString();
+        auto fShader = shaderObject["fragment_shader"].toString();
+
+        //bool usesBuiltinAsset = false;
+        //for (const auto &asset : builtinShaders) {
+        //    if (vShader == asset || fShader == asset) {
+        //        usesBuiltinAsset = true;
+        //        break;
+        //    }
+        //}
+
+        //if (usesBuiltinAsset) {
+        //    allowBuiltinShaders->setValue(true);
+        //    for (const auto &shader : builtinShaders) {
+        //        auto shaderInfo = QFileInfo(shader);
+        //        if (shaderInfo.suffix() == "vert") vertexShaderCombo->addItem(shaderInfo.baseName(), shader);
+        //        if (shaderInfo.suffix() == "frag") fragmentShaderCombo->addItem(shaderInfo.baseName(), shader);
+        //    }
+        //}
+
+        int vindex = vertexShaderCombo->findData(vShader);
+        if (vindex) vertexShaderCombo->setCurrentIndex(vindex);
+
+        int findex = fragmentShaderCombo->findData(fShader);
+        if (findex) fragmentShaderCombo->setCurrentIndex(findex);
     }
 }
 
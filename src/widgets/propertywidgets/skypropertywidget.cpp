@@ -27,6 +27,7 @@ For more information see the LICENSE file
 #include "io/scenewriter.h"
 #include "io/scenereader.h"
 #include "io/assetmanager.h"
+#include "core/texturecache.h"
 
 SkyPropertyWidget::SkyPropertyWidget()
 {
@@ -343,7 +344,7 @@ void SkyPropertyWidget::setEquiMap(const QString &guid)
 		equiSkyDefinition.insert("equiSkyGuid", guid);
         auto image = IrisUtils::join(Globals::project->getProjectFolder(), db->fetchAsset(guid).name);
         equiTexture->setTexture(QFileInfo(image).isFile() ? image : QString());
-        scene->setSkyTexture(iris::Texture2D::load(image, false));
+        scene->setSkyTexture(TextureCache::loadAsset(guid, image, false));
     }
 	scene->queueSkyCapture();
 }
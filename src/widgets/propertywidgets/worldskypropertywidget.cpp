@@ -30,6 +30,7 @@ For more information see the LICENSE file
 #include "io/assetmanager.h"
 
 #include "widgets/sceneviewwidget.h"
+#include "core/texturecache.h"
 
 WorldSkyPropertyWidget::WorldSkyPropertyWidget()
 {
@@ -339,7 +340,7 @@ void WorldSkyPropertyWidget::setEquiMap(const QString &guid)
 		equiSkyDefinition.insert("equiSkyGuid", guid);
         auto image = IrisUtils::join(Globals::project->getProjectFolder(), db->fetchAsset(guid).name);
         equiTexture->setTexture(QFileInfo(image).isFile() ? image : QString());
-        scene->setSkyTexture(iris::Texture2D::load(image, false));
+        scene->setSkyTexture(TextureCache::loadAsset(guid, image, false));
 		updateAssetAndKeys();
 
 		scene->queueSkyCapture();
@@ -364,20 +365,9 @@ void WorldSkyPropertyWidget::setSkyMap(const QJsonObject &skyDataDefinition)
 
 	cubeMapWidget->addCubeMapImages(top, bottom, left, front, right, back);
 
-	// We need at least one valid image to get some metadata from
-	QImage *info;
-	bool useTex = false;
-	QVector<QString> sides = { front, back, left, right, top, bottom };
-	for (const auto image : sides) {
-		if (!image.isEmpty() && QFileInfo(image).isFile()) {
-			info = new QImage(image);
-			useTex = true;
-			break;
-		}
-	}
-
-	if (useTex) {
-		scene->setSkyTexture(iris::Texture2D::createCubeMap(front, back, top, bottom, left, right, info));
+	auto cubeMap = TextureCache::loadCubeMap(front, back, top, bottom, left, right);
+	if (!!cubeMap) {
+		scene->setSkyTexture(cubeMap);
 		updateAssetAndKeys();
 	}
 
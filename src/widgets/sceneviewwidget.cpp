@@ -12,6 +12,8 @@ For more information see the LICENSE file
 #include "assetwidget.h"
 #include "sceneviewwidget.h"
 
+#include <algorithm>
+
 #include <QDebug>
 #include <QElapsedTimer>
 #include <QMouseEvent>
@@ -64,6 +66,7 @@ For more information see the LICENSE file
 #include "globals.h"
 
 #include "core/keyboardstate.h"
+#include "core/scenepicker.h"
 #include "core/settingsmanager.h"
 #include "editor/animationpath.h"
 #include "editor/cameracontrollerbase.h"
@@ -83,6 +86,8 @@ For more information see the LICENSE file
 #include "editor/handgizmo.h"
 
 #include "player/playback.h"
+#include "io/scenestreamer.h"
+#include "core/texturecache.h"
 
 void SceneViewWidget::setShowFps(bool value)
 {
@@ -156,14 +161,9 @@ void SceneViewWidget::dragMoveEvent(QDragMoveEvent *event)
 			savedActiveNode = node;
 			originalMaterial = node.staticCast<iris::MeshNode>()->getMaterial().staticCast<iris::CustomMaterial>();
 
-			// TODO - get this at drag start
 			iris::CustomMaterialPtr material;
-			QVector<Asset*>::const_iterator iterator = AssetManager::getAssets().constBegin();
-			while (iterator != AssetManager::getAssets().constEnd()) {
-				if ((*iterator)->assetGuid == roleDataMap.value(3).toString()) {
-					material = (*iterator)->getValue().value<iris::CustomMaterialPtr>();
-				}
-				++iterator;
+			if (auto asset = AssetManager::getAssetByGuid(roleDataMap.value(3).toString(), ModelTypes::Material)) {
+				material = asset->getValue().value<iris::CustomMaterialPtr>();
 			}
 
 			if (!!material) node.staticCast<iris::MeshNode>()->setMaterial(material);
@@ -181,7 +181,7 @@ void SceneViewWidget::dragMoveEvent(QDragMoveEvent *event)
 		}
 	} else if (roleDataMap.value(0).toInt() == static_cast<int>(ModelTypes::Object)) {
         // If we drag unto another object
-        if (doActiveObjectPicking(event->posF())) {
+        if (doActiveObjectPicking(event->posF(), false, PickingMode::Any)) {
             //activeSceneNode->pos = sceneView->hit;
             dragScenePos = hit;
         }
@@ -236,15 +236,11 @@ void SceneViewWidget::dropEvent(QDropEvent *event)
 		if (!!savedActiveNode) {
 			iris::CustomMaterialPtr material;
 
-			QVector<Asset*>::const_iterator iterator = AssetManager::getAssets().constBegin();
-			while (iterator != AssetManager::getAssets().constEnd()) {
-				if ((*iterator)->assetGuid == roleDataMap.value(3).toString()) {
-					auto val = (*iterator)->getValue();
-					auto mat = val.value<iris::CustomMaterialPtr>();
-					auto matDup = mat->duplicate();
-					material = matDup.staticCast<iris::CustomMaterial>();
-				}
-				++iterator;
+			if (auto asset = AssetManager::getAssetByGuid(roleDataMap.value(3).toString(), ModelTypes::Material)) {
+				auto val = asset->getValue();
+				auto mat = val.value<iris::CustomMaterialPtr>();
+				auto matDup = mat->duplicate();
+				material = matDup.staticCast<iris::CustomMaterial>();
 			}
 
             //if (!!material) savedActiveNode.staticCast<iris::MeshNode>()->setMaterial(material); ???
@@ -453,6 +449,55 @@ void SceneViewWidget::initLightAssets()
     spotLightMesh = iris::ShapeHelper::createWireCone(1.0f);
     dirLightMesh = createDirLightMesh();
 	lineMat = iris::LineColorMaterial::create();
+    placeholderMesh = createPlaceholderMesh();
+}
+
+iris::MeshPtr SceneViewWidget::createPlaceholderMesh()
+{
+    // Unit cube centred on the origin, scaled to the bounds of each mesh that's still loading
+    iris::LineMeshBuilder builder;
+
+    const float h = 0.5f;
+    const QVector3D corners[] = {
+        QVector3D(-h, -h, -h), QVector3D(h, -h, -h), QVector3D(h, -h, h), QVector3D(-h, -h, h),
+        QVector3D(-h,  h, -h), QVector3D(h,  h, -h), QVector3D(h,  h, h), QVector3D(-h,  h, h)
+    };
+
+    for (int i = 0; i < 4; i++) {
+        builder.addLine(corners[i], corners[(i + 1) % 4]);
+        builder.addLine(corners[i + 4], corners[(i + 1) % 4 + 4]);
+        builder.addLine(corners[i], corners[i + 4]);
+    }
+
+    return builder.build();
+}
+
+void SceneViewWidget::addStreamingPlaceholdersToScene()
+{
+    for (const auto &transform : sceneStreamer->getPlaceholders()) {
+        scene->geometryRenderList->submitMesh(placeholderMesh, lineMat, transform);
+    }
+}
+
+void SceneViewWidget::setSceneStreamer(const QSharedPointer<SceneStreamer> &streamer)
+{
+    sceneStreamer = streamer;
+}
+
+QSharedPointer<SceneStreamer> SceneViewWidget::getSceneStreamer() const
+{
+    return sceneStreamer;
+}
+
+void SceneViewWidget::finishStreaming()
+{
+    if (!sceneStreamer) return;
+
+    makeCurrent();
+    sceneStreamer->finish();
+    doneCurrent();
+
+    sceneStreamer.clear();
 }
 
 iris::MeshPtr SceneViewWidget::createDirLightMesh(float baseRadius)
@@ -557,6 +602,9 @@ void SceneViewWidget::setScene(iris::ScenePtr scene)
 
     // remove selected scenenode
     selectedNode.reset();
+
+    // whatever was pending belongs to the previous scene
+    sceneStreamer.clear();
 }
 
 iris::ScenePtr SceneViewWidget::getScene()                                         
@@ -672,7 +720,7 @@ void SceneViewWidget::initializeGL()
     viewerQuad = new iris::FullScreenQuad();
 
 	auto mat = ViewerMaterial::create();
-	mat->setTexture(iris::Texture2D::load(":/assets/models/head.png"));
+	mat->setTexture(TextureCache::load(":/assets/models/head.png"));
 	viewerMat = mat.staticCast<iris::Material>();
 	viewerMesh = iris::Mesh::loadMesh(":/assets/models/head2.obj");
 
@@ -762,9 +810,13 @@ void SceneViewWidget::renderScene()
 	if (!!renderer && !!scene) {
 		this->camController->update(dt);
 
+		if (!!sceneStreamer && sceneStreamer->update(editorCam->getLocalPos())) {
+			sceneStreamer.clear();
+		}
+
 		if (playScene) {
 			animTime += dt;
-			scene->updateSceneAnimation(animTime);
+			playback->updateAnimation(animTime);
 		}
 
 		// hide viewer so it doesnt show up in rt
@@ -793,6 +845,7 @@ void SceneViewWidget::renderScene()
         // TODO: ensure it doesnt display these shapes in play mode (Nick)
 		if (UiManager::sceneMode != SceneMode::PlayMode) {
 			if (showLightWires) addLightShapesToScene();
+			if (!!sceneStreamer) addStreamingPlaceholdersToScene();
 			toggleDebugDrawFlags(showDebugDrawFlags);
 		}
 
@@ -1002,7 +1055,8 @@ bool SceneViewWidget::updateRPI(QVector3D pos, QVector3D r) {
 }
 
 iris::SceneNodePtr SceneViewWidget::doActiveObjectPicking(const QPointF &point,
-														  bool forcePickable)
+														  bool forcePickable,
+														  PickingMode mode)
 {
     editorCam->updateCameraMatrices();
 
@@ -1010,17 +1064,13 @@ iris::SceneNodePtr SceneViewWidget::doActiveObjectPicking(const QPointF &point,
     auto rayDir = this->calculateMouseRay(point) * 1024;
     auto segEnd = segStart + rayDir;
 
-    QList<PickingResult> hitList;
-    doScenePicking(scene->getRootNode(), segStart, segEnd, hitList, forcePickable);
-
-    if (hitList.size() == 0) return iris::SceneNodePtr();
-    if (hitList.size() == 1) return hitList.last().hitNode;
-
-    qSort(hitList.begin(), hitList.end(), [](const PickingResult& a, const PickingResult& b) {
-        return a.distanceFromCameraSqrd > b.distanceFromCameraSqrd;
-    });
+    // the segment starts at the camera so the nearest hit along it is also the closest to the camera
+    iris::PickingResult result;
+    if (!ScenePicker::pickMesh(scene->getRootNode(), segStart, segEnd, result, mode, forcePickable)) {
+        return iris::SceneNodePtr();
+    }
 
-    return hitList.last().hitNode;
+    return result.hitNode;
 }
 
 void SceneViewWidget::mouseMoveEvent(QMouseEvent *e)
@@ -1230,7 +1280,17 @@ void SceneViewWidget::doObjectPicking(
 	auto segEnd = screenSpaceToWoldSpace(point, 1.0f);
 
     QList<PickingResult> hitList;
-    doScenePicking(scene->getRootNode(), segStart, segEnd, hitList);
+
+    // only the closest mesh hit can win so there's no need to collect the rest
+    iris::PickingResult meshHit;
+    if (ScenePicker::pickMesh(scene->getRootNode(), segStart, segEnd, meshHit)) {
+        PickingResult pick;
+        pick.hitNode = meshHit.hitNode;
+        pick.hitPoint = meshHit.hitPoint;
+        pick.distanceFromCameraSqrd = (meshHit.hitPoint - editorCam->getGlobalPosition()).lengthSquared();
+        hitList.append(pick);
+    }
+
     if (!skipLights) {
         doLightPicking(segStart, segEnd, hitList);
     }
@@ -1245,12 +1305,13 @@ void SceneViewWidget::doObjectPicking(
         return;
     }
 
-    // sort by distance to camera then return the closest hit node
-    qSort(hitList.begin(), hitList.end(), [](const PickingResult& a, const PickingResult& b) {
-        return a.distanceFromCameraSqrd > b.distanceFromCameraSqrd;
+    // the closest hit node to the camera, a single scan is enough since only the minimum is needed
+    const auto closestHit = *std::min_element(hitList.cbegin(), hitList.cend(),
+                                              [](const PickingResult& a, const PickingResult& b) {
+        return a.distanceFromCameraSqrd < b.distanceFromCameraSqrd;
     });
 
-    auto pickedNode = hitList.last().hitNode;
+    auto pickedNode = closestHit.hitNode;
     iris::SceneNodePtr lastSelectedRoot;
 
     if (selectRootObject) {
@@ -1260,7 +1321,7 @@ void SceneViewWidget::doObjectPicking(
                 lastSelectedRoot = lastSelectedRoot->parent;
         }
 
-        auto pickedRoot = hitList.last().hitNode;
+        auto pickedRoot = closestHit.hitNode;
         while (pickedRoot->isAttached())
             pickedRoot = pickedRoot->parent;
 
@@ -1272,7 +1333,7 @@ void SceneViewWidget::doObjectPicking(
 	if (pickedNode->isPhysicsBody && UiManager::isSimulationRunning) {
 		scene->getPhysicsEnvironment()->createPickingConstraint(iris::PickingHandleType::MouseButton,
 																pickedNode->getGUID(),
-																iris::PhysicsHelper::btVector3FromQVector3D(hitList.last().hitPoint),
+																iris::PhysicsHelper::btVector3FromQVector3D(closestHit.hitPoint),
 																segStart,
 																segEnd);
 	}
@@ -1371,47 +1432,6 @@ void SceneViewWidget::getMousePosAndRay(const QPointF& point, QVector3D &rayPos,
     //rayDir = this->calculateMouseRay(point).normalized();// * 1024;
 }
 
-void SceneViewWidget::doScenePicking(const iris::SceneNodePtr& sceneNode,
-                                     const QVector3D& segStart,
-                                     const QVector3D& segEnd,
-                                     QList<PickingResult>& hitList,
-									 bool forcePickable)
-{
-    if ((sceneNode->getSceneNodeType() == iris::SceneNodeType::Mesh) &&
-         (sceneNode->isPickable() || forcePickable))
-    {
-        auto meshNode = sceneNode.staticCast<iris::MeshNode>();
-        auto mesh = meshNode->getMesh();
-        if (mesh != nullptr) {
-            auto triMesh = meshNode->getMesh()->getTriMesh();
-
-            // transform segment to local space
-            auto invTransform = meshNode->globalTransform.inverted();
-            auto a = invTransform * segStart;
-            auto b = invTransform * segEnd;
-
-            QList<iris::TriangleIntersectionResult> results;
-            if (int resultCount = triMesh->getSegmentIntersections(a, b, results)) {
-                for (auto triResult : results) {
-                    // convert hit to world space
-                    auto hitPoint = meshNode->globalTransform * triResult.hitPoint;
-
-                    PickingResult pick;
-                    pick.hitNode = sceneNode;
-                    pick.hitPoint = hitPoint;
-                    pick.distanceFromCameraSqrd = (hitPoint - editorCam->getGlobalPosition()).lengthSquared();
-
-                    hitList.append(pick);
-                }
-            }
-        }
-    }
-
-    for (auto child : sceneNode->children) {
-        doScenePicking(child, segStart, segEnd, hitList, forcePickable);
-    }
-}
-
 void SceneViewWidget::doMeshPicking(const QSharedPointer<iris::SceneNode>& sceneNode,
                                     const QVector3D& segStart,
                                     const QVector3D& segEnd,
@@ -1660,7 +1680,13 @@ void SceneViewWidget::startPlayingScene()
 void SceneViewWidget::pausePlayingScene()
 {
     playScene = false;
-    // time isnt reset
+    // time isnt reset, the animations can be edited while paused so the tracks are compiled again on resume
+    playback->invalidateAnimation();
+}
+
+void SceneViewWidget::invalidateAnimation()
+{
+    playback->invalidateAnimation();
 }
 
 void SceneViewWidget::stopPlayingScene()
@@ -1672,7 +1698,7 @@ void SceneViewWidget::stopPlayingScene()
 		if (!scene)
 			return;
 
-		scene->updateSceneAnimation(0.0f);
+		playback->updateAnimation(0.0f);
 
 		// quick fix for the odd case when the user switched from the
 		// player to editor while having the vr headset on
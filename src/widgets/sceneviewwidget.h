@@ -29,6 +29,7 @@ For more information see the LICENSE file
 #include "uimanager.h"
 
 #include "core/project.h"
+#include "core/scenepicker.h"
 
 namespace iris
 {
@@ -57,6 +58,7 @@ class QOpenGLShaderProgram;
 class QTimer;
 class RotationGizmo;
 class ScaleGizmo;
+class SceneStreamer;
 class ThumbnailGenerator;
 class OutlinerRenderer;
 class AnimationPath;
@@ -154,6 +156,12 @@ public:
 
     void setScene(iris::ScenePtr scene);
     iris::ScenePtr getScene();
+
+    // Pending meshes and textures of the current scene are loaded a few at a time between frames
+    void setSceneStreamer(const QSharedPointer<SceneStreamer> &streamer);
+    QSharedPointer<SceneStreamer> getSceneStreamer() const;
+    // Loads whatever the streamer still has pending right away
+    void finishStreaming();
     void setSelectedNode(iris::SceneNodePtr sceneNode);
     void clearSelectedNode();
 
@@ -199,6 +207,8 @@ public:
     void startPlayingScene();
     void pausePlayingScene();
     void stopPlayingScene();
+    // Drops the compiled animation tracks after an animation was edited
+    void invalidateAnimation();
 
     iris::ForwardRendererPtr getRenderer() const;
 
@@ -222,7 +232,10 @@ public:
     bool updateRPI(QVector3D pos, QVector3D r);
 
 	// forcePickable - allows picking of non isPickable() objects
-    iris::SceneNodePtr doActiveObjectPicking(const QPointF& point, bool forcePickable = false);
+	// mode - PickingMode::Any is enough when only the presence of a hit matters
+    iris::SceneNodePtr doActiveObjectPicking(const QPointF& point,
+                                             bool forcePickable = false,
+                                             PickingMode mode = PickingMode::Nearest);
     void doObjectPicking(
 		const QPointF& point,
 		iris::SceneNodePtr lastSelectedNode,
@@ -289,15 +302,6 @@ private:
                         const QVector3D& segEnd,
                         QList<PickingResult>& hitList);
 
-    // @TODO: use one picking function and pick by mesh type
-	// @forcePickable - if the scenenode has isPickable() set to false, it will
-	// still be picked
-    void doScenePicking(const iris::SceneNodePtr& sceneNode,
-                        const QVector3D& segStart,
-                        const QVector3D& segEnd,
-                        QList<PickingResult>& hitList,
-						bool forcePickable = false);
-
     void doMeshPicking(const iris::SceneNodePtr& widgetHandles,
                        const QVector3D& segStart,
                        const QVector3D& segEnd,
@@ -337,6 +341,9 @@ private:
     iris::MeshPtr dirLightMesh;
     iris::MeshPtr spotLightMesh;
     iris::MaterialPtr lineMat;
+    iris::MeshPtr placeholderMesh;
+
+    QSharedPointer<SceneStreamer> sceneStreamer;
 
     bool showLightWires;
 	bool showDebugDrawFlags;
@@ -344,6 +351,8 @@ private:
     void initLightAssets();
     iris::MeshPtr createDirLightMesh(float radius = 1.0);
     void addLightShapesToScene();
+    iris::MeshPtr createPlaceholderMesh();
+    void addStreamingPlaceholdersToScene();
 
 	void addViewerHeadsToScene();
 	void addGrabGizmosToScene();
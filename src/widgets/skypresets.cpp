@@ -22,6 +22,7 @@ For more information see the LICENSE file
 
 #include "globals.h"
 #include "core/guidmanager.h"
+#include "core/texturecache.h"
 
 #include <QResource>
 
@@ -155,6 +156,6 @@ void SkyPresets::applySky(QListWidgetItem* item)
 
     auto sky = skies[item->data(Qt::UserRole).toInt()];
 
-    mainWindow->getScene()->setSkyTexture(iris::Texture2D::load(sky, false));
+    mainWindow->getScene()->setSkyTexture(TextureCache::load(sky, false));
     mainWindow->getScene()->setSkyColor(QColor(255, 255, 255));
 }
@@ -0,0 +1,174 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "core/database/foldersubtree.h"
+
+class TestFolderSubtree : public QObject
+{
+    Q_OBJECT
+
+private:
+    QSqlDatabase db;
+
+    void exec(const QString &statement)
+    {
+        QSqlQuery query(db);
+        QVERIFY2(query.exec(statement), qPrintable(statement));
+    }
+
+    void addFolder(const QString &guid, const QString &parent)
+    {
+        exec(QString("INSERT INTO folders (guid, parent) VALUES ('%1', '%2')").arg(guid, parent));
+    }
+
+    void addAsset(const QString &guid, const QString &parent, const QString &name)
+    {
+        exec(QString("INSERT INTO assets (guid, parent, name) VALUES ('%1', '%2', '%3')").arg(guid, parent, name));
+        exec(QString("INSERT INTO asset_payloads (guid) VALUES ('%1')").arg(guid));
+    }
+
+    void addDependency(const QString &depender, const QString &dependee)
+    {
+        exec(QString("INSERT INTO dependencies (depender, dependee, id) VALUES ('%1', '%2', '%1%2')")
+             .arg(depender, dependee));
+    }
+
+    QString parentOf(const QString &asset)
+    {
+        QSqlQuery query(db);
+        query.exec(QString("SELECT parent FROM assets WHERE guid = '%1'").arg(asset));
+        return query.first() ? query.value(0).toString() : QString();
+    }
+
+    int count(const QString &table)
+    {
+        QSqlQuery query(db);
+        query.exec("SELECT COUNT(*) FROM " + table);
+        return query.first() ? query.value(0).toInt() : -1;
+    }
+
+private slots:
+    void init()
+    {
+        db = QSqlDatabase::addDatabase("QSQLITE", "foldersubtree");
+        db.setDatabaseName(":memory:");
+        QVERIFY(db.open());
+
+        // Only the columns FolderSubtree touches
+        exec("CREATE TABLE folders (guid VARCHAR(32) PRIMARY KEY, parent VARCHAR(32))");
+        exec("CREATE TABLE assets (guid VARCHAR(32) PRIMARY KEY, parent VARCHAR(32), name VARCHAR(128))");
+        exec("CREATE TABLE asset_payloads (guid VARCHAR(32) PRIMARY KEY, asset BLOB)");
+        exec("CREATE TABLE dependencies (depender VARCHAR(32), dependee VARCHAR(32), id VARCHAR(32) PRIMARY KEY)");
+
+        // root
+        //   textures       <- deleted
+        //     nested
+        //   materials
+        addFolder("textures", "root");
+        addFolder("nested", "textures");
+        addFolder("materials", "root");
+    }
+
+    void cleanup()
+    {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("foldersubtree");
+    }
+
+    void removesUnusedAssets()
+    {
+        addAsset("brick", "textures", "brick.png");
+        addAsset("stone", "nested", "stone.png");
+        addAsset("brickMaterial", "textures", "brick.material");
+        addDependency("brickMaterial", "brick");
+
+        const auto deletion = FolderSubtree::remove(db, "textures");
+
+        QVERIFY(deletion.deleted);
+        QVERIFY(deletion.keptAssets.isEmpty());
+        QCOMPARE(deletion.removedAssets.size(), 3);
+        QCOMPARE(deletion.files.size(), 3);
+        QCOMPARE(count("assets"), 0);
+        QCOMPARE(count("asset_payloads"), 0);
+        QCOMPARE(count("dependencies"), 0);
+        QCOMPARE(count("folders"), 1);
+    }
+
+    void keepsCanonicalAssetUsedElsewhere()
+    {
+        // A later import of the same image was deduplicated onto brick, so a material in another folder uses it
+        addAsset("brick", "nested", "brick.png");
+        addAsset("stone", "textures", "stone.png");
+        addAsset("wallMaterial", "materials", "wall.material");
+        addDependency("wallMaterial", "brick");
+
+        const auto deletion = FolderSubtree::remove(db, "textures");
+
+        QVERIFY(deletion.deleted);
+        QCOMPARE(deletion.keptAssets, QStringList { "brick" });
+        QCOMPARE(deletion.removedAssets, QStringList { "stone" });
+        QCOMPARE(deletion.files, QStringList { "stone.png" });
+
+        // The row, its payload and the dependency survive, moved out of the deleted folder
+        QCOMPARE(parentOf("brick"), QString("root"));
+        QCOMPARE(count("asset_payloads"), 2);
+        QCOMPARE(count("dependencies"), 1);
+        QCOMPARE(count("folders"), 1);
+    }
+
+    void keepsWhatKeptAssetsDependOn()
+    {
+        // The material outside uses a material inside, which in turn uses a texture inside
+        addAsset("brick", "nested", "brick.png");
+        addAsset("brickMaterial", "textures", "brick.material");
+        addAsset("wallObject", "materials", "wall.obj");
+        addDependency("brickMaterial", "brick");
+        addDependency("wallObject", "brickMaterial");
+
+        const auto deletion = FolderSubtree::remove(db, "textures");
+
+        QVERIFY(deletion.deleted);
+        QCOMPARE(deletion.keptAssets.size(), 2);
+        QVERIFY(deletion.removedAssets.isEmpty());
+        QVERIFY(deletion.files.isEmpty());
+        QCOMPARE(parentOf("brick"), QString("root"));
+        QCOMPARE(parentOf("brickMaterial"), QString("root"));
+        QCOMPARE(count("dependencies"), 2);
+    }
+
+    void sharedDependeeOutsideKeepsItsFile()
+    {
+        // A texture in another folder used both by a deleted material and by one that stays
+        addAsset("brick", "materials", "brick.png");
+        addAsset("brickMaterial", "textures", "brick.material");
+        addAsset("wallMaterial", "materials", "wall.material");
+        addAsset("onlyHere", "root", "only.png");
+        addDependency("brickMaterial", "brick");
+        addDependency("wallMaterial", "brick");
+        addDependency("brickMaterial", "onlyHere");
+
+        const auto deletion = FolderSubtree::remove(db, "textures");
+
+        QVERIFY(deletion.deleted);
+        QVERIFY(deletion.files.contains("brick.material"));
+        QVERIFY(deletion.files.contains("only.png"));
+        QVERIFY(!deletion.files.contains("brick.png"));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestFolderSubtree)
+
+#include "tst_foldersubtree.moc"
@@ -0,0 +1,130 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "core/guidmanager.h"
+
+namespace
+{
+    // What imports did before remapGuids, one pass over the text per guid
+    QString replaceEachGuid(QString text, const QMap<QString, QString> &guidMap)
+    {
+        for (auto it = guidMap.constBegin(); it != guidMap.constEnd(); ++it) text.replace(it.key(), it.value());
+        return text;
+    }
+
+    // An imported project: 5000 nodes, each with its own guid, using 1000 assets between them
+    QString largeScene(QMap<QString, QString> &guidMap)
+    {
+        QStringList assets;
+        for (int i = 0; i < 1000; i++) {
+            assets.append(GUIDManager::generateGUID());
+            guidMap.insert(assets.last(), GUIDManager::generateGUID());
+        }
+
+        QJsonArray children;
+        for (int i = 0; i < 5000; i++) {
+            const QString guid = GUIDManager::generateGUID();
+            guidMap.insert(guid, GUIDManager::generateGUID());
+
+            QJsonObject material;
+            material["guid"] = assets[(i * 7) % assets.size()];
+            material["diffuseTexture"] = assets[(i * 13 + 1) % assets.size()];
+
+            QJsonObject node;
+            node["name"] = QString("node %1").arg(i);
+            node["guid"] = guid;
+            node["mesh"] = assets[i % assets.size()];
+            node["material"] = material;
+            children.append(node);
+        }
+
+        QJsonObject scene;
+        scene["children"] = children;
+        return QJsonDocument(scene).toJson(QJsonDocument::Compact);
+    }
+}
+
+class TestGuidManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void remapsKnownGuids()
+    {
+        const QString known = "0a1b2c3d-0000-4000-8000-00000000000a";
+        const QString unknown = "0a1b2c3d-0000-4000-8000-00000000000b";
+        const QString replacement = "ffffffff-0000-4000-8000-00000000000c";
+
+        const QString text = QString("{\"a\":\"%1\",\"b\":\"%2\",\"c\":\"%1\"}").arg(known, unknown);
+        QCOMPARE(GUIDManager::remapGuids(text, { { known, replacement } }),
+                 QString("{\"a\":\"%1\",\"b\":\"%2\",\"c\":\"%1\"}").arg(replacement, unknown));
+    }
+
+    void leavesOtherTextAlone()
+    {
+        const QMap<QString, QString> guidMap { { "0a1b2c3d-0000-4000-8000-00000000000a",
+                                                 "ffffffff-0000-4000-8000-00000000000c" } };
+
+        // too short, a dash out of place and a guid cut off by the end of the text
+        for (const QString text : { QString("0a1b2c3d-0000-4000-8000-00000000000"),
+                                    QString("0a1b2c3d00000-4000-8000-00000000000a"),
+                                    QString("xx0a1b2c3d-0000-4000-8000-0000000") }) {
+            QCOMPARE(GUIDManager::remapGuids(text, guidMap), text);
+        }
+    }
+
+    void matchesReplacingEachGuid()
+    {
+        QMap<QString, QString> guidMap;
+        const QString scene = largeScene(guidMap);
+
+        QCOMPARE(GUIDManager::remapGuids(scene, guidMap), replaceEachGuid(scene, guidMap));
+    }
+
+    void binaryJsonUntouchedWithoutMatches()
+    {
+        QMap<QString, QString> guidMap;
+        const QByteArray blob = QJsonDocument::fromJson(largeScene(guidMap).toUtf8()).toBinaryData();
+
+        QMap<QString, QString> unrelated { { GUIDManager::generateGUID(), GUIDManager::generateGUID() } };
+        QCOMPARE(GUIDManager::remapGuidsInBinaryJson(blob, unrelated), blob);
+    }
+
+    void benchmarkSinglePass()
+    {
+        QMap<QString, QString> guidMap;
+        const QString scene = largeScene(guidMap);
+
+        QBENCHMARK {
+            GUIDManager::remapGuids(scene, guidMap);
+        }
+    }
+
+    void benchmarkReplaceEachGuid()
+    {
+        QMap<QString, QString> guidMap;
+        const QString scene = largeScene(guidMap);
+
+        QBENCHMARK {
+            replaceEachGuid(scene, guidMap);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestGuidManager)
+
+#include "tst_guidmanager.moc"
@@ -0,0 +1,452 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "io/sceneformat.h"
+
+namespace
+{
+    // Tags as laid out in sceneformat.cpp, used to build malformed blobs by hand
+    const char tagNull = 0;
+    const char tagArray = 7;
+    const char tagObject = 8;
+
+    QByteArray header()
+    {
+        QByteArray blob("JSCN");
+        blob.append(char(SceneFormat::formatVersion & 0xff));
+        blob.append(char(SceneFormat::formatVersion >> 8));
+        return blob;
+    }
+
+    quint64 bitsOf(double value)
+    {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    QJsonObject key(double time, double value, const QString &handleMode = "joined")
+    {
+        QJsonObject key;
+        key["time"] = time;
+        key["value"] = value;
+        key["leftSlope"] = 0.25;
+        key["rightSlope"] = -0.25;
+        key["leftTangentType"] = "free";
+        key["rightTangentType"] = "linear";
+        key["handleMode"] = handleMode;
+        return key;
+    }
+
+    QJsonObject vector3(double x, double y, double z)
+    {
+        QJsonObject vector;
+        vector["x"] = x;
+        vector["y"] = y;
+        vector["z"] = z;
+        return vector;
+    }
+
+    QJsonObject color(int r, int g, int b, int a)
+    {
+        QJsonObject color;
+        color["r"] = r;
+        color["g"] = g;
+        color["b"] = b;
+        color["a"] = a;
+        return color;
+    }
+
+    // Roughly what SceneWriter produces, with every packed form and its fallbacks
+    QJsonObject sampleScene()
+    {
+        QJsonObject scene;
+        scene["version"] = "0.5a";
+        scene["ambientColor"] = color(190, 190, 190, 255);
+        scene["fogColor"] = color(256, 0, 0, 255);            // out of range, stays an object
+        scene["gravity"] = vector3(0, -9.8, 0);                 // not float exact, stays an object
+        scene["nothing"] = QJsonValue();
+        scene["visible"] = true;
+        scene["hidden"] = false;
+        scene["name"] = QString::fromUtf8("Sc\xc3\xa8ne \xe2\x9c\x93");
+
+        QJsonObject scale;
+        scale["x"] = 1.5;
+        scale["y"] = 2.25;
+        scene["uvScale"] = scale;
+
+        QJsonObject quat;
+        quat["x"] = 0;
+        quat["y"] = 0.5;
+        quat["z"] = -0.5;
+        quat["w"] = 1;
+        scene["rotation"] = quat;
+
+        QJsonArray keys;
+        for (int i = 0; i < 8; i++) keys.append(key(i * 0.5, i * 2.0));
+        QJsonArray unevenKeys;
+        unevenKeys.append(key(0.1, 1.0));                       // not float exact, keys are written one by one
+        unevenKeys.append(key(1.0, 2.0, "broken"));
+
+        QJsonObject animation;
+        animation["name"] = "Take 1";
+        animation["length"] = 3.5;
+        animation["keys"] = keys;
+        animation["unevenKeys"] = unevenKeys;
+
+        QJsonArray children;
+        QJsonObject node;
+        for (int depth = 0; depth < 24; depth++) {
+            QJsonObject parent;
+            parent["name"] = QString("node %1").arg(depth);
+            parent["position"] = vector3(depth, -depth, depth * 0.5);
+            parent["children"] = node.isEmpty() ? QJsonArray() : QJsonArray { node };
+            parent["animation"] = animation;
+            node = parent;
+        }
+        children.append(node);
+        children.append(QJsonObject());
+        children.append(QJsonArray());
+        children.append(QJsonArray { 1, "two", QJsonArray { 3.5, QJsonValue() }, false });
+
+        scene["children"] = children;
+        return scene;
+    }
+
+    // A flat scene the size of a large project, every node animated, for the benchmarks
+    QJsonObject largeScene()
+    {
+        QJsonArray keys;
+        for (int i = 0; i < 60; i++) keys.append(key(i * 0.25, std::sin(i * 0.25f)));
+
+        QJsonObject animation;
+        animation["name"] = "Take 1";
+        animation["length"] = 15.0;
+        animation["keys"] = keys;
+
+        QJsonArray children;
+        for (int i = 0; i < 2000; i++) {
+            QJsonObject node;
+            node["name"] = QString("node %1").arg(i);
+            node["guid"] = QString("%1").arg(i, 32, 16, QChar('0'));
+            node["position"] = vector3(i, 0.5f * i, -0.25f * i);
+            node["rotation"] = vector3(0, 90, 0);
+            node["scale"] = vector3(1, 1, 1);
+            node["ambientColor"] = color(i % 256, 128, 64, 255);
+            node["animation"] = animation;
+            children.append(node);
+        }
+
+        QJsonObject scene;
+        scene["version"] = "0.5a";
+        scene["children"] = children;
+        return scene;
+    }
+
+    enum class Format
+    {
+        Scene,
+        BinaryJson,
+        Json
+    };
+
+    QByteArray encodeAs(Format format, const QJsonObject &obj)
+    {
+        switch (format) {
+        case Format::Scene:         return SceneFormat::encode(obj);
+        case Format::BinaryJson:    return QJsonDocument(obj).toBinaryData();
+        default:                    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+        }
+    }
+
+    QJsonObject decodeAs(Format format, const QByteArray &blob)
+    {
+        QJsonObject obj;
+        switch (format) {
+        case Format::Scene:         SceneFormat::decode(blob, obj); return obj;
+        case Format::BinaryJson:    return QJsonDocument::fromBinaryData(blob).object();
+        default:                    return QJsonDocument::fromJson(blob).object();
+        }
+    }
+}
+
+Q_DECLARE_METATYPE(Format)
+
+class TestSceneFormat : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QJsonObject roundTrip(const QJsonObject &obj)
+    {
+        const QByteArray blob = SceneFormat::encode(obj);
+        if (!SceneFormat::isSceneFormat(blob)) return QJsonObject();
+
+        QJsonObject decoded;
+        if (!SceneFormat::decode(blob, decoded)) return QJsonObject();
+        return decoded;
+    }
+
+private slots:
+    void nestedObjectsAndArrays()
+    {
+        const QJsonObject scene = sampleScene();
+        QCOMPARE(roundTrip(scene), scene);
+        QCOMPARE(roundTrip(QJsonObject()), QJsonObject());
+    }
+
+    void vectorsAndColors()
+    {
+        QJsonObject obj;
+        obj["position"] = vector3(1.5, -2.25, 1e-3f);
+        obj["color"] = color(0, 128, 255, 64);
+        obj["mixed"] = QJsonObject { { "x", 1 }, { "y", "up" } };
+        obj["partial"] = QJsonObject { { "r", 1 }, { "g", 2 }, { "b", 3 }, { "alpha", 4 } };
+        obj["fraction"] = QJsonObject { { "r", 0.5 }, { "g", 0 }, { "b", 0 }, { "a", 1 } };
+
+        QCOMPARE(roundTrip(obj), obj);
+
+        // Packed forms are what keeps scenes small, a vector is a tag and three floats
+        QJsonObject single;
+        single["p"] = vector3(1, 2, 3);
+        const QByteArray packed = SceneFormat::encode(single);
+        single["p"] = vector3(1, 2, 0.1);
+        QVERIFY(packed.size() < SceneFormat::encode(single).size());
+    }
+
+    void keyArrays()
+    {
+        QJsonArray keys;
+        for (int i = 0; i < 100; i++) keys.append(key(i / 4.0, i * 3.0, i % 2 ? "joined" : "broken"));
+
+        QJsonObject obj;
+        obj["keys"] = keys;
+
+        QJsonObject withExtra = key(0, 1);
+        withExtra["extra"] = 1;
+        obj["extraField"] = QJsonArray { withExtra };
+
+        QJsonObject wrongType = key(0, 1);
+        wrongType["handleMode"] = 2;
+        obj["wrongType"] = QJsonArray { key(0, 1), wrongType };
+
+        QCOMPARE(roundTrip(obj), obj);
+    }
+
+    void numbers_data()
+    {
+        QTest::addColumn<double>("value");
+
+        QTest::newRow("zero") << 0.0;
+        QTest::newRow("negative zero") << -0.0;
+        QTest::newRow("small integer") << 42.0;
+        QTest::newRow("negative integer") << -1234567.0;
+        QTest::newRow("largest exact integer") << 9007199254740991.0;
+        QTest::newRow("smallest exact integer") << -9007199254740991.0;
+        QTest::newRow("2^53") << 9007199254740992.0;
+        QTest::newRow("2^53 + 2") << 9007199254740994.0;
+        QTest::newRow("int64 max") << double(std::numeric_limits<qint64>::max());
+        QTest::newRow("int64 min") << double(std::numeric_limits<qint64>::min());
+        QTest::newRow("uint32 max") << double(std::numeric_limits<quint32>::max());
+        QTest::newRow("half") << 0.5;
+        QTest::newRow("tenth") << 0.1;
+        QTest::newRow("negative tenth") << -0.1;
+        QTest::newRow("pi") << 3.141592653589793;
+        QTest::newRow("float pi") << double(3.14159274f);
+        QTest::newRow("tiny") << 1e-300;
+        QTest::newRow("huge") << 1e300;
+        QTest::newRow("double max") << std::numeric_limits<double>::max();
+        QTest::newRow("denormal") << std::numeric_limits<double>::denorm_min();
+        QTest::newRow("float denormal") << double(std::numeric_limits<float>::denorm_min());
+    }
+
+    void numbers()
+    {
+        QFETCH(double, value);
+
+        QJsonObject obj;
+        obj["value"] = value;
+        obj["array"] = QJsonArray { value, value };
+        obj["vector"] = vector3(value, value, value);
+
+        const QJsonObject decoded = roundTrip(obj);
+
+        // Bit for bit, so -0 keeps its sign and nothing is rounded through a float
+        QCOMPARE(bitsOf(decoded["value"].toDouble()), bitsOf(value));
+        QCOMPARE(bitsOf(decoded["array"].toArray().at(1).toDouble()), bitsOf(value));
+        QCOMPARE(bitsOf(decoded["vector"].toObject()["z"].toDouble()), bitsOf(value));
+    }
+
+    void binaryJson()
+    {
+        const QJsonObject scene = sampleScene();
+
+        // Scenes saved by older versions are Qt binary JSON
+        QJsonObject decoded;
+        QVERIFY(SceneFormat::decode(QJsonDocument(scene).toBinaryData(), decoded));
+        QCOMPARE(decoded, scene);
+
+        const QByteArray converted = SceneFormat::toBinaryJson(SceneFormat::encode(scene));
+        QCOMPARE(QJsonDocument::fromBinaryData(converted).object(), scene);
+    }
+
+    void truncatedBlobs()
+    {
+        const QByteArray blob = SceneFormat::encode(sampleScene());
+
+        for (int size = 0; size < blob.size(); size++) {
+            QJsonObject decoded;
+            QVERIFY2(!SceneFormat::decode(blob.left(size), decoded), qPrintable(QString("size %1").arg(size)));
+        }
+    }
+
+    void trailingData()
+    {
+        QJsonObject decoded;
+        QVERIFY(!SceneFormat::decode(SceneFormat::encode(sampleScene()) + char(tagNull), decoded));
+    }
+
+    void corruptBlobs_data()
+    {
+        QTest::addColumn<QByteArray>("blob");
+
+        QByteArray newerVersion("JSCN");
+        newerVersion.append(char((SceneFormat::formatVersion + 1) & 0xff));
+        newerVersion.append(char((SceneFormat::formatVersion + 1) >> 8));
+        newerVersion.append(char(0));
+        newerVersion.append(tagObject);
+        newerVersion.append(char(0));
+        QTest::newRow("newer version") << newerVersion;
+
+        QTest::newRow("root isn't an object") << header() + QByteArray(1, 0) + QByteArray(1, tagArray) + QByteArray(1, 0);
+        QTest::newRow("unknown tag") << header() + QByteArray(1, 0) + QByteArray(1, char(0x7f));
+        QTest::newRow("endless varint") << header() + QByteArray(12, char(0x80));
+
+        // An object with a key that isn't in the (empty) string table
+        QByteArray badString = header();
+        badString.append(char(0));
+        badString.append(tagObject);
+        badString.append(char(1));
+        badString.append(char(0));
+        badString.append(tagNull);
+        QTest::newRow("string index out of range") << badString;
+
+        // Counts are checked against what's left before anything is allocated
+        QByteArray hugeCount = header();
+        hugeCount.append(char(0));
+        hugeCount.append(tagArray);
+        hugeCount.append(QByteArray::fromHex("ffffffff0f"));
+        QTest::newRow("huge count") << hugeCount;
+
+        QByteArray hugeStringTable = header();
+        hugeStringTable.append(QByteArray::fromHex("ffffffff0f"));
+        QTest::newRow("huge string table") << hugeStringTable;
+
+        // { "a": [[[[...]]]] } nested deeper than the decoder allows
+        QByteArray deep = header();
+        deep.append(char(1));
+        deep.append(char(1));
+        deep.append('a');
+        deep.append(tagObject);
+        deep.append(char(1));
+        deep.append(char(0));
+        for (int i = 0; i < 1000; i++) {
+            deep.append(tagArray);
+            deep.append(char(1));
+        }
+        deep.append(tagNull);
+        QTest::newRow("nested too deep") << deep;
+    }
+
+    void corruptBlobs()
+    {
+        QFETCH(QByteArray, blob);
+
+        QJsonObject decoded;
+        QVERIFY(!SceneFormat::decode(blob, decoded));
+    }
+
+    void damagedBytes()
+    {
+        // A damaged byte may still decode to something, it must never read out of bounds or hang
+        const QByteArray blob = SceneFormat::encode(sampleScene());
+
+        for (int i = 0; i < blob.size(); i++) {
+            for (char value : { char(0x00), char(0x7f), char(0x80), char(0xff) }) {
+                QByteArray damaged = blob;
+                damaged[i] = value;
+
+                QJsonObject decoded;
+                SceneFormat::decode(damaged, decoded);
+            }
+        }
+    }
+
+    void largeSceneSizes()
+    {
+        const QJsonObject scene = largeScene();
+        const int sceneSize = encodeAs(Format::Scene, scene).size();
+        const int binaryJsonSize = encodeAs(Format::BinaryJson, scene).size();
+        const int jsonSize = encodeAs(Format::Json, scene).size();
+
+        qInfo("SceneFormat %d bytes, binary JSON %d bytes, compact JSON %d bytes",
+              sceneSize, binaryJsonSize, jsonSize);
+        QVERIFY(sceneSize < binaryJsonSize);
+        QVERIFY(sceneSize < jsonSize);
+        QCOMPARE(decodeAs(Format::Scene, encodeAs(Format::Scene, scene)), scene);
+    }
+
+    void save_data()
+    {
+        QTest::addColumn<Format>("format");
+        QTest::newRow("SceneFormat") << Format::Scene;
+        QTest::newRow("binary JSON") << Format::BinaryJson;
+        QTest::newRow("JSON") << Format::Json;
+    }
+
+    void save()
+    {
+        QFETCH(Format, format);
+        const QJsonObject scene = largeScene();
+
+        QBENCHMARK {
+            encodeAs(format, scene);
+        }
+    }
+
+    void load_data()
+    {
+        save_data();
+    }
+
+    void load()
+    {
+        QFETCH(Format, format);
+        const QByteArray blob = encodeAs(format, largeScene());
+
+        QBENCHMARK {
+            decodeAs(format, blob);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSceneFormat)
+
+#include "tst_sceneformat.moc"
@@ -0,0 +1,160 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+
+#include <QtTest>
+#include <QScopedPointer>
+
+#include <cmath>
+#include <limits>
+
+#include "core/scenepicker.h"
+#include "irisgl/src/geometry/trimesh.h"
+
+namespace
+{
+    // A bumpy terrain of columns x rows quads, two triangles each
+    iris::TriMesh *terrain(int columns, int rows)
+    {
+        auto height = [](int x, int z) {
+            return std::sin(x * 0.1f) * std::cos(z * 0.1f);
+        };
+
+        auto triMesh = new iris::TriMesh();
+        for (int z = 0; z < rows; z++) {
+            for (int x = 0; x < columns; x++) {
+                const QVector3D a(x, height(x, z), z);
+                const QVector3D b(x + 1, height(x + 1, z), z);
+                const QVector3D c(x + 1, height(x + 1, z + 1), z + 1);
+                const QVector3D d(x, height(x, z + 1), z + 1);
+                triMesh->addTriangle(a, b, c);
+                triMesh->addTriangle(a, c, d);
+            }
+        }
+
+        return triMesh;
+    }
+
+    // Straight down through the terrain, kept off the quads' edges and diagonals
+    void downward(int i, int columns, int rows, QVector3D &segStart, QVector3D &segEnd)
+    {
+        const float x = (i * 37) % columns + 0.31f;
+        const float z = (i * 61) % rows + 0.77f;
+        segStart = QVector3D(x, 10, z);
+        segEnd = QVector3D(x, -10, z);
+    }
+}
+
+class TestScenePicker : public QObject
+{
+    Q_OBJECT
+
+private:
+    // 1000 x 500 quads, a million triangles
+    static const int largeColumns = 1000;
+    static const int largeRows = 500;
+
+    QScopedPointer<iris::TriMesh> largeMesh;
+
+private slots:
+    void initTestCase()
+    {
+        largeMesh.reset(terrain(largeColumns, largeRows));
+        QCOMPARE(largeMesh->triangles.size(), largeColumns * largeRows * 2);
+    }
+
+    void matchesTriMesh()
+    {
+        QScopedPointer<iris::TriMesh> triMesh(terrain(100, 100));
+        const TriangleBVH bvh(triMesh.data());
+        QCOMPARE(bvh.triangleCount(), triMesh->triangles.size());
+
+        for (int i = 0; i < 500; i++) {
+            QVector3D segStart, segEnd;
+            downward(i, 100, 100, segStart, segEnd);
+
+            QList<iris::TriangleIntersectionResult> expected;
+            triMesh->getSegmentIntersections(segStart, segEnd, expected);
+
+            QList<TriangleHit> hits;
+            QCOMPARE(bvh.getSegmentIntersections(segStart, segEnd, hits), expected.size());
+
+            TriangleHit nearest;
+            QCOMPARE(bvh.getNearestIntersection(segStart, segEnd, nearest), !expected.isEmpty());
+            if (expected.isEmpty()) continue;
+
+            float closest = std::numeric_limits<float>::max();
+            for (const auto &result : expected) closest = qMin(closest, (result.hitPoint - segStart).length());
+            QVERIFY(qAbs((nearest.hitPoint - segStart).length() - closest) < 1e-3f);
+        }
+    }
+
+    void missesOutsideBounds()
+    {
+        const TriangleBVH bvh(largeMesh.data());
+
+        TriangleHit hit;
+        QVERIFY(!bvh.getNearestIntersection(QVector3D(-5, 10, -5), QVector3D(-5, -10, -5), hit));
+        QVERIFY(!bvh.getAnyIntersection(QVector3D(0, 10, 0), QVector3D(largeColumns, 10, largeRows), hit));
+    }
+
+    void benchmarkBuild()
+    {
+        QBENCHMARK {
+            TriangleBVH bvh(largeMesh.data());
+        }
+    }
+
+    // What picking did before, every triangle tested on every query
+    void benchmarkTriMesh()
+    {
+        int i = 0;
+        QBENCHMARK {
+            QVector3D segStart, segEnd;
+            downward(i++, largeColumns, largeRows, segStart, segEnd);
+
+            QList<iris::TriangleIntersectionResult> results;
+            largeMesh->getSegmentIntersections(segStart, segEnd, results);
+        }
+    }
+
+    void benchmarkAllHits()
+    {
+        const TriangleBVH bvh(largeMesh.data());
+
+        int i = 0;
+        QBENCHMARK {
+            QVector3D segStart, segEnd;
+            downward(i++, largeColumns, largeRows, segStart, segEnd);
+
+            QList<TriangleHit> hits;
+            bvh.getSegmentIntersections(segStart, segEnd, hits);
+        }
+    }
+
+    void benchmarkNearestHit()
+    {
+        const TriangleBVH bvh(largeMesh.data());
+
+        int i = 0;
+        QBENCHMARK {
+            QVector3D segStart, segEnd;
+            downward(i++, largeColumns, largeRows, segStart, segEnd);
+
+            TriangleHit hit;
+            bvh.getNearestIntersection(segStart, segEnd, hit);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestScenePicker)
+
+#include "tst_scenepicker.moc"
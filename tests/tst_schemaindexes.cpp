@@ -0,0 +1,209 @@
+/**************************************************************************
+This file is part of JahshakaVR, VR Authoring Toolkit
+http://www.jahshaka.com
+Copyright (c) 2016  GPLv3 Jahshaka LLC <coders@jahshaka.com>
+
+This is free software: you may copy, redistribute
+and/or modify it under the terms of the GPLv3 License
+
+For more information see the LICENSE file
+*************************************************************************/
+
+
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "core/database/schemaindexes.h"
+
+Q_DECLARE_METATYPE(QVariantList)
+
+class TestSchemaIndexes : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int assetCount = 20000;
+    static const int folderCount = 200;
+
+    static bool exec(QSqlDatabase &db, const QString &statement, const QVariantList &values = QVariantList())
+    {
+        QSqlQuery query(db);
+        query.prepare(statement);
+        for (const auto &value : values) query.addBindValue(value);
+        return query.exec();
+    }
+
+    // Only the columns the indexes and the queries below touch
+    static void populate(QSqlDatabase &db)
+    {
+        QVERIFY(exec(db, "CREATE TABLE assets (guid VARCHAR(32) PRIMARY KEY, type INTEGER, name VARCHAR(128), "
+                         "project_guid VARCHAR(32), hash VARCHAR(16), parent VARCHAR(32), view_filter INTEGER)"));
+        QVERIFY(exec(db, "CREATE TABLE dependencies (depender_type INTEGER, dependee_type INTEGER, "
+                         "project_guid VARCHAR(32), depender VARCHAR(32), dependee VARCHAR(32), id VARCHAR(32) PRIMARY KEY)"));
+        QVERIFY(exec(db, "CREATE TABLE folders (guid VARCHAR(32) PRIMARY KEY, parent VARCHAR(32), "
+                         "project_guid VARCHAR(32), name VARCHAR(128))"));
+
+        QVERIFY(db.transaction());
+
+        QSqlQuery asset(db);
+        asset.prepare("INSERT INTO assets VALUES (?, ?, ?, ?, ?, ?, ?)");
+        QSqlQuery dependency(db);
+        dependency.prepare("INSERT INTO dependencies VALUES (1, 1, ?, ?, ?, ?)");
+
+        for (int i = 0; i < assetCount; i++) {
+            const QString project = QString("project%1").arg(i % 2);
+
+            asset.addBindValue(QString("asset%1").arg(i));
+            asset.addBindValue(i % 8);
+            asset.addBindValue(QString("name%1").arg(i));
+            asset.addBindValue(project);
+            asset.addBindValue(QString("hash%1").arg(i));
+            asset.addBindValue(QString("folder%1").arg(i % folderCount));
+            asset.addBindValue(i % 3);
+            QVERIFY(asset.exec());
+
+            dependency.addBindValue(project);
+            dependency.addBindValue(QString("asset%1").arg(i));
+            dependency.addBindValue(QString("asset%1").arg((i * 7 + 1) % assetCount));
+            dependency.addBindValue(QString("dependency%1").arg(i));
+            QVERIFY(dependency.exec());
+        }
+
+        QSqlQuery folder(db);
+        folder.prepare("INSERT INTO folders VALUES (?, ?, 'project0', ?)");
+        for (int i = 0; i < folderCount; i++) {
+            folder.addBindValue(QString("folder%1").arg(i));
+            folder.addBindValue(QString("folder%1").arg(i / 10));
+            folder.addBindValue(QString("name%1").arg(i));
+            QVERIFY(folder.exec());
+        }
+
+        QVERIFY(db.commit());
+    }
+
+    QSqlDatabase plain;
+    QSqlDatabase indexed;
+
+private slots:
+    void initTestCase()
+    {
+        plain = QSqlDatabase::addDatabase("QSQLITE", "plain");
+        plain.setDatabaseName(":memory:");
+        QVERIFY(plain.open());
+        populate(plain);
+
+        indexed = QSqlDatabase::addDatabase("QSQLITE", "indexed");
+        indexed.setDatabaseName(":memory:");
+        QVERIFY(indexed.open());
+        populate(indexed);
+
+        for (const QString &statement : SchemaIndexes::statements) QVERIFY2(exec(indexed, statement), qPrintable(statement));
+        QVERIFY(exec(indexed, "ANALYZE"));
+    }
+
+    void cleanupTestCase()
+    {
+        plain.close();
+        indexed.close();
+        plain = QSqlDatabase();
+        indexed = QSqlDatabase();
+        QSqlDatabase::removeDatabase("plain");
+        QSqlDatabase::removeDatabase("indexed");
+    }
+
+    void indexNames()
+    {
+        for (const QString &statement : SchemaIndexes::statements) {
+            QSqlQuery query(indexed);
+            query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name = ?");
+            query.addBindValue(SchemaIndexes::nameOf(statement));
+            QVERIFY(query.exec() && query.first());
+            QCOMPARE(query.value(0).toInt(), 1);
+        }
+    }
+
+    // The hot lookups of Database, with values that match a handful of rows
+    void queries_data()
+    {
+        QTest::addColumn<QString>("statement");
+        QTest::addColumn<QVariantList>("values");
+
+        QTest::newRow("folder contents")
+            << "SELECT guid, name FROM assets WHERE parent = ? AND project_guid = ? ORDER BY name"
+            << QVariantList { "folder17", "project1" };
+        QTest::newRow("assets by type")
+            << "SELECT guid, type, name FROM assets WHERE type = ? AND project_guid = ?"
+            << QVariantList { 3, "project1" };
+        QTest::newRow("view filter")
+            << "SELECT guid, type, name FROM assets WHERE view_filter = ?"
+            << QVariantList { 2 };
+        QTest::newRow("hash lookup")
+            << "SELECT guid FROM assets WHERE project_guid = ? AND hash = ?"
+            << QVariantList { "project1", "hash12345" };
+        QTest::newRow("dependees")
+            << "SELECT dependee FROM dependencies WHERE depender_type = ? AND depender = ?"
+            << QVariantList { 1, "asset12345" };
+        QTest::newRow("dependers")
+            << "SELECT 1 FROM dependencies WHERE dependee = ?"
+            << QVariantList { "asset4321" };
+        QTest::newRow("subfolders")
+            << "SELECT guid, parent, name FROM folders WHERE parent = ? AND project_guid = ?"
+            << QVariantList { "folder3", "project0" };
+    }
+
+    void queryPlans_data()
+    {
+        queries_data();
+    }
+
+    void queryPlans()
+    {
+        QFETCH(QString, statement);
+        QFETCH(QVariantList, values);
+
+        QSqlQuery query(indexed);
+        query.prepare("EXPLAIN QUERY PLAN " + statement);
+        for (const auto &value : values) query.addBindValue(value);
+        QVERIFY(query.exec());
+
+        // the detail column reads "SEARCH <table> USING [COVERING] INDEX ..." once an index is picked up
+        QString plan;
+        while (query.next()) plan += query.value(3).toString() + "\n";
+        QVERIFY2(plan.contains("INDEX"), qPrintable(plan));
+    }
+
+    void queriesWithoutIndexes_data()
+    {
+        queries_data();
+    }
+
+    void queriesWithoutIndexes()
+    {
+        QFETCH(QString, statement);
+        QFETCH(QVariantList, values);
+
+        QBENCHMARK {
+            QVERIFY(exec(plain, statement, values));
+        }
+    }
+
+    void queriesWithIndexes_data()
+    {
+        queries_data();
+    }
+
+    void queriesWithIndexes()
+    {
+        QFETCH(QString, statement);
+        QFETCH(QVariantList, values);
+
+        QBENCHMARK {
+            QVERIFY(exec(indexed, statement, values));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestSchemaIndexes)
+
+#include "tst_schemaindexes.moc"